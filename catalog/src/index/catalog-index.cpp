@@ -0,0 +1,496 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/catalog-index.hpp"
+
+#include <boost/thread/locks.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace atmos {
+namespace index {
+
+CatalogIndex::CatalogIndex(const std::vector<std::string>& nameFields)
+  : m_nameFields(nameFields)
+  , m_dictionaries(nameFields.size())
+  , m_columns(nameFields.size())
+  , m_nErased(0)
+  , m_lastId(0)
+{
+}
+
+bool
+CatalogIndex::insert(const std::string& name,
+                     const std::vector<std::string>& fieldValues,
+                     bool hasMetadata)
+{
+  if (fieldValues.size() != m_nameFields.size()) {
+    return false;
+  }
+
+  boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+  if (m_slotByName.find(name) != m_slotByName.end() ||
+      m_lastId >= std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  size_t slot = m_ids.size();
+  uint32_t id = static_cast<uint32_t>(++m_lastId);
+  std::vector<uint32_t> codes(m_nameFields.size());
+  for (size_t i = 0; i < m_nameFields.size(); ++i) {
+    codes[i] = acquireCode(m_dictionaries[i], fieldValues[i]);
+    m_dictionaries[i].postings[codes[i]].add(id);
+    m_columns[i].push_back(codes[i]);
+  }
+  m_trie.insert(codes);
+  m_ids.push_back(id);
+  m_names.push_back(name);
+  m_hasMetadata.push_back(hasMetadata);
+  m_isErased.push_back(false);
+  m_slotByName[name] = slot;
+  return true;
+}
+
+bool
+CatalogIndex::insert(const std::string& name, bool hasMetadata)
+{
+  std::vector<std::string> fieldValues;
+  if (!splitName(name, fieldValues)) {
+    return false;
+  }
+  return insert(name, fieldValues, hasMetadata);
+}
+
+bool
+CatalogIndex::erase(const std::string& name)
+{
+  boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+  auto it = m_slotByName.find(name);
+  if (it == m_slotByName.end()) {
+    return false;
+  }
+
+  size_t slot = it->second;
+  std::vector<uint32_t> codes(m_nameFields.size());
+  for (size_t i = 0; i < m_nameFields.size(); ++i) {
+    codes[i] = m_columns[i][slot];
+    m_dictionaries[i].postings[codes[i]].remove(static_cast<uint32_t>(m_ids[slot]));
+  }
+  m_trie.erase(codes);
+  for (size_t i = 0; i < m_nameFields.size(); ++i) {
+    releaseCode(m_dictionaries[i], codes[i]);
+  }
+  m_isErased[slot] = true;
+  m_names[slot].clear();
+  m_slotByName.erase(it);
+  ++m_nErased;
+
+  compact();
+  return true;
+}
+
+void
+CatalogIndex::clear()
+{
+  boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+  m_dictionaries.assign(m_nameFields.size(), Dictionary());
+  m_columns.assign(m_nameFields.size(), std::vector<uint32_t>());
+  m_ids.clear();
+  m_names.clear();
+  m_hasMetadata.clear();
+  m_isErased.clear();
+  m_slotByName.clear();
+  m_trie.clear();
+  m_nErased = 0;
+}
+
+size_t
+CatalogIndex::size() const
+{
+  boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+  return m_slotByName.size();
+}
+
+uint64_t
+CatalogIndex::count(const QueryParams& params) const
+{
+  uint64_t lastId = 0;
+  return count(params, lastId);
+}
+
+uint64_t
+CatalogIndex::count(const QueryParams& params, uint64_t& lastId) const
+{
+  boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+  lastId = m_lastId;
+
+  NameTrie::NodeId node;
+  if (findPrefixNode(params, true, node) >= 0) {
+    return (node == NameTrie::NONE) ? 0 : m_trie.getCount(node);
+  }
+
+  PostingBitmap result;
+  if (!evaluate(params, true, result)) {
+    return m_slotByName.size();
+  }
+  return result.getCardinality();
+}
+
+void
+CatalogIndex::find(const QueryParams& params,
+                   uint64_t afterId,
+                   size_t limit,
+                   std::vector<Record>& records) const
+{
+  boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+  PostingBitmap result;
+  if (!evaluate(params, true, result)) {
+    size_t nFound = 0;
+    for (size_t slot = findSlot(afterId); slot < m_ids.size() && nFound < limit; ++slot) {
+      if (!m_isErased[slot]) {
+        records.push_back(Record{m_ids[slot], m_names[slot], m_hasMetadata[slot]});
+        ++nFound;
+      }
+    }
+    return;
+  }
+
+  std::vector<uint32_t> ids;
+  result.select(afterId + 1, limit, ids);
+  for (uint32_t id : ids) {
+    size_t slot = getSlot(id);
+    records.push_back(Record{id, m_names[slot], m_hasMetadata[slot]});
+  }
+}
+
+bool
+CatalogIndex::findDistinctValues(const QueryParams& params,
+                                 const std::string& nextField,
+                                 std::vector<std::string>& values) const
+{
+  int field = findField(nextField);
+  if (field < 0) {
+    return false;
+  }
+
+  boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+  const Dictionary& dictionary = m_dictionaries[field];
+
+  // autocompletion fixes the fields before the one to complete: the values are the children
+  // of one trie node
+  NameTrie::NodeId node;
+  if (findPrefixNode(params, false, node) == field) {
+    if (node != NameTrie::NONE) {
+      std::vector<uint32_t> codes;
+      m_trie.getChildren(node, codes);
+      for (uint32_t code : codes) {
+        values.push_back(dictionary.values[code]);
+      }
+      std::sort(values.begin(), values.end());
+    }
+    return true;
+  }
+
+  PostingBitmap result;
+  if (!evaluate(params, false, result)) {
+    // every value in the dictionary is used by some record
+    for (size_t code = 0; code < dictionary.values.size(); ++code) {
+      if (dictionary.refCounts[code] > 0) {
+        values.push_back(dictionary.values[code]);
+      }
+    }
+  }
+  else {
+    std::vector<bool> isSeen(dictionary.values.size(), false);
+    std::vector<uint32_t> ids;
+    result.select(0, result.getCardinality(), ids);
+    for (uint32_t id : ids) {
+      uint32_t code = m_columns[field][getSlot(id)];
+      if (!isSeen[code]) {
+        isSeen[code] = true;
+        values.push_back(dictionary.values[code]);
+      }
+    }
+  }
+  std::sort(values.begin(), values.end());
+  return true;
+}
+
+size_t
+CatalogIndex::getMemoryUsage() const
+{
+  boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+  size_t memoryUsage = m_ids.capacity() * sizeof(uint64_t);
+  for (size_t i = 0; i < m_nameFields.size(); ++i) {
+    memoryUsage += m_columns[i].capacity() * sizeof(uint32_t);
+    for (const auto& posting : m_dictionaries[i].postings) {
+      memoryUsage += sizeof(PostingBitmap) + posting.getMemoryUsage();
+    }
+  }
+  return memoryUsage + m_trie.getMemoryUsage();
+}
+
+bool
+CatalogIndex::splitName(const std::string& name, std::vector<std::string>& fieldValues) const
+{
+  return index::splitName(name, fieldValues) && fieldValues.size() == m_nameFields.size();
+}
+
+int
+CatalogIndex::findField(const std::string& field) const
+{
+  for (size_t i = 0; i < m_nameFields.size(); ++i) {
+    if (m_nameFields[i] == field) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+int
+CatalogIndex::findPrefixNode(const QueryParams& params,
+                             bool allowPatterns,
+                             NameTrie::NodeId& node) const
+{
+  std::vector<const std::string*> values(m_nameFields.size(), nullptr);
+  size_t nFixed = 0;
+  for (const auto& param : params) {
+    int field = findField(param.first);
+    if (field < 0) {
+      continue;
+    }
+    if (values[field] != nullptr ||
+        (allowPatterns && param.second.find_first_of("%_") != std::string::npos)) {
+      return -1;
+    }
+    values[field] = &param.second;
+    ++nFixed;
+  }
+
+  std::vector<uint32_t> codes(nFixed);
+  for (size_t i = 0; i < nFixed; ++i) {
+    if (values[i] == nullptr) {
+      // the fixed fields are not the leading ones
+      return -1;
+    }
+  }
+  for (size_t i = 0; i < nFixed; ++i) {
+    auto code = m_dictionaries[i].codes.find(*values[i]);
+    if (code == m_dictionaries[i].codes.end()) {
+      node = NameTrie::NONE;
+      return static_cast<int>(nFixed);
+    }
+    codes[i] = code->second;
+  }
+
+  node = m_trie.find(codes, nFixed);
+  return static_cast<int>(nFixed);
+}
+
+bool
+CatalogIndex::evaluate(const QueryParams& params,
+                       bool allowPatterns,
+                       PostingBitmap& result) const
+{
+  // the postings of every constrained field; a pattern matches several values, whose postings
+  // are united first
+  std::vector<const PostingBitmap*> postings;
+  std::vector<PostingBitmap> unions;
+  unions.reserve(params.size());
+
+  for (const auto& param : params) {
+    int field = findField(param.first);
+    if (field < 0) {
+      continue;
+    }
+
+    const Dictionary& dictionary = m_dictionaries[field];
+    if (!allowPatterns || param.second.find_first_of("%_") == std::string::npos) {
+      auto code = dictionary.codes.find(param.second);
+      if (code == dictionary.codes.end()) {
+        result.clear();
+        return true;
+      }
+      postings.push_back(&dictionary.postings[code->second]);
+    }
+    else {
+      unions.push_back(PostingBitmap());
+      for (size_t code = 0; code < dictionary.values.size(); ++code) {
+        if (dictionary.refCounts[code] > 0 && matchLikePattern(dictionary.values[code],
+                                                               param.second)) {
+          unions.back().uniteWith(dictionary.postings[code]);
+        }
+      }
+      postings.push_back(&unions.back());
+    }
+  }
+
+  if (postings.empty()) {
+    return false;
+  }
+
+  // starting from the smallest set keeps every intermediate result small
+  std::sort(postings.begin(), postings.end(),
+            [] (const PostingBitmap* a, const PostingBitmap* b) {
+              return a->getCardinality() < b->getCardinality();
+            });
+  result = *postings.front();
+  for (size_t i = 1; i < postings.size() && !result.empty(); ++i) {
+    result.intersectWith(*postings[i]);
+  }
+  return true;
+}
+
+size_t
+CatalogIndex::getSlot(uint32_t id) const
+{
+  return std::lower_bound(m_ids.begin(), m_ids.end(), id) - m_ids.begin();
+}
+
+size_t
+CatalogIndex::findSlot(uint64_t afterId) const
+{
+  return std::upper_bound(m_ids.begin(), m_ids.end(), afterId) - m_ids.begin();
+}
+
+uint32_t
+CatalogIndex::acquireCode(Dictionary& dictionary, const std::string& value)
+{
+  auto it = dictionary.codes.find(value);
+  if (it != dictionary.codes.end()) {
+    ++dictionary.refCounts[it->second];
+    return it->second;
+  }
+
+  uint32_t code;
+  if (!dictionary.freeCodes.empty()) {
+    code = dictionary.freeCodes.back();
+    dictionary.freeCodes.pop_back();
+    dictionary.values[code] = value;
+    dictionary.refCounts[code] = 1;
+  }
+  else {
+    code = static_cast<uint32_t>(dictionary.values.size());
+    dictionary.values.push_back(value);
+    dictionary.refCounts.push_back(1);
+    dictionary.postings.push_back(PostingBitmap());
+  }
+  dictionary.codes[value] = code;
+  return code;
+}
+
+void
+CatalogIndex::releaseCode(Dictionary& dictionary, uint32_t code)
+{
+  if (--dictionary.refCounts[code] == 0) {
+    dictionary.codes.erase(dictionary.values[code]);
+    dictionary.values[code].clear();
+    dictionary.postings[code].clear();
+    dictionary.freeCodes.push_back(code);
+  }
+}
+
+void
+CatalogIndex::compact()
+{
+  if (m_nErased * 2 < m_ids.size()) {
+    return;
+  }
+
+  size_t nKept = 0;
+  for (size_t slot = 0; slot < m_ids.size(); ++slot) {
+    if (m_isErased[slot]) {
+      continue;
+    }
+    for (auto& column : m_columns) {
+      column[nKept] = column[slot];
+    }
+    m_ids[nKept] = m_ids[slot];
+    m_names[nKept].swap(m_names[slot]);
+    m_hasMetadata[nKept] = m_hasMetadata[slot];
+    m_slotByName[m_names[nKept]] = nKept;
+    ++nKept;
+  }
+
+  for (auto& column : m_columns) {
+    column.resize(nKept);
+  }
+  m_ids.resize(nKept);
+  m_names.resize(nKept);
+  m_hasMetadata.resize(nKept);
+  m_isErased.assign(nKept, false);
+  m_nErased = 0;
+}
+
+bool
+splitName(const std::string& name, std::vector<std::string>& components)
+{
+  // names start with either ndn:/ or /
+  size_t start = 0;
+  if (name.compare(0, 5, "ndn:/") == 0) {
+    start = 5;
+  }
+  else if (name.compare(0, 1, "/") == 0) {
+    start = 1;
+  }
+  else {
+    return false;
+  }
+
+  components.clear();
+  size_t pos = 0;
+  while ((pos = name.find('/', start)) != std::string::npos) {
+    components.push_back(name.substr(start, pos - start));
+    start = pos + 1;
+  }
+  components.push_back(name.substr(start));
+  return true;
+}
+
+bool
+matchLikePattern(const std::string& value, const std::string& pattern)
+{
+  // greedy matching with backtracking to the last '%'
+  size_t v = 0, p = 0;
+  size_t starPattern = std::string::npos, starValue = 0;
+  while (v < value.size()) {
+    if (p < pattern.size() && (pattern[p] == '_' || pattern[p] == value[v])) {
+      ++v;
+      ++p;
+    }
+    else if (p < pattern.size() && pattern[p] == '%') {
+      starPattern = p++;
+      starValue = v;
+    }
+    else if (starPattern != std::string::npos) {
+      p = starPattern + 1;
+      v = ++starValue;
+    }
+    else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '%') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+} // namespace index
+} // namespace atmos
@@ -0,0 +1,278 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_INDEX_CATALOG_INDEX_HPP
+#define ATMOS_INDEX_CATALOG_INDEX_HPP
+
+#include "index/name-trie.hpp"
+#include "index/posting-bitmap.hpp"
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace atmos {
+namespace index {
+
+/**
+ * CatalogIndex keeps the catalog records in memory and answers the catalog queries.
+ *
+ * Every name field is stored as a column of integer codes into a per-field dictionary of
+ * distinct values. Every dictionary value also has a posting bitmap of the ids of the records
+ * that have it, so a query is the intersection of one bitmap per constrained field, and its
+ * result count is the cardinality of that intersection. A trie of the encoded names answers
+ * the queries that fix the leading name fields, such as autocompletion and prefix search, with
+ * a single node lookup. Records keep their insertion order,
+ * and every record gets an increasing id that is never reused, which allows keyset pagination
+ * like the id column of the database table.
+ *
+ * Values are matched like the SQL queries they replace: in filter and prefix queries a value
+ * with '%' or '_' is a LIKE pattern and any other value must be equal, in autocompletion all
+ * values must be equal. Unlike MySQL's default collation, matching is case sensitive.
+ *
+ * The index is safe to use from several threads; queries share a lock, updates take it alone.
+ */
+class CatalogIndex : boost::noncopyable
+{
+public:
+  /**
+   * Pairs of (name field, value), as produced by QueryAdapter::doFilterBasedSearch
+   */
+  typedef std::vector<std::pair<std::string, std::string>> QueryParams;
+
+  struct Record
+  {
+    uint64_t id;
+    std::string name;
+    bool hasMetadata;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param nameFields: the name fields, in the order they appear in the names
+   */
+  explicit
+  CatalogIndex(const std::vector<std::string>& nameFields);
+
+  /**
+   * Add a record
+   *
+   * @param name:        the name of the published data
+   * @param fieldValues: the value of every name field
+   * @param hasMetadata: the has_metadata flag
+   * @return false if the name exists already or the number of values is wrong
+   */
+  bool
+  insert(const std::string& name,
+         const std::vector<std::string>& fieldValues,
+         bool hasMetadata);
+
+  /**
+   * Add a record, the field values are the name components
+   *
+   * @return false if the name exists already or does not have one component per name field
+   */
+  bool
+  insert(const std::string& name, bool hasMetadata);
+
+  /**
+   * Remove a record
+   *
+   * @return false if there is no record with that name
+   */
+  bool
+  erase(const std::string& name);
+
+  /**
+   * Remove all records
+   */
+  void
+  clear();
+
+  /**
+   * @return the number of records
+   */
+  size_t
+  size() const;
+
+  /**
+   * Count the records that match a filter or prefix query
+   *
+   * @param params: the query, fields that are not name fields are ignored
+   */
+  uint64_t
+  count(const QueryParams& params) const;
+
+  /**
+   * Count the records that match a filter or prefix query, and get the largest record id at
+   * the same time, so that the records found later can be limited to the counted ones
+   *
+   * @param params: the query, fields that are not name fields are ignored
+   * @param lastId: to save the largest id inserted so far, 0 if there is none
+   */
+  uint64_t
+  count(const QueryParams& params, uint64_t& lastId) const;
+
+  /**
+   * Find the records that match a filter or prefix query, in id order
+   *
+   * @param params:  the query, fields that are not name fields are ignored
+   * @param afterId: only records with a larger id are returned, 0 for all
+   * @param limit:   the maximum number of records
+   * @param records: to save the records, they are appended
+   */
+  void
+  find(const QueryParams& params,
+       uint64_t afterId,
+       size_t limit,
+       std::vector<Record>& records) const;
+
+  /**
+   * Find the distinct values of a field among the records that match a query, for
+   * autocompletion
+   *
+   * @param params:    the typed name components, matched exactly
+   * @param nextField: the field to list
+   * @param values:    to save the values, sorted
+   * @return false if nextField is not a name field
+   */
+  bool
+  findDistinctValues(const QueryParams& params,
+                     const std::string& nextField,
+                     std::vector<std::string>& values) const;
+
+  /**
+   * @return the approximate heap memory of the codes and the posting bitmaps in bytes
+   */
+  size_t
+  getMemoryUsage() const;
+
+  /**
+   * Split a name into its field values, like PublishAdapter::name2Fields
+   *
+   * @return false if the name does not have one component per name field
+   */
+  bool
+  splitName(const std::string& name, std::vector<std::string>& fieldValues) const;
+
+private:
+  /**
+   * Distinct values of one name field
+   */
+  struct Dictionary
+  {
+    std::vector<std::string> values;
+    std::vector<uint32_t> refCounts;
+    std::unordered_map<std::string, uint32_t> codes;
+    std::vector<uint32_t> freeCodes;
+    // ids of the records with each value, indexed by code
+    std::vector<PostingBitmap> postings;
+  };
+
+  int
+  findField(const std::string& field) const;
+
+  /**
+   * Find the trie node of a query that fixes exactly the leading name fields
+   *
+   * @param params:        the query
+   * @param allowPatterns: whether values with '%' or '_' are LIKE patterns
+   * @param node:          to save the node, NameTrie::NONE if no record matches
+   * @return the number of fixed fields, or -1 if the query is not such a prefix
+   */
+  int
+  findPrefixNode(const QueryParams& params, bool allowPatterns, NameTrie::NodeId& node) const;
+
+  /**
+   * Find the ids of the records that match a query
+   *
+   * @param params:        the query
+   * @param allowPatterns: whether values with '%' or '_' are LIKE patterns
+   * @param result:        to save the ids
+   * @return false if no name field is constrained, result is not set then
+   */
+  bool
+  evaluate(const QueryParams& params, bool allowPatterns, PostingBitmap& result) const;
+
+  /**
+   * @return the slot of a record that exists
+   */
+  size_t
+  getSlot(uint32_t id) const;
+
+  /**
+   * @return the first slot whose id is larger than afterId
+   */
+  size_t
+  findSlot(uint64_t afterId) const;
+
+  uint32_t
+  acquireCode(Dictionary& dictionary, const std::string& value);
+
+  void
+  releaseCode(Dictionary& dictionary, uint32_t code);
+
+  /**
+   * Drop the slots of removed records once they are the majority
+   */
+  void
+  compact();
+
+private:
+  const std::vector<std::string> m_nameFields;
+
+  mutable boost::shared_mutex m_mutex;
+  // @{ needs m_mutex protection
+  std::vector<Dictionary> m_dictionaries;
+  // one column of codes per name field, one slot per record
+  std::vector<std::vector<uint32_t>> m_columns;
+  std::vector<uint64_t> m_ids;
+  std::vector<std::string> m_names;
+  std::vector<bool> m_hasMetadata;
+  std::vector<bool> m_isErased;
+  std::unordered_map<std::string, size_t> m_slotByName;
+  NameTrie m_trie;
+  size_t m_nErased;
+  uint64_t m_lastId;
+  // @}
+};
+
+/**
+ * Split a catalog name into its components, like PublishAdapter::name2Fields
+ *
+ * @return false if the name does not start with "ndn:/" or "/"
+ */
+bool
+splitName(const std::string& name, std::vector<std::string>& components);
+
+/**
+ * Match a value against an SQL LIKE pattern, '%' matches any sequence and '_' any character
+ */
+bool
+matchLikePattern(const std::string& value, const std::string& pattern);
+
+} // namespace index
+} // namespace atmos
+
+#endif // ATMOS_INDEX_CATALOG_INDEX_HPP
@@ -0,0 +1,98 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/distinct-values.hpp"
+
+namespace atmos {
+namespace index {
+
+DistinctValues::DistinctValues(size_t nColumns)
+  : m_counts(nColumns)
+  , m_version(0)
+{
+}
+
+void
+DistinctValues::add(const std::vector<std::string>& values, uint64_t nRecords)
+{
+  if (values.size() != m_counts.size() || nRecords == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (size_t i = 0; i < values.size(); ++i) {
+    uint64_t& count = m_counts[i][values[i]];
+    if (count == 0) {
+      ++m_version;
+    }
+    count += nRecords;
+  }
+}
+
+void
+DistinctValues::remove(const std::vector<std::string>& values)
+{
+  if (values.size() != m_counts.size()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto it = m_counts[i].find(values[i]);
+    if (it == m_counts[i].end()) {
+      continue;
+    }
+    if (--it->second == 0) {
+      m_counts[i].erase(it);
+      ++m_version;
+    }
+  }
+}
+
+void
+DistinctValues::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto& column : m_counts) {
+    column.clear();
+  }
+  ++m_version;
+}
+
+void
+DistinctValues::getValues(size_t column, std::vector<std::string>& values) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (column >= m_counts.size()) {
+    return;
+  }
+  values.reserve(values.size() + m_counts[column].size());
+  for (const auto& value : m_counts[column]) {
+    values.push_back(value.first);
+  }
+}
+
+uint64_t
+DistinctValues::getVersion() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_version;
+}
+
+} // namespace index
+} // namespace atmos
@@ -0,0 +1,94 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_INDEX_DISTINCT_VALUES_HPP
+#define ATMOS_INDEX_DISTINCT_VALUES_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace atmos {
+namespace index {
+
+/**
+ * DistinctValues keeps the distinct values of a few columns with the number of records that
+ * have each value, so that the list of values can follow additions and removals without
+ * scanning the table again.
+ *
+ * It is safe to use from several threads.
+ */
+class DistinctValues : boost::noncopyable
+{
+public:
+  /**
+   * Constructor
+   *
+   * @param nColumns: the number of columns
+   */
+  explicit
+  DistinctValues(size_t nColumns);
+
+  /**
+   * Count records
+   *
+   * @param values:   the value of every column
+   * @param nRecords: the number of records that have these values
+   */
+  void
+  add(const std::vector<std::string>& values, uint64_t nRecords = 1);
+
+  /**
+   * Uncount a record, a value goes away with the last record that has it
+   *
+   * @param values: the value of every column
+   */
+  void
+  remove(const std::vector<std::string>& values);
+
+  void
+  clear();
+
+  /**
+   * Get the distinct values of a column, sorted
+   */
+  void
+  getValues(size_t column, std::vector<std::string>& values) const;
+
+  /**
+   * @return a number that changes whenever a value is added to or removed from some column
+   */
+  uint64_t
+  getVersion() const;
+
+private:
+  mutable std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  std::vector<std::map<std::string, uint64_t>> m_counts;
+  uint64_t m_version;
+  // @}
+};
+
+} // namespace index
+} // namespace atmos
+
+#endif // ATMOS_INDEX_DISTINCT_VALUES_HPP
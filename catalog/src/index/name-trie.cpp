@@ -0,0 +1,158 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/name-trie.hpp"
+
+#include <algorithm>
+
+namespace atmos {
+namespace index {
+
+const NameTrie::NodeId NameTrie::ROOT;
+const NameTrie::NodeId NameTrie::NONE;
+
+static bool
+compareCode(const std::pair<uint32_t, NameTrie::NodeId>& child, uint32_t code)
+{
+  return child.first < code;
+}
+
+NameTrie::NameTrie()
+{
+  clear();
+}
+
+void
+NameTrie::insert(const std::vector<uint32_t>& codes)
+{
+  NodeId node = ROOT;
+  ++m_nodes[node].count;
+  for (uint32_t code : codes) {
+    NodeId child = findChild(node, code);
+    if (child == NONE) {
+      // allocating may move the nodes, so the parent is looked up again afterwards
+      child = allocateNode();
+      auto& children = m_nodes[node].children;
+      children.insert(std::lower_bound(children.begin(), children.end(), code, compareCode),
+                      std::make_pair(code, child));
+    }
+    node = child;
+    ++m_nodes[node].count;
+  }
+}
+
+bool
+NameTrie::erase(const std::vector<uint32_t>& codes)
+{
+  std::vector<NodeId> path;
+  path.reserve(codes.size() + 1);
+  path.push_back(ROOT);
+  for (uint32_t code : codes) {
+    NodeId child = findChild(path.back(), code);
+    if (child == NONE) {
+      return false;
+    }
+    path.push_back(child);
+  }
+
+  for (size_t depth = 0; depth < path.size(); ++depth) {
+    --m_nodes[path[depth]].count;
+  }
+
+  // drop the nodes no name goes through any more
+  for (size_t depth = path.size() - 1; depth > 0; --depth) {
+    Node& node = m_nodes[path[depth]];
+    if (node.count > 0) {
+      break;
+    }
+    std::vector<std::pair<uint32_t, NodeId>>().swap(node.children);
+    m_freeNodes.push_back(path[depth]);
+
+    auto& siblings = m_nodes[path[depth - 1]].children;
+    siblings.erase(std::lower_bound(siblings.begin(), siblings.end(), codes[depth - 1],
+                                    compareCode));
+  }
+  return true;
+}
+
+NameTrie::NodeId
+NameTrie::find(const std::vector<uint32_t>& codes, size_t length) const
+{
+  NodeId node = ROOT;
+  for (size_t i = 0; i < length && i < codes.size() && node != NONE; ++i) {
+    node = findChild(node, codes[i]);
+  }
+  return node;
+}
+
+void
+NameTrie::getChildren(NodeId node, std::vector<uint32_t>& codes) const
+{
+  for (const auto& child : m_nodes[node].children) {
+    codes.push_back(child.first);
+  }
+}
+
+size_t
+NameTrie::getMemoryUsage() const
+{
+  size_t memoryUsage = m_nodes.capacity() * sizeof(Node) +
+                       m_freeNodes.capacity() * sizeof(NodeId);
+  for (const auto& node : m_nodes) {
+    memoryUsage += node.children.capacity() * sizeof(std::pair<uint32_t, NodeId>);
+  }
+  return memoryUsage;
+}
+
+void
+NameTrie::clear()
+{
+  m_nodes.assign(1, Node());
+  m_nodes[ROOT].count = 0;
+  m_freeNodes.clear();
+}
+
+NameTrie::NodeId
+NameTrie::findChild(NodeId node, uint32_t code) const
+{
+  const auto& children = m_nodes[node].children;
+  auto it = std::lower_bound(children.begin(), children.end(), code, compareCode);
+  if (it == children.end() || it->first != code) {
+    return NONE;
+  }
+  return it->second;
+}
+
+NameTrie::NodeId
+NameTrie::allocateNode()
+{
+  NodeId node;
+  if (!m_freeNodes.empty()) {
+    node = m_freeNodes.back();
+    m_freeNodes.pop_back();
+  }
+  else {
+    node = static_cast<NodeId>(m_nodes.size());
+    m_nodes.push_back(Node());
+  }
+  m_nodes[node].count = 0;
+  return node;
+}
+
+} // namespace index
+} // namespace atmos
@@ -0,0 +1,128 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_INDEX_NAME_TRIE_HPP
+#define ATMOS_INDEX_NAME_TRIE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace atmos {
+namespace index {
+
+/**
+ * NameTrie is a trie of names whose components are dictionary codes, one level per name field.
+ *
+ * Every node keeps its children sorted by code and the number of names below it, so the next
+ * components after a typed prefix are the children of one node, and the number of names with
+ * a prefix is the count of one node. The nodes live in one array and are reused after removal.
+ */
+class NameTrie
+{
+public:
+  typedef uint32_t NodeId;
+
+  static const NodeId ROOT = 0;
+  static const NodeId NONE = static_cast<NodeId>(-1);
+
+  NameTrie();
+
+  /**
+   * Add a name, names may be added more than once
+   *
+   * @param codes: the codes of the name components
+   */
+  void
+  insert(const std::vector<uint32_t>& codes);
+
+  /**
+   * Remove a name that was added
+   *
+   * @return false if the name is not in the trie
+   */
+  bool
+  erase(const std::vector<uint32_t>& codes);
+
+  /**
+   * Find the node of a prefix
+   *
+   * @param codes:  the codes of the components
+   * @param length: the number of leading components that make the prefix
+   * @return the node, or NONE if no name has the prefix
+   */
+  NodeId
+  find(const std::vector<uint32_t>& codes, size_t length) const;
+
+  /**
+   * @return the number of names below a node
+   */
+  uint64_t
+  getCount(NodeId node) const
+  {
+    return m_nodes[node].count;
+  }
+
+  /**
+   * Get the codes of the children of a node, sorted by code
+   */
+  void
+  getChildren(NodeId node, std::vector<uint32_t>& codes) const;
+
+  /**
+   * @return the number of nodes in use, including the root
+   */
+  size_t
+  getNNodes() const
+  {
+    return m_nodes.size() - m_freeNodes.size();
+  }
+
+  /**
+   * @return the approximate heap memory in bytes
+   */
+  size_t
+  getMemoryUsage() const;
+
+  void
+  clear();
+
+private:
+  struct Node
+  {
+    uint64_t count;
+    // (code, child) sorted by code
+    std::vector<std::pair<uint32_t, NodeId>> children;
+  };
+
+  NodeId
+  findChild(NodeId node, uint32_t code) const;
+
+  NodeId
+  allocateNode();
+
+private:
+  std::vector<Node> m_nodes;
+  std::vector<NodeId> m_freeNodes;
+};
+
+} // namespace index
+} // namespace atmos
+
+#endif // ATMOS_INDEX_NAME_TRIE_HPP
@@ -0,0 +1,388 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/posting-bitmap.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace atmos {
+namespace index {
+
+static const size_t BITMAP_WORDS = 1024;
+
+static inline uint32_t
+popcount(uint64_t word)
+{
+  return static_cast<uint32_t>(__builtin_popcountll(word));
+}
+
+const size_t PostingBitmap::MAX_ARRAY_SIZE;
+
+PostingBitmap::PostingBitmap()
+  : m_cardinality(0)
+{
+}
+
+bool
+PostingBitmap::add(uint32_t id)
+{
+  uint16_t key = static_cast<uint16_t>(id >> 16);
+  uint16_t low = static_cast<uint16_t>(id & 0xFFFF);
+
+  auto container = findContainer(key);
+  if (container == m_containers.end() || container->key != key) {
+    Container newContainer;
+    newContainer.key = key;
+    newContainer.cardinality = 0;
+    container = m_containers.insert(container, std::move(newContainer));
+  }
+
+  if (container->isBitmap()) {
+    uint64_t& word = container->bits[low >> 6];
+    uint64_t mask = uint64_t(1) << (low & 63);
+    if (word & mask) {
+      return false;
+    }
+    word |= mask;
+  }
+  else {
+    auto it = std::lower_bound(container->array.begin(), container->array.end(), low);
+    if (it != container->array.end() && *it == low) {
+      return false;
+    }
+    container->array.insert(it, low);
+  }
+
+  ++container->cardinality;
+  ++m_cardinality;
+  if (!container->isBitmap() && container->cardinality > MAX_ARRAY_SIZE) {
+    toBitmap(*container);
+  }
+  return true;
+}
+
+bool
+PostingBitmap::remove(uint32_t id)
+{
+  uint16_t key = static_cast<uint16_t>(id >> 16);
+  uint16_t low = static_cast<uint16_t>(id & 0xFFFF);
+
+  auto container = findContainer(key);
+  if (container == m_containers.end() || container->key != key) {
+    return false;
+  }
+
+  if (container->isBitmap()) {
+    uint64_t& word = container->bits[low >> 6];
+    uint64_t mask = uint64_t(1) << (low & 63);
+    if (!(word & mask)) {
+      return false;
+    }
+    word &= ~mask;
+  }
+  else {
+    auto it = std::lower_bound(container->array.begin(), container->array.end(), low);
+    if (it == container->array.end() || *it != low) {
+      return false;
+    }
+    container->array.erase(it);
+  }
+
+  --container->cardinality;
+  --m_cardinality;
+  if (container->cardinality == 0) {
+    m_containers.erase(container);
+  }
+  else {
+    shrink(*container);
+  }
+  return true;
+}
+
+bool
+PostingBitmap::contains(uint32_t id) const
+{
+  uint16_t key = static_cast<uint16_t>(id >> 16);
+  uint16_t low = static_cast<uint16_t>(id & 0xFFFF);
+
+  auto container = findContainer(key);
+  if (container == m_containers.end() || container->key != key) {
+    return false;
+  }
+  if (container->isBitmap()) {
+    return (container->bits[low >> 6] >> (low & 63)) & 1;
+  }
+  return std::binary_search(container->array.begin(), container->array.end(), low);
+}
+
+void
+PostingBitmap::clear()
+{
+  m_containers.clear();
+  m_cardinality = 0;
+}
+
+void
+PostingBitmap::intersectWith(const PostingBitmap& other)
+{
+  std::vector<Container> result;
+  m_cardinality = 0;
+
+  auto it = m_containers.begin();
+  auto otherIt = other.m_containers.begin();
+  while (it != m_containers.end() && otherIt != other.m_containers.end()) {
+    if (it->key < otherIt->key) {
+      ++it;
+    }
+    else if (otherIt->key < it->key) {
+      ++otherIt;
+    }
+    else {
+      intersect(*it, *otherIt);
+      if (it->cardinality > 0) {
+        m_cardinality += it->cardinality;
+        result.push_back(std::move(*it));
+      }
+      ++it;
+      ++otherIt;
+    }
+  }
+  m_containers.swap(result);
+}
+
+void
+PostingBitmap::uniteWith(const PostingBitmap& other)
+{
+  std::vector<Container> result;
+  result.reserve(std::max(m_containers.size(), other.m_containers.size()));
+  m_cardinality = 0;
+
+  auto it = m_containers.begin();
+  auto otherIt = other.m_containers.begin();
+  while (it != m_containers.end() || otherIt != other.m_containers.end()) {
+    if (otherIt == other.m_containers.end() ||
+        (it != m_containers.end() && it->key < otherIt->key)) {
+      result.push_back(std::move(*it));
+      ++it;
+    }
+    else if (it == m_containers.end() || otherIt->key < it->key) {
+      result.push_back(*otherIt);
+      ++otherIt;
+    }
+    else {
+      unite(*it, *otherIt);
+      result.push_back(std::move(*it));
+      ++it;
+      ++otherIt;
+    }
+    m_cardinality += result.back().cardinality;
+  }
+  m_containers.swap(result);
+}
+
+void
+PostingBitmap::select(uint64_t fromId, size_t limit, std::vector<uint32_t>& ids) const
+{
+  if (limit == 0 || fromId > std::numeric_limits<uint32_t>::max()) {
+    return;
+  }
+
+  uint32_t start = static_cast<uint32_t>(fromId);
+  uint16_t startKey = static_cast<uint16_t>(start >> 16);
+
+  size_t nSelected = 0;
+  for (auto container = findContainer(startKey);
+       container != m_containers.end() && nSelected < limit; ++container) {
+    uint32_t high = uint32_t(container->key) << 16;
+    uint32_t lowStart = (container->key == startKey) ? (start & 0xFFFF) : 0;
+
+    if (container->isBitmap()) {
+      for (size_t w = lowStart >> 6; w < BITMAP_WORDS && nSelected < limit; ++w) {
+        uint64_t word = container->bits[w];
+        if (w == (lowStart >> 6)) {
+          word &= ~uint64_t(0) << (lowStart & 63);
+        }
+        while (word != 0 && nSelected < limit) {
+          uint32_t bit = static_cast<uint32_t>(__builtin_ctzll(word));
+          ids.push_back(high | static_cast<uint32_t>(w << 6) | bit);
+          ++nSelected;
+          word &= word - 1;
+        }
+      }
+    }
+    else {
+      auto it = std::lower_bound(container->array.begin(), container->array.end(),
+                                 static_cast<uint16_t>(lowStart));
+      for (; it != container->array.end() && nSelected < limit; ++it) {
+        ids.push_back(high | *it);
+        ++nSelected;
+      }
+    }
+  }
+}
+
+size_t
+PostingBitmap::getMemoryUsage() const
+{
+  size_t memoryUsage = m_containers.capacity() * sizeof(Container);
+  for (const auto& container : m_containers) {
+    memoryUsage += container.array.capacity() * sizeof(uint16_t) +
+                   container.bits.capacity() * sizeof(uint64_t);
+  }
+  return memoryUsage;
+}
+
+std::vector<PostingBitmap::Container>::iterator
+PostingBitmap::findContainer(uint16_t key)
+{
+  return std::lower_bound(m_containers.begin(), m_containers.end(), key,
+                          [] (const Container& container, uint16_t k) {
+                            return container.key < k;
+                          });
+}
+
+std::vector<PostingBitmap::Container>::const_iterator
+PostingBitmap::findContainer(uint16_t key) const
+{
+  return std::lower_bound(m_containers.begin(), m_containers.end(), key,
+                          [] (const Container& container, uint16_t k) {
+                            return container.key < k;
+                          });
+}
+
+void
+PostingBitmap::toBitmap(Container& container)
+{
+  container.bits.assign(BITMAP_WORDS, 0);
+  for (uint16_t low : container.array) {
+    container.bits[low >> 6] |= uint64_t(1) << (low & 63);
+  }
+  std::vector<uint16_t>().swap(container.array);
+}
+
+void
+PostingBitmap::toArray(Container& container)
+{
+  container.array.clear();
+  container.array.reserve(container.cardinality);
+  for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+    uint64_t word = container.bits[w];
+    while (word != 0) {
+      container.array.push_back(static_cast<uint16_t>((w << 6) | __builtin_ctzll(word)));
+      word &= word - 1;
+    }
+  }
+  std::vector<uint64_t>().swap(container.bits);
+}
+
+void
+PostingBitmap::shrink(Container& container)
+{
+  // converting at half the threshold avoids flipping on every add and remove at the border
+  if (container.isBitmap() && container.cardinality <= MAX_ARRAY_SIZE / 2) {
+    toArray(container);
+  }
+}
+
+void
+PostingBitmap::intersect(Container& container, const Container& other)
+{
+  if (container.isBitmap() && other.isBitmap()) {
+    uint32_t cardinality = 0;
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+      container.bits[w] &= other.bits[w];
+      cardinality += popcount(container.bits[w]);
+    }
+    container.cardinality = cardinality;
+    if (cardinality <= MAX_ARRAY_SIZE) {
+      toArray(container);
+    }
+  }
+  else if (container.isBitmap()) {
+    std::vector<uint16_t> result;
+    result.reserve(other.array.size());
+    for (uint16_t low : other.array) {
+      if ((container.bits[low >> 6] >> (low & 63)) & 1) {
+        result.push_back(low);
+      }
+    }
+    std::vector<uint64_t>().swap(container.bits);
+    container.array.swap(result);
+    container.cardinality = static_cast<uint32_t>(container.array.size());
+  }
+  else if (other.isBitmap()) {
+    auto end = std::remove_if(container.array.begin(), container.array.end(),
+                              [&other] (uint16_t low) {
+                                return !((other.bits[low >> 6] >> (low & 63)) & 1);
+                              });
+    container.array.erase(end, container.array.end());
+    container.cardinality = static_cast<uint32_t>(container.array.size());
+  }
+  else {
+    std::vector<uint16_t> result;
+    std::set_intersection(container.array.begin(), container.array.end(),
+                          other.array.begin(), other.array.end(),
+                          std::back_inserter(result));
+    container.array.swap(result);
+    container.cardinality = static_cast<uint32_t>(container.array.size());
+  }
+}
+
+void
+PostingBitmap::unite(Container& container, const Container& other)
+{
+  if (!container.isBitmap() && !other.isBitmap() &&
+      container.array.size() + other.array.size() <= MAX_ARRAY_SIZE) {
+    std::vector<uint16_t> result;
+    result.reserve(container.array.size() + other.array.size());
+    std::set_union(container.array.begin(), container.array.end(),
+                   other.array.begin(), other.array.end(),
+                   std::back_inserter(result));
+    container.array.swap(result);
+    container.cardinality = static_cast<uint32_t>(container.array.size());
+    return;
+  }
+
+  if (!container.isBitmap()) {
+    toBitmap(container);
+  }
+  if (other.isBitmap()) {
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+      container.bits[w] |= other.bits[w];
+    }
+  }
+  else {
+    for (uint16_t low : other.array) {
+      container.bits[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+  }
+
+  uint32_t cardinality = 0;
+  for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+    cardinality += popcount(container.bits[w]);
+  }
+  container.cardinality = cardinality;
+  if (cardinality <= MAX_ARRAY_SIZE) {
+    toArray(container);
+  }
+}
+
+} // namespace index
+} // namespace atmos
@@ -0,0 +1,150 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_INDEX_POSTING_BITMAP_HPP
+#define ATMOS_INDEX_POSTING_BITMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atmos {
+namespace index {
+
+/**
+ * PostingBitmap is a compressed set of record ids, laid out like a roaring bitmap.
+ *
+ * The ids are split by their upper 16 bits into chunks. A chunk with few ids keeps them as a
+ * sorted array of the lower 16 bits, a dense chunk as a plain 8 KB bitmap, so both sparse and
+ * dense sets are compact and can be intersected chunk by chunk.
+ */
+class PostingBitmap
+{
+public:
+  PostingBitmap();
+
+  /**
+   * @return false if the id is in the set already
+   */
+  bool
+  add(uint32_t id);
+
+  /**
+   * @return false if the id is not in the set
+   */
+  bool
+  remove(uint32_t id);
+
+  bool
+  contains(uint32_t id) const;
+
+  uint64_t
+  getCardinality() const
+  {
+    return m_cardinality;
+  }
+
+  bool
+  empty() const
+  {
+    return m_cardinality == 0;
+  }
+
+  void
+  clear();
+
+  /**
+   * Keep only the ids that are in other as well
+   */
+  void
+  intersectWith(const PostingBitmap& other);
+
+  /**
+   * Add the ids of other
+   */
+  void
+  uniteWith(const PostingBitmap& other);
+
+  /**
+   * Get ids in increasing order
+   *
+   * @param fromId: the smallest id to return
+   * @param limit:  the maximum number of ids
+   * @param ids:    to save the ids, they are appended
+   */
+  void
+  select(uint64_t fromId, size_t limit, std::vector<uint32_t>& ids) const;
+
+  /**
+   * @return the approximate heap memory in bytes
+   */
+  size_t
+  getMemoryUsage() const;
+
+public:
+  /// a chunk with more ids than this is kept as a bitmap
+  static const size_t MAX_ARRAY_SIZE = 4096;
+
+private:
+  struct Container
+  {
+    uint16_t key;
+    uint32_t cardinality;
+    std::vector<uint16_t> array; // sorted lower bits, if bits is empty
+    std::vector<uint64_t> bits;  // 1024 words, if the chunk is dense
+
+    bool
+    isBitmap() const
+    {
+      return !bits.empty();
+    }
+  };
+
+  std::vector<Container>::iterator
+  findContainer(uint16_t key);
+
+  std::vector<Container>::const_iterator
+  findContainer(uint16_t key) const;
+
+  static void
+  toBitmap(Container& container);
+
+  static void
+  toArray(Container& container);
+
+  /**
+   * Convert a bitmap container back to an array if it has become sparse
+   */
+  static void
+  shrink(Container& container);
+
+  static void
+  intersect(Container& container, const Container& other);
+
+  static void
+  unite(Container& container, const Container& other);
+
+private:
+  std::vector<Container> m_containers; // sorted by key
+  uint64_t m_cardinality;
+};
+
+} // namespace index
+} // namespace atmos
+
+#endif // ATMOS_INDEX_POSTING_BITMAP_HPP
@@ -34,27 +34,49 @@ void
 usage()
 {
   std::cout << "\n Usage:\n atmos-catalog "
-    "[-h] [-f config file] \n"
+    "[-h] [-i] [-f config file] \n"
     "   [-f config file]    - set the configuration file\n"
+    "   [-i]                - answer queries from an in-memory index of the catalog\n"
     "   [-h]                - print help and exit\n"
     "\n";
 }
 
+// the query adapter keeps its in-memory state in step with the publication changes, the
+// database stays the durable store
+template <typename DatabaseHandler>
+atmos::util::CatalogAdapter*
+createQueryAdapter(const std::shared_ptr<ndn::Face>& face,
+                   const std::shared_ptr<ndn::KeyChain>& keyChain,
+                   const std::shared_ptr<chronosync::Socket>& syncSocket,
+                   atmos::publish::PublishAdapter<ConnectionPool_T>& publishAdapter)
+{
+  auto queryAdapter = new atmos::query::QueryAdapter<DatabaseHandler>(face, keyChain, syncSocket);
+  publishAdapter.addUpdateListener([queryAdapter] (const std::vector<std::string>& added,
+                                                   const std::vector<std::string>& removed) {
+      queryAdapter->onPublicationUpdate(added, removed);
+    });
+  return queryAdapter;
+}
+
 int
 main(int argc, char** argv)
 {
   int option;
   std::string configFile(DEFAULT_CONFIG_FILE);
+  bool useIndex = false;
 
 #ifdef HAVE_LOG4CXX
   log4cxx::PropertyConfigurator::configure(LOG4CXX_CONFIG_FILE);
 #endif
 
-  while ((option = getopt(argc, argv, "f:h")) != -1) {
+  while ((option = getopt(argc, argv, "f:ih")) != -1) {
     switch (option) {
       case 'f':
         configFile.assign(optarg);
         break;
+      case 'i':
+        useIndex = true;
+        break;
       case 'h':
       default:
         usage();
@@ -77,10 +99,18 @@ main(int argc, char** argv)
   // We may have to save digest in Database later
   std::shared_ptr<chronosync::Socket> syncSocket;
 
-  std::unique_ptr<atmos::util::CatalogAdapter>
-    queryAdapter(new atmos::query::QueryAdapter<ConnectionPool_T>(face, keyChain, syncSocket));
-  std::unique_ptr<atmos::util::CatalogAdapter>
-    publishAdapter(new atmos::publish::PublishAdapter<ConnectionPool_T>(face, keyChain, syncSocket));
+  auto publish = new atmos::publish::PublishAdapter<ConnectionPool_T>(face, keyChain, syncSocket);
+  std::unique_ptr<atmos::util::CatalogAdapter> publishAdapter(publish);
+
+  std::unique_ptr<atmos::util::CatalogAdapter> queryAdapter;
+  if (useIndex) {
+    queryAdapter.reset(createQueryAdapter<atmos::index::CatalogIndex>(face, keyChain, syncSocket,
+                                                                      *publish));
+  }
+  else {
+    queryAdapter.reset(createQueryAdapter<ConnectionPool_T>(face, keyChain, syncSocket,
+                                                            *publish));
+  }
 
   atmos::catalog::Catalog catalogInstance(face, keyChain, configFile);
   catalogInstance.addAdapter(publishAdapter);
@@ -21,6 +21,7 @@
 
 #include "util/catalog-adapter.hpp"
 #include "util/mysql-util.hpp"
+#include "util/signing-policy.hpp"
 #include <mysql/mysql.h>
 
 #include <json/reader.h>
@@ -36,6 +37,7 @@
 #include <ndn-cxx/util/string-helper.hpp>
 
 #include <ChronoSync/socket.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -58,6 +60,15 @@ namespace publish {
 template <typename DatabaseHandler>
 class PublishAdapter : public atmos::util::CatalogAdapter {
 public:
+  /**
+   * Callback for applied publication changes
+   *
+   * @param added:   names of the data added to the catalog
+   * @param removed: names of the data removed from the catalog
+   */
+  typedef std::function<void(const std::vector<std::string>& added,
+                             const std::vector<std::string>& removed)> UpdateListener;
+
   /**
    * Constructor
    *
@@ -81,6 +92,13 @@ public:
                 const std::vector<std::string>& nameFields,
                 const std::string& databaseTable);
 
+  /**
+   * Register a callback that is called after publication changes are written to the database,
+   * e.g., to keep an in-memory index of the catalog up to date
+   */
+  void
+  addUpdateListener(const UpdateListener& listener);
+
 protected:
   /**
    * Helper function that configures piblishAdapter instance according to publish section
@@ -162,8 +180,9 @@ protected:
    *
    * @param sql: sql string to do the add or remove jobs
    * @param op:  enum value indicates the database operation, could be REMOVE, ADD
+   * @return whether the statement was executed
    */
-  virtual void
+  virtual bool
   operateDatabase(const std::string& sql,
                   util::DatabaseOperation op);
 
@@ -241,6 +260,9 @@ protected:
   bool m_mustBeFresh;
   bool m_isFinished;
   ndn::Name m_catalogId;
+  std::vector<UpdateListener> m_updateListeners;
+  // how the publish ACKs are signed
+  util::SigningPolicy m_signingPolicy;
 };
 
 
@@ -253,6 +275,7 @@ PublishAdapter<DatabaseHandler>::PublishAdapter(const std::shared_ptr<ndn::Face>
   , m_mustBeFresh(true)
   , m_isFinished(false)
   , m_catalogId("catalogIdPlaceHolder")
+  , m_signingPolicy(*keyChain)
 {
 }
 
@@ -417,6 +440,21 @@ PublishAdapter<DatabaseHandler>::onConfig(const util::ConfigSection& section,
                     " in \"publish\" section");
       }
     }
+    else if (item->first == "signing") {
+      const util::ConfigSection& signingSection = item->second;
+      for (auto subItem = signingSection.begin();
+           subItem != signingSection.end();
+           ++subItem) {
+        // the publish adapter only sends ACKs
+        util::SigningPolicy::Method method;
+        if (subItem->first != "ack" ||
+            !util::SigningPolicy::parseMethod(subItem->second.get_value<std::string>(), method)) {
+          throw Error("Invalid value for \"" + subItem->first + "\""
+                      " in \"publish\\signing\" section");
+        }
+        m_signingPolicy.setMethod(util::SigningPolicy::PACKET_ACK, method);
+      }
+    }
     else if (item->first == "sync") {
       const util::ConfigSection& synSection = item->second;
       for (auto subItem = synSection.begin();
@@ -437,6 +475,7 @@ PublishAdapter<DatabaseHandler>::onConfig(const util::ConfigSection& section,
   m_prefix = prefix;
   m_signingId = ndn::Name(signingId);
   setCatalogId();
+  m_signingPolicy.setSigningId(m_signingId);
 
   m_syncPrefix = syncPrefix;
   util::ConnectionDetails mysqlId(dbServer, dbUser, dbPasswd, dbName);
@@ -527,7 +566,9 @@ PublishAdapter<DatabaseHandler>::onPublishInterest(const ndn::InterestFilter& fi
   std::shared_ptr<ndn::Data> data = std::make_shared<ndn::Data>(interest.getName());
   data->setFreshnessPeriod(ndn::time::milliseconds(10)); // 10 msec
   data->setContent(reinterpret_cast<const uint8_t*>(buf), strlen(buf));
-  m_keyChain->sign(*data);
+  m_signingPolicy.sign(*data, util::SigningPolicy::PACKET_ACK, [this] (ndn::Data& unsignedData) {
+      m_keyChain->sign(unsignedData);
+    });
   m_face->put(*data);
 
   _LOG_DEBUG("Ack interest : " << interest.getName().toUri());
@@ -655,20 +696,47 @@ PublishAdapter<DatabaseHandler>::processUpdateData(const std::shared_ptr<const n
     return;
   }
 
+  // the listeners only learn about the changes that are in the database
+  std::vector<std::string> added, removed;
+
   std::stringstream ss;
   if (json2Sql(ss, parsedFromPayload, util::ADD)) {
     // todo: before use, check if the connection is not NULL
     // we may need to use lock here to ensure thread safe
-    operateDatabase(ss.str(), util::ADD);
+    if (operateDatabase(ss.str(), util::ADD)) {
+      const Json::Value& addList = parsedFromPayload["add"];
+      for (Json::Value::ArrayIndex i = 0; i < addList.size(); i++) {
+        added.push_back(addList[i].asString());
+      }
+    }
   }
 
   ss.str("");
   ss.clear();
   if (json2Sql(ss, parsedFromPayload, util::REMOVE)) {
-    operateDatabase(ss.str(), util::REMOVE);
+    if (operateDatabase(ss.str(), util::REMOVE)) {
+      const Json::Value& removeList = parsedFromPayload["remove"];
+      for (Json::Value::ArrayIndex i = 0; i < removeList.size(); i++) {
+        removed.push_back(removeList[i].asString());
+      }
+    }
+  }
+
+  if (added.empty() && removed.empty()) {
+    return;
+  }
+  for (const auto& listener : m_updateListeners) {
+    listener(added, removed);
   }
 }
 
+template <typename DatabaseHandler>
+void
+PublishAdapter<DatabaseHandler>::addUpdateListener(const UpdateListener& listener)
+{
+  m_updateListeners.push_back(listener);
+}
+
 template <typename DatabaseHandler>
 chronosync::SeqNo
 PublishAdapter<DatabaseHandler>::getLatestSeqNo(const chronosync::MissingDataInfo& update)
@@ -838,32 +906,36 @@ PublishAdapter<DatabaseHandler>::processSyncUpdate(const std::vector<chronosync:
 }
 
 template <typename DatabaseHandler>
-void
+bool
 PublishAdapter<DatabaseHandler>::operateDatabase(const std::string& sql, util::DatabaseOperation op)
 {
   // empty
+  return true;
 }
 
 template <>
-void
+bool
 PublishAdapter<ConnectionPool_T>::operateDatabase(const std::string& sql, util::DatabaseOperation op)
 {
   Connection_T conn = ConnectionPool_getConnection(*m_databaseHandler);
 
   if (!conn) {
     _LOG_DEBUG("No available database connections");
-    return;
+    return false;
   }
 
+  bool isSuccess = true;
   TRY {
     Connection_execute(conn, reinterpret_cast<const char*>(sql.c_str()), sql.size());
   }
   CATCH(SQLException) {
     _LOG_ERROR(Connection_getLastError(conn));
+    isSuccess = false;
   }
   END_TRY;
 
   Connection_close(conn);
+  return isSuccess;
 }
 
 template<typename DatabaseHandler>
@@ -19,11 +19,27 @@
 #ifndef ATMOS_QUERY_QUERY_ADAPTER_HPP
 #define ATMOS_QUERY_QUERY_ADAPTER_HPP
 
+#include "index/catalog-index.hpp"
+#include "index/distinct-values.hpp"
+#include "util/canonical-query.hpp"
 #include "util/catalog-adapter.hpp"
+#include "util/change-log.hpp"
 #include "util/mysql-util.hpp"
 #include "util/config-file.hpp"
-
-#include <thread>
+#include "util/content-cache.hpp"
+#include "util/face-dispatcher.hpp"
+#include "util/payload-budget.hpp"
+#include "util/result-cursor.hpp"
+#include "util/result-dependencies.hpp"
+#include "util/result-tlv.hpp"
+#include "util/statement-cache.hpp"
+#include "util/segment-encoder.hpp"
+#include "util/segment-manifest.hpp"
+#include "util/segment-store.hpp"
+#include "util/signing-pipeline.hpp"
+#include "util/signing-policy.hpp"
+#include "util/subscription-table.hpp"
+#include "util/worker-pool.hpp"
 
 #include <json/reader.h>
 #include <json/value.h>
@@ -37,16 +53,20 @@
 #include <ndn-cxx/security/key-chain.hpp>
 #include <ndn-cxx/util/time.hpp>
 #include <ndn-cxx/encoding/encoding-buffer.hpp>
-#include <ndn-cxx/util/in-memory-storage-lru.hpp>
 #include <ndn-cxx/util/string-helper.hpp>
 #include <ChronoSync/socket.hpp>
 
 #include "mysql/mysql.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <map>
 #include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
 #include <array>
@@ -61,8 +81,58 @@ namespace query {
   INIT_LOGGER("QueryAdapter");
 #endif
 
-// todo: calculate payload limit by get the size of a signed empty Data packet
-static const size_t PAYLOAD_LIMIT = 7000;
+// default size of the query worker pool, can be changed in the "workers" config section
+static const size_t DEFAULT_QUERY_THREADS = 16;
+static const size_t DEFAULT_QUERY_QUEUE_LENGTH = 1024;
+
+// default size of the pipeline that signs the query results, can be changed in the "signing"
+// config section
+static const size_t DEFAULT_SIGNING_THREADS = 4;
+static const size_t DEFAULT_SIGNING_QUEUE_LENGTH = 4096;
+
+// default number of packets that can wait for the thread of the Face, can be changed in the
+// "dispatcher" config section
+static const size_t DEFAULT_DISPATCHER_QUEUE_LENGTH = 16384;
+
+// default size of the cache of query results, can be changed in the "cache" config section
+static const size_t DEFAULT_CACHE_MEMORY_LIMIT = 256; // MB
+// part of the cache reserved for autocompletion answers, so large results cannot evict them
+static const size_t DEFAULT_CACHE_AUTOCOMPLETE_MEMORY_LIMIT = 32; // MB
+static const size_t DEFAULT_CACHE_SHARDS = 16;
+// number of queries whose latest results are kept valid across the publications that do not
+// change them
+static const size_t MAX_TRACKED_QUERY_RESULTS = 65536;
+
+// room left in every query-results packet for renaming it from the canonical query to an
+// equivalent one that is written longer, e.g. with whitespace
+static const size_t MAX_CANONICAL_QUERY_GROWTH = 64; // bytes
+
+// default size of the file that keeps the query results over a restart, enabled by the "store"
+// config section
+static const size_t DEFAULT_STORE_SIZE = 1024; // MB
+
+// default number of publication changes kept for delta queries, can be changed in the
+// "changeLog" config section
+static const size_t DEFAULT_CHANGE_LOG_SIZE = 100000;
+
+// defaults of the standing queries, can be changed in the "subscriptions" config section
+static const size_t DEFAULT_MAX_SUBSCRIPTIONS = 1024;
+static const size_t DEFAULT_SUBSCRIPTION_TTL = 600; // seconds
+// freshness of the reply to a subscription, which carries the next sequence number
+static const uint64_t SUBSCRIPTION_FRESHNESS = 1000; // ms
+// freshness of a notification, a sequence number is never reused within a stream
+static const uint64_t NOTIFICATION_FRESHNESS = 10000; // ms
+
+// defaults of the lazy segment generation, enabled by the "cursors" config section
+static const size_t DEFAULT_CURSOR_PREFETCH = 4;
+static const size_t DEFAULT_CURSOR_BATCH_SIZE = 500;
+static const size_t DEFAULT_CURSOR_TTL = 60; // seconds
+static const size_t DEFAULT_CURSOR_MEMORY_LIMIT = 64; // MB
+
+// freshness of the filters menu segments, a version never changes once it is published
+static const uint64_t FILTERS_MENU_FRESHNESS = 3600000; // ms
+// freshness of /<prefix>/filters-initialization/latest and of the unversioned segments
+static const uint64_t FILTERS_MENU_LATEST_FRESHNESS = 1000; // ms
 
 /**
  * QueryAdapter handles the Query usecases for the catalog
@@ -93,6 +163,17 @@ public:
                 const std::vector<std::string>& nameFields,
                 const std::string& databaseTable);
 
+  /**
+   * Apply publication changes to the in-memory index or filters menu, and invalidate the
+   * query results they change, see PublishAdapter::addUpdateListener
+   *
+   * @param added:   names of the data added to the catalog
+   * @param removed: names of the data removed from the catalog
+   */
+  void
+  onPublicationUpdate(const std::vector<std::string>& added,
+                      const std::vector<std::string>& removed);
+
 protected:
   /**
    * Helper function for configuration parsing
@@ -114,20 +195,101 @@ protected:
   onIncomingQueryInterest(const ndn::InterestFilter& filter, const ndn::Interest& interest);
 
   /**
-   * Handles requests for responses to an filter initialization request
+   * Handles requests for responses to an filter initialization request. The menu is served
+   * from memory, a missing or stale one is rebuilt in the background.
    *
    * @param interest: Interest that needs to be handled
    */
   virtual void
-  onFiltersInitializationInterest(std::shared_ptr<const ndn::Interest> interest);
+  onFiltersInitializationInterest(const ndn::Interest& interest);
 
   /**
-   * Helper function that generates query results from a Json query carried in the Interest
+   * Handles requests for the adapter counters, the reply carries a Json object
    *
-   * @param interest:  Interest that needs to be handled
+   * @param interest: Interest that needs to be handled
+   */
+  void
+  onStatusInterest(const ndn::Interest& interest);
+
+  /**
+   * Handles standing queries. /<prefix>/subscribe/<query-params> registers or refreshes the
+   * query and is answered with the name of its notification stream and the next sequence
+   * number. The Interest for <stream>/<sequence> is answered once a publication changes the
+   * results of the query.
+   *
+   * @param interest: Interest that needs to be handled
+   */
+  void
+  onSubscriptionInterest(const ndn::Interest& interest);
+
+  /**
+   * Helper function that collects the adapter counters
+   */
+  virtual void
+  getStatus(Json::Value& status);
+
+  /**
+   * Helper function that adds the counters of the DatabaseHandler to the status
+   */
+  void
+  getDatabaseHandlerStatus(Json::Value& status);
+
+  /**
+   * Helper function that hands a query task to the worker pool
+   *
+   * @param task:     the task to run
+   * @param interest: Interest that triggered the task, used for logging only
+   * @return false if the task is rejected because the queue is full
+   */
+  bool
+  dispatchQuery(const util::WorkerPool::Task& task, const ndn::Interest& interest);
+
+  /**
+   * Helper function that hands a build of the filters menu to the worker pool, unless the
+   * menu of this version exists or a build is running
+   *
+   * @param version: the ChronoSync digest the menu is built for
+   */
+  void
+  scheduleFiltersMenuBuild(const std::string& version);
+
+  /**
+   * Helper function that encodes and signs the filters menu of a version, then makes it the
+   * current one
+   *
+   * @param version: the ChronoSync digest the menu is built for
+   */
+  void
+  populateFiltersMenu(const std::string& version);
+
+  /**
+   * Helper function that cuts the encoded filters menu into signed segments
+   *
+   * @param segmentPrefix: Name of the segments without the segment number
+   * @param menu:          the encoded menu
+   * @param freshness:     freshness period of the segments in milliseconds
+   * @param segments:      receives the segments in order
+   */
+  void
+  encodeFiltersMenu(const ndn::Name& segmentPrefix, const std::string& menu, uint64_t freshness,
+                    std::vector<std::shared_ptr<ndn::Data>>& segments);
+
+  /**
+   * Helper function that finds the Data of the filters menu that answers the Interest,
+   * must be called with m_mutex held
+   *
+   * @param name: Name of the Interest
+   * @return the Data, or nullptr if no menu holds it
+   */
+  std::shared_ptr<ndn::Data>
+  findFiltersMenuData(const ndn::Name& name) const;
+
+  /**
+   * Helper function that reads the distinct values of the filter categories in one pass over
+   * the table, so that the filters menu can be kept in memory
    */
   void
-  populateFiltersMenu(std::shared_ptr<const ndn::Interest> interest);
+  loadFilterValues();
 
   void
   getFiltersMenu(Json::Value& value);
@@ -158,6 +320,245 @@ protected:
                 uint64_t viewEnd,
                 bool lastComponent);
 
+  /**
+   * Helper function that makes query-results data from an already encoded Json array
+   *
+   * @param encodedValue: the Json array as produced by util::SegmentEncoder, the other
+   *                      parameters are the same as above
+   */
+  std::shared_ptr<ndn::Data>
+  makeReplyData(const ndn::Name& segmentPrefix,
+                const std::string& encodedValue,
+                uint64_t segmentNo,
+                bool isFinalBlock,
+                bool isAutocomplete,
+                uint64_t resultCount,
+                uint64_t viewStart,
+                uint64_t viewEnd,
+                bool lastComponent);
+
+  /**
+   * How the results of filter and prefix queries are written, chosen by the "encoding" key of
+   * the query: "json" (default), or "tlv" for the binary encoding of util/result-tlv.hpp
+   */
+  enum ResultEncoding {
+    RESULT_ENCODING_JSON,
+    RESULT_ENCODING_TLV
+  };
+
+  /**
+   * Helper function that makes unsigned query-results data, the parameters are the same as
+   * above. The data is signed by publishSegment.
+   *
+   * @param encoding: the encoding of encodedValue, a Json array or Result TLV elements
+   */
+  std::shared_ptr<ndn::Data>
+  encodeReplyData(const ndn::Name& segmentPrefix,
+                  const std::string& encodedValue,
+                  uint64_t segmentNo,
+                  bool isFinalBlock,
+                  bool isAutocomplete,
+                  uint64_t resultCount,
+                  uint64_t viewStart,
+                  uint64_t viewEnd,
+                  bool lastComponent,
+                  ResultEncoding encoding = RESULT_ENCODING_JSON);
+
+  /**
+   * Helper function that writes the Json content of query-results data
+   *
+   * @param content:      string to save the content, previous content is discarded
+   * @param encodedValue: the encoded Json array of the results
+   */
+  static void
+  encodeReplyContent(std::string& content,
+                     const std::string& encodedValue,
+                     bool isAutocomplete,
+                     uint64_t resultCount,
+                     uint64_t viewStart,
+                     uint64_t viewEnd,
+                     bool lastComponent);
+
+  /**
+   * Helper function that gets the number of bytes the results array can take in a segment
+   *
+   * @param segmentPrefix:    the data name without the segment component
+   * @param hasReplyEnvelope: whether the payload is wrapped by encodeReplyContent
+   */
+  size_t
+  getSegmentPayloadLimit(const ndn::Name& segmentPrefix, bool hasReplyEnvelope);
+
+  /**
+   * Helper function that creates the payload budget for m_maxPacketSize and the signing identity
+   */
+  void
+  resetPayloadBudget();
+
+  /**
+   * Helper function that creates the dispatcher that puts the packets to m_face
+   *
+   * @param queueLimit: the number of packets that can wait for the thread of m_face
+   */
+  void
+  resetFaceDispatcher(size_t queueLimit);
+
+  /**
+   * Helper function that encodes one query result as a Json object
+   *
+   * @param entry:       string to save the encoded entry, previous content is discarded
+   * @param name:        the name (or name component for autocompletion), may be NULL
+   * @param hasMetadata: the has_metadata flag of the record
+   */
+  static void
+  encodeResultEntry(std::string& entry, const char* name, int hasMetadata);
+
+  /**
+   * Helper function that encodes one query result as a Json object or a Result TLV element
+   */
+  static void
+  encodeResultEntry(std::string& entry, const char* name, int hasMetadata,
+                    ResultEncoding encoding);
+
+  /**
+   * Helper function that stores the data in the cache and hands it to the face thread, which
+   * sends it out. Can be called from any thread.
+   *
+   * @param data:        the signed packet
+   * @param packetClass: autocompletion answers are cached apart from the other packets
+   */
+  void
+  cacheAndPut(const std::shared_ptr<const ndn::Data>& data,
+              util::SigningPolicy::PacketClass packetClass);
+
+  /**
+   * Helper function that appends a query-results packet to the segment store, if any
+   */
+  void
+  storeSegment(const ndn::Data& data, util::ContentCache::Partition partition);
+
+  /**
+   * Helper function that makes the version current in the segment store. The stored packets
+   * of this version are loaded into the cache, those of another version are discarded.
+   *
+   * @param version: the ChronoSync digest
+   */
+  void
+  switchSegmentStoreVersion(const std::string& version);
+
+  /**
+   * Helper function that signs a query-results segment, then stores it in the cache and sends
+   * it out. With the signing pipeline, this is done on a signing thread and the function
+   * returns once the segment is queued.
+   *
+   * @param data:        the unsigned segment
+   * @param packetClass: PACKET_AUTOCOMPLETE or PACKET_RESULTS, selects the signing method
+   * @param manifest:    the manifest of the result, or nullptr to sign the segment on its own.
+   *                     With a manifest, the segment gets a digest signature and the manifest
+   *                     is published after the final segment.
+   */
+  void
+  publishSegment(const std::shared_ptr<ndn::Data>& data,
+                 util::SigningPolicy::PacketClass packetClass,
+                 const std::shared_ptr<util::SegmentManifest>& manifest);
+
+  /**
+   * Helper function that starts the manifest of a multi-segment result
+   *
+   * @return nullptr if the segments are signed one by one
+   */
+  std::shared_ptr<util::SegmentManifest>
+  makeSegmentManifest() const;
+
+  /**
+   * Helper function that signs and publishes the manifest of a result as
+   * <segmentPrefix>/manifest, its content is a Json object with the number of segments and
+   * the hex-encoded Merkle root of their implicit digests
+   */
+  void
+  publishManifest(const ndn::Name& segmentPrefix, const util::SegmentManifest& manifest,
+                  util::SigningPolicy::PacketClass packetClass);
+
+  /**
+   * Helper function that replaces the query-params of /<prefix>/query/<query-params>/... with
+   * their canonical form, under which equivalent queries are run, coalesced and cached once
+   *
+   * @return the name itself if the query has no canonical form, or if the canonical name is
+   *         so much shorter that the packets renamed to the original one would not fit
+   */
+  ndn::Name
+  getCanonicalQueryName(const ndn::Name& name) const;
+
+  /**
+   * Helper function that answers the Interest of an equivalent query with a copy of the cached
+   * packet of the canonical query, which is renamed to the Interest, signed and cached under
+   * the new name. A copy is only made once: later Interests get the cached copy, and those
+   * that arrive while it is signed get it when it is put.
+   *
+   * @param interest:      the Interest as it was received
+   * @param canonicalName: the canonical name of the Interest
+   * @return whether the copy or the packet of the canonical query was found
+   */
+  bool
+  answerFromCanonicalQuery(const ndn::Interest& interest, const ndn::Name& canonicalName);
+
+  /**
+   * Helper function that answers an Interest for /<prefix>/query/<query-params> with the
+   * latest results of the query that no publication has changed since
+   *
+   * @return whether the Interest was answered
+   */
+  bool
+  answerWithLatestResults(const ndn::Interest& interest, const ndn::Name& canonicalName);
+
+  /**
+   * Helper function that answers an Interest for /<prefix>/query/<query-params> with the
+   * results of the given version, if they are cached
+   */
+  bool
+  answerWithVersion(const ndn::Interest& interest, const ndn::Name& canonicalName,
+                    const ndn::Name::Component& version);
+
+  /**
+   * Helper function that gets the conditions on the name fields that the results of a query
+   * depend on
+   *
+   * @param typedComponents: the name fields and values of the query
+   */
+  util::ResultDependencies::Predicate
+  makeResultPredicate(const std::vector<std::pair<std::string, std::string>>& typedComponents) const;
+
+  /**
+   * Helper function that keeps the added and removed catalog names for delta queries, and
+   * invalidates the query results that depend on them
+   */
+  void
+  recordPublicationChanges(const std::vector<std::string>& added,
+                           const std::vector<std::string>& removed);
+
+  /**
+   * Helper function that publishes a notification for every standing query whose results
+   * are changed by the added or removed catalog names
+   */
+  void
+  publishNotifications(const std::vector<std::string>& added,
+                       const std::vector<std::string>& removed);
+
+  /**
+   * Helper function that encodes a notification of a standing query. The changed names are
+   * listed as in delta queries; if they do not fit in one packet, the notification only
+   * carries their number and "truncated": true, and the consumer runs the query again.
+   *
+   * @param content:      string to save the encoded notification
+   * @param sequence:     the sequence number of the notification
+   * @param changes:      the changes of the publication batch
+   * @param indices:      the indices of the changes that match the query
+   * @param payloadLimit: the maximum size of the content
+   */
+  static void
+  encodeNotification(std::string& content, uint64_t sequence,
+                     const std::vector<util::ChangeLog::Change>& changes,
+                     const std::vector<size_t>& indices, size_t payloadLimit);
+
   /**
    * Helper function that generates query results from a Json query carried in the Interest
    *
@@ -185,11 +586,34 @@ protected:
   sendNack(const ndn::Name& dataPrefix);
 
   /**
-   * Helper function that signs the data
+   * Helper function that signs the data with the key of the signing identity
    */
   void
   signData(ndn::Data& data);
 
+  /**
+   * Helper function that returns the certificate signData uses, it is looked up in the
+   * KeyChain when the first packet is signed, and again only when the signing identity
+   * changes or refreshSigningCertName is called
+   */
+  ndn::Name
+  getSigningCertName();
+
+  /**
+   * Helper function that looks up the default certificate of the signing identity again,
+   * m_signingId must not be empty
+   *
+   * @return the new certificate name
+   */
+  ndn::Name
+  refreshSigningCertName();
+
+  /**
+   * Helper function that signs the data as the signing policy says for its class
+   */
+  void
+  signData(ndn::Data& data, util::SigningPolicy::PacketClass packetClass);
+
   /**
    * Helper function that publishes query-results data segments
    */
@@ -199,16 +623,144 @@ protected:
                              bool lastComponent,
                              const std::string& nameField);
 
+  /**
+   * Helper function that publishes the segments of a filter or prefix query
+   *
+   * @param queryParams:   the name fields and values of the query
+   * @param segmentPrefix: the name of the query results without the segment component
+   * @param encoding:      how the results are written, as the query asks
+   */
   virtual void
   prepareSegmentsByParams(std::vector<std::pair<std::string, std::string>>& queryParams,
-                          const ndn::Name& segmentPrefix);
+                          const ndn::Name& segmentPrefix,
+                          ResultEncoding encoding);
+
+  /**
+   * Helper function that publishes the segments of an autocompletion query
+   *
+   * @param segmentPrefix:   the name of the query results without the segment component
+   * @param typedComponents: the name fields typed so far and their values
+   * @param lastComponent:   whether nameField is the last name field
+   * @param nameField:       the name field to complete
+   */
+  virtual void
+  prepareSegmentsByAutocompletion(const ndn::Name& segmentPrefix,
+                                  const std::vector<std::pair<std::string, std::string>>& typedComponents,
+                                  bool lastComponent,
+                                  const std::string& nameField);
+
+  /**
+   * Helper function that publishes the segments of a delta query: the names that were added
+   * to or removed from the results of the query since the given version. Added names are
+   * result entries as usual, removed ones are {"name": <name>, "removed": true}.
+   *
+   * @param segmentPrefix: the name of the query results without the segment component
+   * @param queryParams:   the name fields and values of the query
+   * @param since:         the version of the results the consumer has
+   * @param encoding:      how the results are written, as the query asks
+   * @return false if the changes since the version are not kept, the consumer then needs
+   *         the full results
+   */
+  bool
+  prepareSegmentsByChanges(const ndn::Name& segmentPrefix,
+                           const std::vector<std::pair<std::string, std::string>>& queryParams,
+                           const std::string& since,
+                           ResultEncoding encoding);
+
+  /**
+   * Helper function that opens a cursor over the query results and produces the first
+   * segments, the rest are produced when their Interests arrive
+   *
+   * @param queryParams:   the query, as for prepareSegmentsByParams
+   * @param segmentPrefix: the name of the query results without the segment component
+   * @param encoding:      how the results are written, as the query asks
+   * @param resultCount:   the number of query results, or an estimate if
+   *                       m_isResultCountEstimated
+   * @param lastRecordId:  the largest record id when the results are counted, later records
+   *                       are not part of the results
+   */
+  void
+  openResultCursor(const std::vector<std::pair<std::string, std::string>>& queryParams,
+                   const ndn::Name& segmentPrefix,
+                   ResultEncoding encoding,
+                   uint64_t resultCount,
+                   uint64_t lastRecordId);
+
+  /**
+   * Helper function that estimates the number of results of a filter or prefix query from
+   * the query plan, without scanning the table
+   */
+  uint64_t
+  estimateResultCount(util::StatementCache::Lease& lease,
+                      const std::vector<std::pair<std::string, std::string>>& queryParams);
+
+  /**
+   * Helper function that reads the largest record id, 0 if the table is empty
+   *
+   * @return false if the id cannot be read
+   */
+  bool
+  readLastRecordId(util::StatementCache::Lease& lease, uint64_t& lastRecordId);
+
+  /**
+   * Helper function that gets the resultCount of a segment when the count is estimated: the
+   * final segment has the exact count, the others claim more results than they have seen, so
+   * that the consumer keeps fetching
+   *
+   * @param estimate: the estimated number of results
+   * @param payload:  the Json array of the segment
+   * @param viewEnd:  index of the last result in the segment
+   * @param isFinal:  whether this is the last segment
+   */
+  static uint64_t
+  getEstimatedResultCount(uint64_t estimate,
+                          const std::string& payload,
+                          uint64_t viewEnd,
+                          bool isFinal);
+
+  /**
+   * Helper function that reads a batch of query results in id order, see
+   * util::ResultCursor::RowFetcher
+   */
+  bool
+  fetchResultRows(const std::vector<std::pair<std::string, std::string>>& queryParams,
+                  ResultEncoding encoding,
+                  uint64_t afterId,
+                  uint64_t upToId,
+                  size_t limit,
+                  std::vector<std::string>& entries,
+                  uint64_t& lastId);
+
+  /**
+   * Helper function that produces the segments of a cursor up to segmentNo
+   */
+  void
+  advanceResultCursor(std::shared_ptr<util::ResultCursor> cursor, uint64_t segmentNo);
+
+  /**
+   * Helper function that sets the name field parameters of a filter or prefix query statement
+   *
+   * @param statement:   statement prepared from one of the *ByParamsSql strings
+   * @param queryParams: the name fields given by the query, the others match anything
+   */
+  void
+  bindQueryParams(PreparedStatement_T statement,
+                  const std::vector<std::pair<std::string, std::string>>& queryParams);
+
+  /**
+   * Helper function that builds the SQL strings of filter and prefix queries, which only depend
+   * on the table and the name fields
+   */
+  void
+  setParamsSql();
 
   void
   generateSegments(ResultSet_T& res,
                    const ndn::Name& segmentPrefix,
-                   int resultCount,
+                   uint64_t resultCount,
                    bool autocomplete,
-                   bool lastComponent);
+                   bool lastComponent,
+                   ResultEncoding encoding);
 
   /**
    * Helper function to set the DatabaseHandler
@@ -216,6 +768,25 @@ protected:
   void
   setDatabaseHandler(const util::ConnectionDetails&  databaseId);
 
+  /**
+   * Called with the name, the name field values and the has_metadata flag of a publication
+   */
+  typedef std::function<void(const std::string& name,
+                             const std::vector<std::string>& fieldValues,
+                             bool hasMetadata)> CatalogRecordCallback;
+
+  /**
+   * Helper function that reads all publications of the database, the catalog index is loaded
+   * from them
+   *
+   * @param databaseId: the database to read
+   * @param onRecord:   called for every publication, in id order
+   * @throw Error if the publications cannot all be read
+   */
+  virtual void
+  readCatalogRecords(const util::ConnectionDetails& databaseId,
+                     const CatalogRecordCallback& onRecord);
+
   void
   closeDatabaseHandler();
 
@@ -228,6 +799,32 @@ protected:
   void
   setCatalogId();
 
+  /**
+   * Helper function that uses the digest of the signing key as the catalog ID
+   */
+  void
+  setCatalogIdFromSigningKey();
+
+  /**
+   * Helper function that parses an autocompletion query
+   * @param jsonValue:       Json value that contains the query information
+   * @param typedComponents: vector to save the name fields typed so far and their values
+   * @param lastComponent:   Flag to mark the last component query
+   * @param nameField:       string to save the name field to complete
+   */
+  bool
+  doAutocompletionSearch(Json::Value& jsonValue,
+                         std::vector<std::pair<std::string, std::string>>& typedComponents,
+                         bool& lastComponent,
+                         std::string& nameField);
+
+  /**
+   * Helper function that generates the WHERE clause of an autocompletion query
+   */
+  void
+  autocompletion2Sql(std::stringstream& sqlQuery,
+                     const std::vector<std::pair<std::string, std::string>>& typedComponents);
+
   /**
    * Helper function that generates the sqlQuery string for autocomplete query
    * @param sqlQuery:      stringstream to save the sqlQuery string
@@ -253,11 +850,41 @@ protected:
   getQueryResultsName(std::shared_ptr<const ndn::Interest> interest,
                       const ndn::Name::Component& version);
 
+  /**
+   * Helper function that returns the current ChronoSync state digest, which is used as the
+   * version of the query results and of the filters menu. The filters menu is rebuilt when
+   * the digest changes.
+   */
   std::string
   getChronoSyncDigest();
 
+  /**
+   * Helper function that runs a query and then answers the Interests that were attached to
+   * it while it was running
+   *
+   * @param interest: Interest that started the query
+   * @param queryKey: key of the query in the in-flight table
+   */
+  void
+  runInFlightQuery(std::shared_ptr<const ndn::Interest> interest, const ndn::Name& queryKey);
+
 protected:
   typedef std::unordered_map<ndn::Name, const ndn::RegisteredPrefixId*> RegisteredPrefixList;
+
+  // the filters menu of one version, encoded and signed once
+  struct FiltersMenu
+  {
+    std::string version;
+    // /<prefix>/filters-initialization/<version>
+    ndn::Name name;
+    // /<prefix>/filters-initialization/latest, carries the name of the versioned segments
+    std::shared_ptr<ndn::Data> latest;
+    // /<prefix>/filters-initialization/<version>/<seg>
+    std::vector<std::shared_ptr<ndn::Data>> segments;
+    // /<prefix>/filters-initialization/<seg>, for consumers that do not ask for "latest"
+    std::vector<std::shared_ptr<ndn::Data>> unversionedSegments;
+  };
+
   // Handle to the Catalog's database
   std::shared_ptr<DatabaseHandler> m_dbConnPool;
   const std::shared_ptr<chronosync::Socket>& m_socket;
@@ -265,14 +892,102 @@ protected:
   // mutex to control critical sections
   std::mutex m_mutex;
   // @{ needs m_mutex protection
-  // The Queries we are currently writing to
-  ndn::util::InMemoryStorageLru m_activeQueryToFirstResponse;
-  ndn::util::InMemoryStorageLru m_cache;
   std::string m_chronosyncDigest;
+  // Queries being executed, keyed by /<prefix>/query/<query-params>/<version>, with the
+  // Interests that arrived while they run
+  std::map<ndn::Name, std::vector<std::shared_ptr<const ndn::Interest>>> m_inFlightQueries;
+  uint64_t m_nCoalescedQueries;
+  // names of the copies of canonical query packets that are being signed
+  std::set<ndn::Name> m_canonicalCopiesBeingSigned;
+  // time spent by the queries in the database and the encoding, and then in waiting for the
+  // signing pipeline to sign their segments
+  uint64_t m_nQueries;
+  uint64_t m_totalQueryMicroseconds;
+  uint64_t m_totalSigningWaitMicroseconds;
+  // the current filters menu, the one of the previous version for the consumers that are
+  // still fetching it, and the version being built, empty if no build is running
+  std::shared_ptr<const FiltersMenu> m_filtersMenu;
+  std::shared_ptr<const FiltersMenu> m_previousFiltersMenu;
+  std::string m_filtersMenuBuildVersion;
+  uint64_t m_nFiltersMenuBuilds;
   // @}
   RegisteredPrefixList m_registeredPrefixList;
   ndn::Name m_catalogId; // should be replaced with the PK digest
   std::vector<std::string> m_filterCategoryNames;
+
+  // threads that run the queries, created when the adapter is configured
+  std::unique_ptr<util::WorkerPool> m_workerPool;
+  size_t m_nQueryThreads;
+  size_t m_maxQueuedQueries;
+
+  // threads that sign the query results, nullptr if the query threads sign them
+  std::unique_ptr<util::SigningPipeline> m_signingPipeline;
+  size_t m_nSigningThreads;
+  size_t m_maxQueuedSegments;
+  // sign the query results with digests and one signed manifest per result
+  bool m_isManifestSigned;
+  // how ACKs, NACKs and the query results are signed
+  util::SigningPolicy m_signingPolicy;
+
+  // hands the Data made on the query and signing threads to the thread of m_face, which is
+  // not thread-safe
+  std::shared_ptr<util::FaceDispatcher> m_faceDispatcher;
+
+  std::mutex m_signingCertMutex;
+  // @{ needs m_signingCertMutex protection
+  // the default certificate of m_signingCertIdentity, looked up once instead of per packet
+  ndn::Name m_signingCertName;
+  ndn::Name m_signingCertIdentity;
+  // @}
+
+  // content size of the segments, derived from the signed packet overhead
+  std::unique_ptr<util::PayloadBudget> m_payloadBudget;
+  size_t m_maxPacketSize;
+
+  // prepared statements of the query threads, and the SQL strings they are prepared from
+  std::unique_ptr<util::StatementCache> m_statementCache;
+  std::string m_recordNumByParamsSql;
+  std::string m_recordNumUpToIdByParamsSql;
+  std::string m_nameListByParamsSql;
+  std::string m_explainNameListByParamsSql;
+  std::string m_nameListAfterIdByParamsSql;
+  std::string m_lastRecordIdSql;
+
+  // take the result count from the listing instead of running a count query first
+  bool m_isResultCountEstimated;
+
+  // values of the filter categories with their record counts, nullptr if the menu is read from
+  // the database, and the position of every category in the name
+  std::unique_ptr<index::DistinctValues> m_filterValues;
+  std::vector<size_t> m_filterCategoryFields;
+
+  // ACKs, NACKs and query results, sharded by /<prefix>/query/<query-params> once configured
+  std::unique_ptr<util::ContentCache> m_cache;
+  size_t m_cacheMemoryLimit;
+  size_t m_cacheAutocompleteMemoryLimit;
+  size_t m_nCacheShards;
+
+  // the query results of the current version on disk, nullptr if they are not kept
+  std::unique_ptr<util::SegmentStore> m_segmentStore;
+  std::atomic<uint64_t> m_nStoredSegmentsLoaded;
+
+  // packets of canonical queries that were renamed to the equivalent queries they answer
+  std::atomic<uint64_t> m_nCanonicalQueryCopies;
+
+  // the version of the latest results of every query and the field values they depend on, so
+  // that publications only invalidate the results they change
+  std::unique_ptr<util::ResultDependencies> m_resultDependencies;
+
+  // the latest publication changes, from which delta queries are answered
+  std::unique_ptr<util::ChangeLog> m_changeLog;
+
+  // the standing queries, which are notified of the publications that change their results
+  std::unique_ptr<util::SubscriptionTable> m_subscriptions;
+
+  // open cursors of lazily produced query results, nullptr if all segments are produced at once
+  std::unique_ptr<util::ResultCursorTable> m_cursors;
+  size_t m_cursorPrefetch;
+  size_t m_cursorBatchSize;
 };
 
 template <typename DatabaseHandler>
@@ -281,11 +996,39 @@ QueryAdapter<DatabaseHandler>::QueryAdapter(const std::shared_ptr<ndn::Face>& fa
                                             const std::shared_ptr<chronosync::Socket>& syncSocket)
   : util::CatalogAdapter(face, keyChain)
   , m_socket(syncSocket)
-  , m_activeQueryToFirstResponse(100000)
-  , m_cache(250000)
   , m_chronosyncDigest("0")
+  , m_nCoalescedQueries(0)
+  , m_nQueries(0)
+  , m_totalQueryMicroseconds(0)
+  , m_totalSigningWaitMicroseconds(0)
+  , m_nFiltersMenuBuilds(0)
   , m_catalogId("catalogIdPlaceHolder") // initialize for unitests
+  , m_nQueryThreads(DEFAULT_QUERY_THREADS)
+  , m_maxQueuedQueries(DEFAULT_QUERY_QUEUE_LENGTH)
+  , m_nSigningThreads(DEFAULT_SIGNING_THREADS)
+  , m_maxQueuedSegments(DEFAULT_SIGNING_QUEUE_LENGTH)
+  , m_isManifestSigned(false)
+  , m_signingPolicy(*keyChain)
+  , m_maxPacketSize(ndn::MAX_NDN_PACKET_SIZE)
+  , m_isResultCountEstimated(false)
+  // a single shard until the prefix is known
+  , m_cache(new util::ContentCache(DEFAULT_CACHE_MEMORY_LIMIT * 1024 * 1024,
+                                   DEFAULT_CACHE_AUTOCOMPLETE_MEMORY_LIMIT * 1024 * 1024, 1, 0))
+  , m_cacheMemoryLimit(DEFAULT_CACHE_MEMORY_LIMIT)
+  , m_cacheAutocompleteMemoryLimit(DEFAULT_CACHE_AUTOCOMPLETE_MEMORY_LIMIT)
+  , m_nCacheShards(DEFAULT_CACHE_SHARDS)
+  , m_nStoredSegmentsLoaded(0)
+  , m_nCanonicalQueryCopies(0)
+  , m_resultDependencies(new util::ResultDependencies(MAX_TRACKED_QUERY_RESULTS))
+  , m_changeLog(new util::ChangeLog(DEFAULT_CHANGE_LOG_SIZE))
+  , m_subscriptions(new util::SubscriptionTable(DEFAULT_MAX_SUBSCRIPTIONS,
+                                                std::chrono::seconds(DEFAULT_SUBSCRIPTION_TTL)))
+  , m_cursorPrefetch(DEFAULT_CURSOR_PREFETCH)
+  , m_cursorBatchSize(DEFAULT_CURSOR_BATCH_SIZE)
 {
+  resetFaceDispatcher(DEFAULT_DISPATCHER_QUEUE_LENGTH);
+  m_changeLog->markVersion(m_chronosyncDigest);
+  resetPayloadBudget();
 }
 
 template <typename DatabaseHandler>
@@ -326,6 +1069,11 @@ QueryAdapter<DatabaseHandler>::onConfig(const util::ConfigSection& section,
     return;
   }
   std::string signingId, dbServer, dbName, dbUser, dbPasswd;
+  std::string storePath;
+  size_t storeSize = DEFAULT_STORE_SIZE;
+  size_t changeLogSize = DEFAULT_CHANGE_LOG_SIZE;
+  size_t maxSubscriptions = DEFAULT_MAX_SUBSCRIPTIONS;
+  size_t subscriptionTtl = DEFAULT_SUBSCRIPTION_TTL;
   for (auto item = section.begin();
        item != section.end();
        ++item)
@@ -337,8 +1085,28 @@ QueryAdapter<DatabaseHandler>::onConfig(const util::ConfigSection& section,
                     " in \"query\" section");
       }
     }
-    if (item->first == "filterCategoryNames") {
-      std::istringstream ss(item->second.get_value<std::string>());
+    if (item->first == "maxPacketSize") {
+      m_maxPacketSize = item->second.get_value<size_t>();
+      if (m_maxPacketSize == 0 || m_maxPacketSize > ndn::MAX_NDN_PACKET_SIZE) {
+        throw Error("Invalid value for \"maxPacketSize\""
+                    " in \"query\" section");
+      }
+    }
+    if (item->first == "resultCount") {
+      std::string resultCount = item->second.get_value<std::string>();
+      if (resultCount == "exact") {
+        m_isResultCountEstimated = false;
+      }
+      else if (resultCount == "estimate") {
+        m_isResultCountEstimated = true;
+      }
+      else {
+        throw Error("Invalid value for \"resultCount\""
+                    " in \"query\" section");
+      }
+    }
+    if (item->first == "filterCategoryNames") {
+      std::istringstream ss(item->second.get_value<std::string>());
       std::string token;
       while(std::getline(ss, token, ',')) {
         m_filterCategoryNames.push_back(token);
@@ -381,6 +1149,210 @@ QueryAdapter<DatabaseHandler>::onConfig(const util::ConfigSection& section,
                     " in \"query\" section");
       }
     }
+    if (item->first == "workers") {
+      const util::ConfigSection& workersSection = item->second;
+      for (auto subItem = workersSection.begin();
+           subItem != workersSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "threads") {
+          m_nQueryThreads = subItem->second.get_value<size_t>();
+        }
+        if (subItem->first == "queueLength") {
+          m_maxQueuedQueries = subItem->second.get_value<size_t>();
+        }
+      }
+
+      if (m_nQueryThreads == 0) {
+        throw Error("Invalid value for \"threads\""
+                    " in \"query\\workers\" section");
+      }
+    }
+    if (item->first == "signing") {
+      const util::ConfigSection& signingSection = item->second;
+      for (auto subItem = signingSection.begin();
+           subItem != signingSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "threads") {
+          m_nSigningThreads = subItem->second.get_value<size_t>();
+        }
+        if (subItem->first == "queueLength") {
+          m_maxQueuedSegments = subItem->second.get_value<size_t>();
+        }
+        util::SigningPolicy::PacketClass packetClass;
+        if (util::SigningPolicy::parsePacketClass(subItem->first, packetClass)) {
+          util::SigningPolicy::Method method;
+          if (!util::SigningPolicy::parseMethod(subItem->second.get_value<std::string>(),
+                                                method)) {
+            throw Error("Invalid value for \"" + subItem->first + "\""
+                        " in \"query\\signing\" section");
+          }
+          m_signingPolicy.setMethod(packetClass, method);
+        }
+        if (subItem->first == "manifest") {
+          std::string manifest = subItem->second.get_value<std::string>();
+          if (manifest == "yes") {
+            m_isManifestSigned = true;
+          }
+          else if (manifest == "no") {
+            m_isManifestSigned = false;
+          }
+          else {
+            throw Error("Invalid value for \"manifest\""
+                        " in \"query\\signing\" section");
+          }
+        }
+      }
+
+      if (m_nSigningThreads > 0 && m_maxQueuedSegments == 0) {
+        throw Error("Invalid value for \"queueLength\""
+                    " in \"query\\signing\" section");
+      }
+    }
+    if (item->first == "dispatcher") {
+      const util::ConfigSection& dispatcherSection = item->second;
+      size_t queueLength = DEFAULT_DISPATCHER_QUEUE_LENGTH;
+      for (auto subItem = dispatcherSection.begin();
+           subItem != dispatcherSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "queueLength") {
+          queueLength = subItem->second.get_value<size_t>();
+        }
+      }
+
+      if (queueLength == 0) {
+        throw Error("Invalid value for \"queueLength\""
+                    " in \"query\\dispatcher\" section");
+      }
+      resetFaceDispatcher(queueLength);
+    }
+    if (item->first == "cache") {
+      const util::ConfigSection& cacheSection = item->second;
+      for (auto subItem = cacheSection.begin();
+           subItem != cacheSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "memoryLimit") {
+          m_cacheMemoryLimit = subItem->second.get_value<size_t>();
+        }
+        if (subItem->first == "autocompleteMemoryLimit") {
+          m_cacheAutocompleteMemoryLimit = subItem->second.get_value<size_t>();
+        }
+        if (subItem->first == "shards") {
+          m_nCacheShards = subItem->second.get_value<size_t>();
+        }
+      }
+
+      if (m_cacheMemoryLimit == 0) {
+        throw Error("Invalid value for \"memoryLimit\""
+                    " in \"query\\cache\" section");
+      }
+      if (m_cacheAutocompleteMemoryLimit >= m_cacheMemoryLimit) {
+        throw Error("Invalid value for \"autocompleteMemoryLimit\""
+                    " in \"query\\cache\" section");
+      }
+      if (m_nCacheShards == 0) {
+        throw Error("Invalid value for \"shards\""
+                    " in \"query\\cache\" section");
+      }
+    }
+    if (item->first == "store") {
+      const util::ConfigSection& storeSection = item->second;
+      for (auto subItem = storeSection.begin();
+           subItem != storeSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "path") {
+          storePath = subItem->second.get_value<std::string>();
+        }
+        if (subItem->first == "size") {
+          storeSize = subItem->second.get_value<size_t>();
+        }
+      }
+
+      if (storePath.empty()) {
+        throw Error("Invalid value for \"path\""
+                    " in \"query\\store\" section");
+      }
+      if (storeSize == 0) {
+        throw Error("Invalid value for \"size\""
+                    " in \"query\\store\" section");
+      }
+    }
+    if (item->first == "changeLog") {
+      const util::ConfigSection& changeLogSection = item->second;
+      for (auto subItem = changeLogSection.begin();
+           subItem != changeLogSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "size") {
+          changeLogSize = subItem->second.get_value<size_t>();
+        }
+      }
+
+      if (changeLogSize == 0) {
+        throw Error("Invalid value for \"size\""
+                    " in \"query\\changeLog\" section");
+      }
+    }
+    if (item->first == "subscriptions") {
+      const util::ConfigSection& subscriptionsSection = item->second;
+      for (auto subItem = subscriptionsSection.begin();
+           subItem != subscriptionsSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "maxSubscriptions") {
+          maxSubscriptions = subItem->second.get_value<size_t>();
+        }
+        else if (subItem->first == "ttl") {
+          subscriptionTtl = subItem->second.get_value<size_t>();
+        }
+      }
+
+      if (maxSubscriptions == 0) {
+        throw Error("Invalid value for \"maxSubscriptions\""
+                    " in \"query\\subscriptions\" section");
+      }
+      if (subscriptionTtl == 0) {
+        throw Error("Invalid value for \"ttl\""
+                    " in \"query\\subscriptions\" section");
+      }
+    }
+    if (item->first == "cursors") {
+      const util::ConfigSection& cursorsSection = item->second;
+      size_t ttl = DEFAULT_CURSOR_TTL;
+      size_t memoryLimit = DEFAULT_CURSOR_MEMORY_LIMIT;
+      for (auto subItem = cursorsSection.begin();
+           subItem != cursorsSection.end();
+           ++subItem)
+      {
+        if (subItem->first == "prefetch") {
+          m_cursorPrefetch = subItem->second.get_value<size_t>();
+        }
+        if (subItem->first == "batchSize") {
+          m_cursorBatchSize = subItem->second.get_value<size_t>();
+        }
+        if (subItem->first == "ttl") {
+          ttl = subItem->second.get_value<size_t>();
+        }
+        if (subItem->first == "memoryLimit") {
+          memoryLimit = subItem->second.get_value<size_t>();
+        }
+      }
+
+      if (m_cursorBatchSize == 0) {
+        throw Error("Invalid value for \"batchSize\""
+                    " in \"query\\cursors\" section");
+      }
+      if (ttl == 0) {
+        throw Error("Invalid value for \"ttl\""
+                    " in \"query\\cursors\" section");
+      }
+      m_cursors.reset(new util::ResultCursorTable(std::chrono::seconds(ttl),
+                                                  memoryLimit * 1024 * 1024));
+    }
   }
 
   if (m_filterCategoryNames.empty()) {
@@ -388,12 +1360,50 @@ QueryAdapter<DatabaseHandler>::onConfig(const util::ConfigSection& section,
   }
 
   m_prefix = prefix;
+  // all packets of a query share /<prefix>/query/<query-params>, so they land in one shard
+  m_cache.reset(new util::ContentCache(m_cacheMemoryLimit * 1024 * 1024,
+                                       m_cacheAutocompleteMemoryLimit * 1024 * 1024,
+                                       m_nCacheShards, m_prefix.size() + 2));
+  m_changeLog.reset(new util::ChangeLog(changeLogSize));
+  m_subscriptions.reset(new util::SubscriptionTable(maxSubscriptions,
+                                                    std::chrono::seconds(subscriptionTtl)));
+  if (!storePath.empty()) {
+    try {
+      m_segmentStore.reset(new util::SegmentStore(storePath, storeSize * 1024 * 1024));
+    }
+    catch (const util::SegmentStore::Error& e) {
+      throw Error(e.what());
+    }
+  }
 
   m_signingId = ndn::Name(signingId);
   setCatalogId();
+  m_signingPolicy.setSigningId(m_signingId);
+  {
+    // the KeyChain may have changed since the last configuration, so the certificate is
+    // looked up again when the next packet is signed
+    std::lock_guard<std::mutex> lock(m_signingCertMutex);
+    m_signingCertName.clear();
+  }
+
+  // the signing identity may have changed, so the overhead is measured again. The key makes
+  // the largest signature of all signing methods, so segments signed otherwise fit as well
+  resetPayloadBudget();
 
   util::ConnectionDetails mysqlId(dbServer, dbUser, dbPasswd, dbName);
   setDatabaseHandler(mysqlId);
+  setParamsSql();
+
+  if (m_nSigningThreads > 0) {
+    m_signingPipeline.reset(new util::SigningPipeline(m_nSigningThreads, m_maxQueuedSegments));
+  }
+  m_workerPool.reset(new util::WorkerPool(m_nQueryThreads, m_maxQueuedQueries));
+
+  // the stored results are served right away if they were made for the current digest
+  const std::string version = getChronoSyncDigest();
+  m_changeLog->markVersion(version);
+  switchSegmentStoreVersion(version);
+  scheduleFiltersMenuBuild(version);
   setFilters();
 }
 
@@ -407,6 +1417,20 @@ QueryAdapter<DatabaseHandler>::setCatalogId()
 template <>
 void
 QueryAdapter<ConnectionPool_T>::setCatalogId()
+{
+  setCatalogIdFromSigningKey();
+}
+
+template <>
+void
+QueryAdapter<index::CatalogIndex>::setCatalogId()
+{
+  setCatalogIdFromSigningKey();
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::setCatalogIdFromSigningKey()
 {
   // use public key digest as the catalog ID
   ndn::Name keyId;
@@ -422,6 +1446,72 @@ QueryAdapter<ConnectionPool_T>::setCatalogId()
   m_catalogId.append(ndn::toHex(*keyDigest.getBuffer()));
 }
 
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::loadFilterValues()
+{
+}
+
+template <>
+void
+QueryAdapter<ConnectionPool_T>::loadFilterValues()
+{
+  // only the categories that are name fields can follow the publication changes
+  m_filterCategoryFields.clear();
+  for (const auto& category : m_filterCategoryNames) {
+    auto field = std::find(m_nameFields.begin(), m_nameFields.end(), category);
+    if (field == m_nameFields.end()) {
+      _LOG_DEBUG("Filter category " << category << " is not a name field, "
+                 "the filters menu is read from the database");
+      return;
+    }
+    m_filterCategoryFields.push_back(field - m_nameFields.begin());
+  }
+
+  Connection_T conn = ConnectionPool_getConnection(*m_dbConnPool);
+  if (!conn) {
+    _LOG_DEBUG("No available database connections");
+    return;
+  }
+
+  // one pass over the table, grouped so that only the distinct combinations are sent
+  std::string columns;
+  for (size_t i = 0; i < m_filterCategoryNames.size(); i++) {
+    if (i != 0) {
+      columns += ", ";
+    }
+    columns += m_filterCategoryNames[i];
+  }
+  std::string getFilterSql("SELECT " + columns + ", COUNT(*) FROM " + m_databaseTable +
+                           " GROUP BY " + columns + ";");
+
+  std::unique_ptr<index::DistinctValues> filterValues(
+    new index::DistinctValues(m_filterCategoryNames.size()));
+  bool isSuccess = true;
+  TRY {
+    ResultSet_T res4Filters = Connection_executeQuery(conn, reinterpret_cast<const char*>(getFilterSql.c_str()), getFilterSql.size());
+    std::vector<std::string> values(m_filterCategoryNames.size());
+    while (ResultSet_next(res4Filters)) {
+      for (size_t i = 0; i < values.size(); i++) {
+        const char* filterValue = ResultSet_getString(res4Filters, i + 1);
+        values[i].assign(filterValue != nullptr ? filterValue : "");
+      }
+      filterValues->add(values, ResultSet_getLLong(res4Filters, values.size() + 1));
+    }
+  }
+  CATCH(SQLException) {
+    _LOG_ERROR(Connection_getLastError(conn));
+    isSuccess = false;
+  }
+  END_TRY;
+
+  Connection_close(conn);
+
+  if (isSuccess) {
+    m_filterValues = std::move(filterValues);
+  }
+}
+
 template <typename DatabaseHandler>
 void
 QueryAdapter<DatabaseHandler>::setDatabaseHandler(const util::ConnectionDetails& databaseId)
@@ -434,6 +1524,237 @@ void
 QueryAdapter<ConnectionPool_T>::setDatabaseHandler(const util::ConnectionDetails& databaseId)
 {
   m_dbConnPool = zdbConnectionSetup(databaseId);
+  // every query thread keeps its connection with the statements prepared on it
+  m_statementCache.reset(new util::StatementCache(m_dbConnPool, m_nQueryThreads));
+  loadFilterValues();
+}
+
+template <>
+void
+QueryAdapter<index::CatalogIndex>::setDatabaseHandler(const util::ConnectionDetails& databaseId)
+{
+  // the database stays the durable store, the index is loaded from it once and then kept up to
+  // date by onPublicationUpdate. A partly loaded index would answer queries wrongly, so it is
+  // only used once all records are in
+  auto catalogIndex = std::make_shared<index::CatalogIndex>(m_nameFields);
+  readCatalogRecords(databaseId,
+                     [&catalogIndex] (const std::string& name,
+                                      const std::vector<std::string>& fieldValues,
+                                      bool hasMetadata) {
+                       catalogIndex->insert(name, fieldValues, hasMetadata);
+                     });
+  m_dbConnPool = catalogIndex;
+  _LOG_DEBUG("Loaded " << m_dbConnPool->size() << " records into the catalog index");
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::readCatalogRecords(const util::ConnectionDetails& databaseId,
+                                                  const CatalogRecordCallback& onRecord)
+{
+  std::shared_ptr<ConnectionPool_T> pool = zdbConnectionSetup(databaseId);
+  Connection_T conn = ConnectionPool_getConnection(*pool);
+  if (!conn) {
+    ConnectionPool_stop(*pool);
+    throw Error("Cannot load the catalog index: no available database connections");
+  }
+
+  std::string loadSql("SELECT name, has_metadata");
+  for (const auto& nameField : m_nameFields) {
+    loadSql += ", " + nameField;
+  }
+  loadSql += " FROM " + m_databaseTable + " ORDER BY id";
+
+  std::vector<std::string> fieldValues(m_nameFields.size());
+  bool isSuccess = true;
+  std::string lastError;
+  TRY {
+    ResultSet_T res4Records = Connection_executeQuery(conn, loadSql.c_str(), loadSql.size());
+    while (ResultSet_next(res4Records)) {
+      for (size_t i = 0; i < m_nameFields.size(); i++) {
+        const char* value = ResultSet_getString(res4Records, i + 3);
+        fieldValues[i].assign(value != nullptr ? value : "");
+      }
+      const char* name = ResultSet_getString(res4Records, 1);
+      onRecord(name != nullptr ? name : "", fieldValues, ResultSet_getInt(res4Records, 2) != 0);
+    }
+  }
+  CATCH(SQLException) {
+    const char* error = Connection_getLastError(conn);
+    lastError.assign(error != nullptr ? error : "");
+    isSuccess = false;
+  }
+  END_TRY;
+
+  // the error is thrown out of the TRY block, which must be left through END_TRY
+  Connection_close(conn);
+  ConnectionPool_stop(*pool);
+  if (!isSuccess) {
+    throw Error("Cannot load the catalog index: " + lastError);
+  }
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::onPublicationUpdate(const std::vector<std::string>& added,
+                                                   const std::vector<std::string>& removed)
+{
+  recordPublicationChanges(added, removed);
+}
+
+template <>
+void
+QueryAdapter<ConnectionPool_T>::onPublicationUpdate(const std::vector<std::string>& added,
+                                                    const std::vector<std::string>& removed)
+{
+  recordPublicationChanges(added, removed);
+
+  if (!m_filterValues) {
+    return;
+  }
+
+  std::vector<std::string> components;
+  std::vector<std::string> values(m_filterCategoryFields.size());
+  auto getValues = [&] (const std::string& name) {
+    if (!index::splitName(name, components) || components.size() != m_nameFields.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < m_filterCategoryFields.size(); i++) {
+      values[i] = components[m_filterCategoryFields[i]];
+    }
+    return true;
+  };
+
+  for (const auto& name : added) {
+    if (getValues(name)) {
+      m_filterValues->add(values);
+    }
+  }
+  for (const auto& name : removed) {
+    if (getValues(name)) {
+      m_filterValues->remove(values);
+    }
+  }
+}
+
+template <>
+void
+QueryAdapter<index::CatalogIndex>::onPublicationUpdate(const std::vector<std::string>& added,
+                                                       const std::vector<std::string>& removed)
+{
+  recordPublicationChanges(added, removed);
+
+  if (!m_dbConnPool) {
+    return;
+  }
+  for (const auto& name : added) {
+    if (!m_dbConnPool->insert(name, false)) {
+      _LOG_DEBUG("Not added to the catalog index: " << name);
+    }
+  }
+  for (const auto& name : removed) {
+    m_dbConnPool->erase(name);
+  }
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::recordPublicationChanges(const std::vector<std::string>& added,
+                                                        const std::vector<std::string>& removed)
+{
+  m_changeLog->append(added, removed);
+  publishNotifications(added, removed);
+
+  std::vector<std::string> components;
+  for (const std::vector<std::string>* names : {&added, &removed}) {
+    for (const auto& name : *names) {
+      if (index::splitName(name, components)) {
+        m_resultDependencies->invalidate(components);
+      }
+      else {
+        m_resultDependencies->invalidateAll();
+      }
+    }
+  }
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::publishNotifications(const std::vector<std::string>& added,
+                                                    const std::vector<std::string>& removed)
+{
+  std::vector<util::ChangeLog::Change> changes;
+  changes.reserve(added.size() + removed.size());
+  for (const auto& name : added) {
+    changes.push_back({name, false});
+  }
+  for (const auto& name : removed) {
+    changes.push_back({name, true});
+  }
+
+  std::vector<util::SubscriptionTable::Notification> notifications;
+  m_subscriptions->match(changes, notifications);
+
+  // /<prefix>/subscriptions/<canonical-query-params>/<sequence>
+  std::string content;
+  for (const auto& notification : notifications) {
+    ndn::Name streamName(m_prefix);
+    streamName.append("subscriptions").append(ndn::Name::Component(notification.key));
+    encodeNotification(content, notification.sequence, changes, notification.changes,
+                       getSegmentPayloadLimit(streamName, false));
+
+    std::shared_ptr<ndn::Data> data =
+      std::make_shared<ndn::Data>(ndn::Name(streamName).appendNumber(notification.sequence));
+    data->setContent(reinterpret_cast<const uint8_t*>(content.c_str()), content.size());
+    data->setFreshnessPeriod(ndn::time::milliseconds(NOTIFICATION_FRESHNESS));
+    publishSegment(data, util::SigningPolicy::PACKET_RESULTS, nullptr);
+  }
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::encodeNotification(std::string& content,
+                                                  uint64_t sequence,
+                                                  const std::vector<util::ChangeLog::Change>& changes,
+                                                  const std::vector<size_t>& indices,
+                                                  size_t payloadLimit)
+{
+  // same output as Json::FastWriter, whose keys are sorted
+  const std::string tail(",\"sequence\":" + std::to_string(sequence) + "}");
+  content.assign("{\"resultCount\":");
+  content.append(std::to_string(indices.size()));
+  size_t headSize = content.size();
+
+  content.append(",\"results\":[");
+  std::string entry;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const util::ChangeLog::Change& change = changes[indices[i]];
+    if (change.isRemoved) {
+      entry.assign("{\"name\":");
+      entry.append(Json::valueToQuotedString(change.name.c_str()));
+      entry.append(",\"removed\":true}");
+    }
+    else {
+      encodeResultEntry(entry, change.name.c_str(), 0);
+    }
+    if (i > 0) {
+      content.push_back(',');
+    }
+    content.append(entry);
+    if (content.size() + 1 + tail.size() > payloadLimit) {
+      break;
+    }
+  }
+  content.push_back(']');
+
+  if (content.size() + tail.size() > payloadLimit) {
+    content.resize(headSize);
+    content.append(",\"sequence\":");
+    content.append(std::to_string(sequence));
+    content.append(",\"truncated\":true}");
+    return;
+  }
+  content.append(tail);
 }
 
 template <typename DatabaseHandler>
@@ -446,170 +1767,789 @@ template <>
 void
 QueryAdapter<ConnectionPool_T>::closeDatabaseHandler()
 {
-  ConnectionPool_stop(*m_dbConnPool);
+  // the cached connections go back to the pool before it stops
+  m_statementCache.reset();
+  ConnectionPool_stop(*m_dbConnPool);
+}
+
+
+template <typename DatabaseHandler>
+QueryAdapter<DatabaseHandler>::~QueryAdapter()
+{
+  // running queries must finish before the database handler goes away, they may wait for
+  // their segments to be signed, so the signing pipeline is stopped after them
+  if (m_workerPool) {
+    m_workerPool->stop();
+  }
+  if (m_signingPipeline) {
+    m_signingPipeline->stop();
+  }
+
+  for (const auto& itr : m_registeredPrefixList) {
+    if (static_cast<bool>(itr.second))
+      m_face->unsetInterestFilter(itr.second);
+  }
+
+  closeDatabaseHandler();
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::onIncomingQueryInterest(const ndn::InterestFilter& filter,
+                                                       const ndn::Interest& interest)
+{
+  _LOG_DEBUG(">> QueryAdapter::onIncomingQueryInterest");
+
+  // Interest must carry component "initialization" or "query"
+  if (interest.getName().size() < filter.getPrefix().size()) {
+    // must NACK incorrect interest
+    sendNack(interest.getName());
+    return;
+  }
+
+  _LOG_DEBUG("Interest : " << interest.getName());
+  std::shared_ptr<const ndn::Interest> interestPtr = interest.shared_from_this();
+
+  if (interest.getName()[filter.getPrefix().size()] == ndn::Name::Component("filters-initialization")) {
+    onFiltersInitializationInterest(interest);
+  }
+  else if (interest.getName()[filter.getPrefix().size()] == ndn::Name::Component("status")) {
+    onStatusInterest(interest);
+  }
+  else if (interest.getName()[filter.getPrefix().size()] == ndn::Name::Component("subscribe") ||
+           interest.getName()[filter.getPrefix().size()] == ndn::Name::Component("subscriptions")) {
+    onSubscriptionInterest(interest);
+  }
+  else if (interest.getName()[filter.getPrefix().size()] == ndn::Name::Component("query")) {
+
+    // a query without version gets the latest results that are still valid, any other
+    // Interest the packet it names
+    bool isUnversioned = interest.getName().size() == filter.getPrefix().size() + 2;
+    if (!isUnversioned) {
+      auto data = m_cache->find(interest);
+      if (data) {
+        m_face->put(*data);
+        return;
+      }
+    }
+
+    // equivalent queries are run and cached once, under the name of their canonical query
+    ndn::Name canonicalName = getCanonicalQueryName(interest.getName());
+    bool isCanonical = canonicalName == interest.getName();
+    if (isUnversioned) {
+      if (answerWithLatestResults(interest, canonicalName)) {
+        return;
+      }
+    }
+    else if (!isCanonical && answerFromCanonicalQuery(interest, canonicalName)) {
+      return;
+    }
+
+    // catalog must strip sequence number in an Interest for further process
+    if (canonicalName.size() > (filter.getPrefix().size() + 2)) {
+      // lazily produced results: the segment is made when its Interest arrives
+      if (m_cursors && canonicalName.size() == filter.getPrefix().size() + 4 &&
+          canonicalName.get(-1).isSegment()) {
+        auto cursor = m_cursors->find(canonicalName.getPrefix(-1).toUri());
+        if (cursor) {
+          uint64_t segmentNo = canonicalName.get(-1).toSegment();
+          dispatchQuery([this, cursor, segmentNo, interestPtr, canonicalName, isCanonical] {
+              advanceResultCursor(cursor, segmentNo + m_cursorPrefetch);
+              if (!isCanonical) {
+                if (m_signingPipeline) {
+                  m_signingPipeline->waitFor(canonicalName.getPrefix(-1));
+                }
+                answerFromCanonicalQuery(*interestPtr, canonicalName);
+              }
+            },
+            interest);
+          return;
+        }
+      }
+
+      // Interest carries sequence number, only grip the main part
+      // e.g., /hep/query/<query-params>/<version>/#seq
+      ndn::Interest queryInterest(canonicalName.getPrefix(filter.getPrefix().size() + 2));
+
+      auto data = m_cache->find(queryInterest);
+      if (data && !m_cursors) {
+        // catalog has generated some data, but still working on it; an equivalent query is
+        // answered when it is done
+        if (!isCanonical) {
+          ndn::Name queryKey(queryInterest.getName());
+          queryKey.append(ndn::name::Component::fromEscapedString(getChronoSyncDigest()));
+          std::lock_guard<std::mutex> lock(m_mutex);
+          auto inFlight = m_inFlightQueries.find(queryKey);
+          if (inFlight != m_inFlightQueries.end()) {
+            inFlight->second.push_back(interestPtr);
+          }
+        }
+        return;
+      }
+      // with lazy results, the cursor has expired or was evicted: run the query again
+      interestPtr = std::make_shared<ndn::Interest>(queryInterest);
+    }
+    else if (!isCanonical) {
+      interestPtr = std::make_shared<ndn::Interest>(canonicalName);
+    }
+
+    // identical queries share one execution: later Interests attach to the running one and
+    // are answered from its output
+    ndn::Name queryKey(interestPtr->getName());
+    queryKey.append(ndn::name::Component::fromEscapedString(getChronoSyncDigest()));
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto inFlight = m_inFlightQueries.find(queryKey);
+      if (inFlight != m_inFlightQueries.end()) {
+        _LOG_DEBUG("Attach to in-flight query " << queryKey);
+        inFlight->second.push_back(interest.shared_from_this());
+        ++m_nCoalescedQueries;
+        return;
+      }
+      // the segments of the canonical query do not answer the Interest, which waits for them
+      std::vector<std::shared_ptr<const ndn::Interest>>& waiters = m_inFlightQueries[queryKey];
+      if (!isCanonical) {
+        waiters.push_back(interest.shared_from_this());
+      }
+    }
+
+    if (!dispatchQuery(bind(&QueryAdapter<DatabaseHandler>::runInFlightQuery,
+                            this, interestPtr, queryKey),
+                       interest)) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_inFlightQueries.erase(queryKey);
+    }
+  }
+
+  // ignore other Interests
+}
+
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::dispatchQuery(const util::WorkerPool::Task& task,
+                                             const ndn::Interest& interest)
+{
+  // admission control: when all threads are busy and the queue is full, the Interest is
+  // dropped and the consumer will retransmit it later
+  if (!m_workerPool->submit(task)) {
+    _LOG_DEBUG("Query queue is full, drop Interest " << interest.getName());
+    return false;
+  }
+  return true;
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::runInFlightQuery(std::shared_ptr<const ndn::Interest> interest,
+                                                const ndn::Name& queryKey)
+{
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point queryStart = Clock::now();
+  runJsonQuery(interest);
+
+  // the waiters are answered from the cache, so the segments must have been signed
+  Clock::time_point signingStart = Clock::now();
+  if (m_signingPipeline) {
+    m_signingPipeline->waitFor(interest->getName());
+  }
+  Clock::time_point signingEnd = Clock::now();
+
+  std::vector<std::shared_ptr<const ndn::Interest>> waiters;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_nQueries;
+    m_totalQueryMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+                                  signingStart - queryStart).count();
+    m_totalSigningWaitMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+                                        signingEnd - signingStart).count();
+    auto inFlight = m_inFlightQueries.find(queryKey);
+    if (inFlight != m_inFlightQueries.end()) {
+      waiters.swap(inFlight->second);
+      m_inFlightQueries.erase(inFlight);
+    }
+  }
+
+  // segments were put as they were generated, this only catches the Interests that arrived
+  // after their Data went out, and those of equivalent queries
+  for (const auto& waiter : waiters) {
+    auto data = m_cache->find(*waiter);
+    if (data) {
+      m_faceDispatcher->put(data);
+      continue;
+    }
+    ndn::Name canonicalName = getCanonicalQueryName(waiter->getName());
+    if (canonicalName != waiter->getName()) {
+      answerFromCanonicalQuery(*waiter, canonicalName);
+    }
+  }
+}
+
+template <typename DatabaseHandler>
+ndn::Name
+QueryAdapter<DatabaseHandler>::getCanonicalQueryName(const ndn::Name& name) const
+{
+  size_t paramsIndex = m_prefix.size() + 1;
+  if (name.size() <= paramsIndex) {
+    return name;
+  }
+
+  const ndn::Name::Component& params = name[paramsIndex];
+  std::string canonicalParams =
+    util::canonicalizeJsonQuery(std::string(reinterpret_cast<const char*>(params.value()),
+                                            params.value_size()),
+                                m_nameFields);
+  if (canonicalParams.empty()) {
+    return name;
+  }
+
+  // the packets of the canonical query are renamed to this one, whose name TLV may also need a
+  // longer length field
+  ndn::Name::Component canonicalComponent(canonicalParams);
+  if (canonicalComponent == params ||
+      params.size() + 2 > canonicalComponent.size() + MAX_CANONICAL_QUERY_GROWTH) {
+    return name;
+  }
+
+  ndn::Name canonicalName(name.getPrefix(paramsIndex));
+  canonicalName.append(canonicalComponent);
+  canonicalName.append(name.getSubName(paramsIndex + 1));
+  return canonicalName;
+}
+
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::answerFromCanonicalQuery(const ndn::Interest& interest,
+                                                        const ndn::Name& canonicalName)
+{
+  // the Interest may have been queued before an earlier copy was cached
+  auto copy = m_cache->find(interest);
+  if (copy) {
+    m_faceDispatcher->put(copy);
+    return true;
+  }
+
+  ndn::Interest canonicalInterest(interest);
+  canonicalInterest.setName(canonicalName);
+  auto canonicalData = m_cache->find(canonicalInterest);
+  if (!canonicalData) {
+    return false;
+  }
+
+  // only the query-params differ, the version and the segment number are kept
+  size_t paramsIndex = m_prefix.size() + 1;
+  ndn::Name name(interest.getName().getPrefix(paramsIndex + 1));
+  name.append(canonicalData->getName().getSubName(paramsIndex + 1));
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_canonicalCopiesBeingSigned.insert(name).second) {
+      // the copy satisfies this Interest too when it is put
+      return true;
+    }
+  }
+
+  std::shared_ptr<ndn::Data> data = std::make_shared<ndn::Data>(name);
+  data->setMetaInfo(canonicalData->getMetaInfo());
+  data->setContent(canonicalData->getContent());
+
+  // the canonical form of an autocompletion query only has the "?" key
+  static const std::string AUTOCOMPLETE_PARAMS = "{\"?\":";
+  const ndn::Name::Component& params = canonicalName[paramsIndex];
+  bool isAutocomplete = params.value_size() >= AUTOCOMPLETE_PARAMS.size() &&
+                        std::equal(AUTOCOMPLETE_PARAMS.begin(), AUTOCOMPLETE_PARAMS.end(),
+                                   params.value());
+
+  util::SigningPolicy::PacketClass packetClass = isAutocomplete ?
+                                                  util::SigningPolicy::PACKET_AUTOCOMPLETE :
+                                                  util::SigningPolicy::PACKET_RESULTS;
+
+  _LOG_DEBUG("Answer " << name << " with " << canonicalData->getName());
+  ++m_nCanonicalQueryCopies;
+  // the copy is cached before it is no longer marked as being signed, so no Interest is left
+  // without an answer
+  auto onSigned = [this, packetClass] (const std::shared_ptr<ndn::Data>& signedData) {
+    cacheAndPut(signedData, packetClass);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_canonicalCopiesBeingSigned.erase(signedData->getName());
+  };
+  if (!m_signingPipeline) {
+    signData(*data, packetClass);
+    onSigned(data);
+  }
+  else if (!m_signingPipeline->submit(data,
+                                      [this, packetClass] (ndn::Data& unsignedData) {
+                                        signData(unsignedData, packetClass);
+                                      },
+                                      onSigned)) {
+    _LOG_DEBUG("Signing pipeline is stopped, drop " << name);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_canonicalCopiesBeingSigned.erase(name);
+  }
+  return true;
+}
+
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::answerWithLatestResults(const ndn::Interest& interest,
+                                                       const ndn::Name& canonicalName)
+{
+  std::string version;
+  return m_resultDependencies->find(canonicalName.toUri(), version) &&
+         answerWithVersion(interest, canonicalName,
+                           ndn::name::Component::fromEscapedString(version));
+}
+
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::answerWithVersion(const ndn::Interest& interest,
+                                                 const ndn::Name& canonicalName,
+                                                 const ndn::Name::Component& version)
+{
+  ndn::Interest versionedInterest(interest);
+  versionedInterest.setName(ndn::Name(interest.getName()).append(version));
+  // the version is known to be current, however long ago its packets were made
+  versionedInterest.setMustBeFresh(false);
+
+  auto data = m_cache->find(versionedInterest);
+  if (data) {
+    m_face->put(*data);
+    return true;
+  }
+  return canonicalName != interest.getName() &&
+         answerFromCanonicalQuery(versionedInterest, ndn::Name(canonicalName).append(version));
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::onStatusInterest(const ndn::Interest& interest)
+{
+  _LOG_DEBUG(">> QueryAdapter::onStatusInterest");
+
+  Json::Value status;
+  Json::FastWriter fastWriter;
+  getStatus(status);
+  const std::string statusStr = fastWriter.write(status);
+
+  // use /<prefix>/status as data name
+  std::shared_ptr<ndn::Data> data = std::make_shared<ndn::Data>(interest.getName());
+  data->setContent(reinterpret_cast<const uint8_t*>(statusStr.c_str()), statusStr.size());
+  data->setFreshnessPeriod(ndn::time::milliseconds(1000));
+
+  signData(*data);
+
+  m_face->put(*data);
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::onSubscriptionInterest(const ndn::Interest& interest)
+{
+  _LOG_DEBUG(">> QueryAdapter::onSubscriptionInterest");
+
+  // /<prefix>/subscribe/<query-params> or /<prefix>/subscriptions/<query-params>/<sequence>
+  const ndn::Name& name = interest.getName();
+  size_t paramsIndex = m_prefix.size() + 1;
+  bool isSubscribe = name[m_prefix.size()] == ndn::Name::Component("subscribe");
+  if (name.size() != paramsIndex + (isSubscribe ? 1 : 2)) {
+    return;
+  }
+  const ndn::Name::Component& params = name[paramsIndex];
+  const std::string jsonQuery(reinterpret_cast<const char*>(params.value()),
+                              params.value_size());
+
+  if (!isSubscribe) {
+    auto data = m_cache->find(interest);
+    if (data) {
+      m_face->put(*data);
+      return;
+    }
+
+    // the consumer subscribes again once an Interest of an unknown stream times out
+    uint64_t nextSequence = 0;
+    if (!name.get(-1).isNumber() || !m_subscriptions->refresh(jsonQuery, nextSequence)) {
+      return;
+    }
+
+    // a notification that is no longer cached has lost its changes, otherwise the Interest
+    // waits for the next publication that changes the results
+    uint64_t sequence = name.get(-1).toNumber();
+    if (sequence < nextSequence) {
+      const std::string content("{\"sequence\":" + std::to_string(sequence) +
+                                ",\"truncated\":true}");
+      std::shared_ptr<ndn::Data> data = std::make_shared<ndn::Data>(name);
+      data->setContent(reinterpret_cast<const uint8_t*>(content.c_str()), content.size());
+      data->setFreshnessPeriod(ndn::time::milliseconds(NOTIFICATION_FRESHNESS));
+      publishSegment(data, util::SigningPolicy::PACKET_RESULTS, nullptr);
+    }
+    return;
+  }
+
+  // equivalent queries share one notification stream, named after the canonical query
+  const std::string canonicalQuery = util::canonicalizeJsonQuery(jsonQuery, m_nameFields);
+  Json::Value parsedFromString;
+  Json::Reader reader;
+  std::vector<std::pair<std::string, std::string>> typedComponents;
+  if (canonicalQuery.empty() || !reader.parse(canonicalQuery, parsedFromString) ||
+      parsedFromString.isMember("?") || parsedFromString.isMember("since") ||
+      parsedFromString.isMember("encoding") ||
+      !(parsedFromString.isMember("??") ?
+        doPrefixBasedSearch(parsedFromString, typedComponents) :
+        doFilterBasedSearch(parsedFromString, typedComponents))) {
+    sendNack(name);
+    return;
+  }
+
+  uint64_t nextSequence = 0;
+  if (!m_subscriptions->subscribe(canonicalQuery, makeResultPredicate(typedComponents),
+                                  nextSequence)) {
+    _LOG_DEBUG("Too many subscriptions, reject " << name);
+    sendNack(name);
+    return;
+  }
+
+  ndn::Name streamName(m_prefix);
+  streamName.append("subscriptions").append(ndn::Name::Component(canonicalQuery));
+  Json::Value reply;
+  reply["name"] = streamName.toUri();
+  reply["next"] = Json::UInt64(nextSequence);
+  Json::FastWriter fastWriter;
+  const std::string replyStr = fastWriter.write(reply);
+
+  std::shared_ptr<ndn::Data> data = std::make_shared<ndn::Data>(name);
+  data->setContent(reinterpret_cast<const uint8_t*>(replyStr.c_str()), replyStr.size());
+  data->setFreshnessPeriod(ndn::time::milliseconds(SUBSCRIPTION_FRESHNESS));
+
+  signData(*data, util::SigningPolicy::PACKET_ACK);
+
+  m_face->put(*data);
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::getStatus(Json::Value& status)
+{
+  if (m_workerPool) {
+    util::WorkerPool::Statistics workers = m_workerPool->getStatistics();
+    Json::Value& entry = status["workers"];
+    entry["threads"] = Json::UInt64(m_workerPool->getNThreads());
+    entry["queueCapacity"] = Json::UInt64(m_workerPool->getMaxQueueLength());
+    entry["queueLength"] = Json::UInt64(workers.queueLength);
+    entry["maxQueueLength"] = Json::UInt64(workers.maxQueueLength);
+    entry["accepted"] = Json::UInt64(workers.nAccepted);
+    entry["rejected"] = Json::UInt64(workers.nRejected);
+    entry["completed"] = Json::UInt64(workers.nCompleted);
+    entry["totalWaitMicroseconds"] = Json::UInt64(workers.totalWaitMicroseconds);
+    entry["maxWaitMicroseconds"] = Json::UInt64(workers.maxWaitMicroseconds);
+  }
+
+  if (m_statementCache) {
+    util::StatementCache::Statistics statements = m_statementCache->getStatistics();
+    Json::Value& entry = status["statements"];
+    entry["hits"] = Json::UInt64(statements.nHits);
+    entry["misses"] = Json::UInt64(statements.nMisses);
+    entry["connections"] = Json::UInt64(statements.nConnections);
+    entry["idleConnections"] = Json::UInt64(statements.nIdleConnections);
+  }
+
+  if (m_signingPipeline) {
+    util::SigningPipeline::Statistics signing = m_signingPipeline->getStatistics();
+    Json::Value& entry = status["signing"];
+    entry["threads"] = Json::UInt64(m_signingPipeline->getNThreads());
+    entry["queueCapacity"] = Json::UInt64(m_signingPipeline->getMaxQueueLength());
+    entry["queueLength"] = Json::UInt64(signing.queueLength);
+    entry["maxQueueLength"] = Json::UInt64(signing.maxQueueLength);
+    entry["signed"] = Json::UInt64(signing.nSigned);
+    entry["totalWaitMicroseconds"] = Json::UInt64(signing.totalWaitMicroseconds);
+    entry["totalSignMicroseconds"] = Json::UInt64(signing.totalSignMicroseconds);
+    entry["totalPutMicroseconds"] = Json::UInt64(signing.totalSinkMicroseconds);
+  }
+
+  {
+    util::ContentCache::Statistics cache = m_cache->getStatistics();
+    Json::Value& entry = status["cache"];
+    uint64_t nHits = 0;
+    for (size_t partition = 0; partition < util::ContentCache::PARTITION_N; ++partition) {
+      const util::ContentCache::PartitionStatistics& statistics = cache.partitions[partition];
+      Json::Value& partitionEntry =
+        entry[partition == util::ContentCache::PARTITION_INTERACTIVE ? "autocomplete" : "results"];
+      partitionEntry["entries"] = Json::UInt64(statistics.nEntries);
+      partitionEntry["memoryUsage"] = Json::UInt64(statistics.memoryUsage);
+      partitionEntry["memoryLimit"] = Json::UInt64(statistics.memoryLimit);
+      partitionEntry["hits"] = Json::UInt64(statistics.nHits);
+      partitionEntry["insertions"] = Json::UInt64(statistics.nInsertions);
+      partitionEntry["evictions"] = Json::UInt64(statistics.nEvictions);
+      partitionEntry["evictedBytes"] = Json::UInt64(statistics.nEvictedBytes);
+      partitionEntry["rejections"] = Json::UInt64(statistics.nRejections);
+      nHits += statistics.nHits;
+    }
+    entry["hits"] = Json::UInt64(nHits);
+    entry["misses"] = Json::UInt64(cache.nMisses);
+    uint64_t nLookups = nHits + cache.nMisses;
+    entry["hitRatio"] = nLookups > 0 ? static_cast<double>(nHits) / nLookups : 0.0;
+  }
+
+  {
+    util::FaceDispatcher::Statistics dispatcher = m_faceDispatcher->getStatistics();
+    Json::Value& entry = status["dispatcher"];
+    entry["queueLength"] = Json::UInt64(dispatcher.queueLength);
+    entry["maxQueueLength"] = Json::UInt64(dispatcher.maxQueueLength);
+    entry["packets"] = Json::UInt64(dispatcher.nPackets);
+    entry["batches"] = Json::UInt64(dispatcher.nBatches);
+    entry["dropped"] = Json::UInt64(dispatcher.nDropped);
+    entry["maxBatchSize"] = Json::UInt64(dispatcher.maxBatchSize);
+    entry["totalHandOffMicroseconds"] = Json::UInt64(dispatcher.totalHandOffMicroseconds);
+    entry["maxHandOffMicroseconds"] = Json::UInt64(dispatcher.maxHandOffMicroseconds);
+  }
+
+  if (m_segmentStore) {
+    util::SegmentStore::Statistics store = m_segmentStore->getStatistics();
+    Json::Value& entry = status["store"];
+    entry["version"] = m_segmentStore->getVersion();
+    entry["fileSize"] = Json::UInt64(store.fileSize);
+    entry["usedSize"] = Json::UInt64(store.usedSize);
+    entry["segments"] = Json::UInt64(store.nRecords);
+    entry["appended"] = Json::UInt64(store.nAppended);
+    entry["dropped"] = Json::UInt64(store.nDropped);
+    entry["resets"] = Json::UInt64(store.nResets);
+    entry["loaded"] = Json::UInt64(m_nStoredSegmentsLoaded);
+  }
+
+  {
+    util::ChangeLog::Statistics changeLog = m_changeLog->getStatistics();
+    Json::Value& entry = status["changeLog"];
+    entry["changes"] = Json::UInt64(changeLog.nChanges);
+    entry["versions"] = Json::UInt64(changeLog.nVersions);
+    entry["dropped"] = Json::UInt64(changeLog.nDropped);
+  }
+
+  {
+    util::SubscriptionTable::Statistics subscriptions = m_subscriptions->getStatistics();
+    Json::Value& entry = status["subscriptions"];
+    entry["subscriptions"] = Json::UInt64(subscriptions.nSubscriptions);
+    entry["subscribed"] = Json::UInt64(subscriptions.nSubscribed);
+    entry["rejected"] = Json::UInt64(subscriptions.nRejected);
+    entry["expired"] = Json::UInt64(subscriptions.nExpired);
+    entry["notifications"] = Json::UInt64(subscriptions.nNotifications);
+  }
+
+  {
+    util::ResultDependencies::Statistics dependencies = m_resultDependencies->getStatistics();
+    Json::Value& entry = status["resultDependencies"];
+    entry["entries"] = Json::UInt64(dependencies.nEntries);
+    entry["added"] = Json::UInt64(dependencies.nAdded);
+    entry["outdated"] = Json::UInt64(dependencies.nOutdated);
+    entry["invalidated"] = Json::UInt64(dependencies.nInvalidated);
+    entry["evicted"] = Json::UInt64(dependencies.nEvicted);
+  }
+
+  if (m_cursors) {
+    util::ResultCursorTable::Statistics cursors = m_cursors->getStatistics();
+    Json::Value& entry = status["cursors"];
+    entry["open"] = Json::UInt64(cursors.nCursors);
+    entry["memoryUsage"] = Json::UInt64(cursors.memoryUsage);
+    entry["opened"] = Json::UInt64(cursors.nOpened);
+    entry["expired"] = Json::UInt64(cursors.nExpired);
+    entry["evicted"] = Json::UInt64(cursors.nEvicted);
+  }
+
+  getDatabaseHandlerStatus(status);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  status["queries"]["inFlight"] = Json::UInt64(m_inFlightQueries.size());
+  status["queries"]["coalesced"] = Json::UInt64(m_nCoalescedQueries);
+  status["queries"]["canonicalCopies"] = Json::UInt64(m_nCanonicalQueryCopies);
+  status["queries"]["completed"] = Json::UInt64(m_nQueries);
+  status["queries"]["totalRunMicroseconds"] = Json::UInt64(m_totalQueryMicroseconds);
+  status["queries"]["totalSigningWaitMicroseconds"] = Json::UInt64(m_totalSigningWaitMicroseconds);
+  if (m_filtersMenu) {
+    status["filtersMenu"]["version"] = m_filtersMenu->version;
+    status["filtersMenu"]["segments"] = Json::UInt64(m_filtersMenu->segments.size());
+  }
+  status["filtersMenu"]["builds"] = Json::UInt64(m_nFiltersMenuBuilds);
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::getDatabaseHandlerStatus(Json::Value& status)
+{
 }
 
-
-template <typename DatabaseHandler>
-QueryAdapter<DatabaseHandler>::~QueryAdapter()
+template <>
+void
+QueryAdapter<index::CatalogIndex>::getDatabaseHandlerStatus(Json::Value& status)
 {
-  for (const auto& itr : m_registeredPrefixList) {
-    if (static_cast<bool>(itr.second))
-      m_face->unsetInterestFilter(itr.second);
+  if (m_dbConnPool) {
+    status["index"]["records"] = Json::UInt64(m_dbConnPool->size());
+    status["index"]["memoryUsage"] = Json::UInt64(m_dbConnPool->getMemoryUsage());
   }
-
-  closeDatabaseHandler();
 }
 
 template <typename DatabaseHandler>
 void
-QueryAdapter<DatabaseHandler>::onIncomingQueryInterest(const ndn::InterestFilter& filter,
-                                                       const ndn::Interest& interest)
+QueryAdapter<DatabaseHandler>::onFiltersInitializationInterest(const ndn::Interest& interest)
 {
-  _LOG_DEBUG(">> QueryAdapter::onIncomingQueryInterest");
+  _LOG_DEBUG(">> QueryAdapter::onFiltersInitializationInterest");
 
-  // Interest must carry component "initialization" or "query"
-  if (interest.getName().size() < filter.getPrefix().size()) {
-    // must NACK incorrect interest
-    sendNack(interest.getName());
-    return;
-  }
+  const std::string version = getChronoSyncDigest();
 
-  _LOG_DEBUG("Interest : " << interest.getName());
-  std::shared_ptr<const ndn::Interest> interestPtr = interest.shared_from_this();
+  std::shared_ptr<ndn::Data> data;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    data = findFiltersMenuData(interest.getName());
+  }
 
-  if (interest.getName()[filter.getPrefix().size()] == ndn::Name::Component("filters-initialization")) {
-    std::thread queryThread(&QueryAdapter<DatabaseHandler>::onFiltersInitializationInterest,
-                            this,
-                            interestPtr);
-    queryThread.detach();
+  if (data) {
+    m_face->put(*data);
   }
-  else if (interest.getName()[filter.getPrefix().size()] == ndn::Name::Component("query")) {
 
-    auto data = m_cache.find(interest);
-    if (data) {
-      m_face->put(*data);
-      return;
-    }
+  // the consumer is answered from the old menu, or retransmits, while the new one is built
+  scheduleFiltersMenuBuild(version);
 
-    // catalog must strip sequence number in an Interest for further process
-    if (interest.getName().size() > (filter.getPrefix().size() + 2)) {
-      // Interest carries sequence number, only grip the main part
-      // e.g., /hep/query/<query-params>/<version>/#seq
-      ndn::Interest queryInterest(interest.getName().getPrefix(filter.getPrefix().size() + 2));
+  _LOG_DEBUG("<< QueryAdapter::onFiltersInitializationInterest");
+}
 
-      auto data = m_cache.find(queryInterest);
-      if (data) {
-        // catalog has generated some data, but still working on it
-        return;
+template <typename DatabaseHandler>
+std::shared_ptr<ndn::Data>
+QueryAdapter<DatabaseHandler>::findFiltersMenuData(const ndn::Name& name) const
+{
+  if (!m_filtersMenu) {
+    return nullptr;
+  }
+
+  // /<prefix>/filters-initialization/latest and /<prefix>/filters-initialization/<seg>
+  size_t nPrefixComponents = m_prefix.size() + 1;
+  if (name.size() == nPrefixComponents + 1) {
+    if (name[-1] == ndn::Name::Component("latest")) {
+      return m_filtersMenu->latest;
+    }
+    if (name[-1].isSegment()) {
+      uint64_t segmentNo = name[-1].toSegment();
+      if (segmentNo < m_filtersMenu->unversionedSegments.size()) {
+        return m_filtersMenu->unversionedSegments[segmentNo];
       }
-      interestPtr = std::make_shared<ndn::Interest>(queryInterest);
+      return nullptr;
     }
+  }
 
-    std::thread queryThread(&QueryAdapter<DatabaseHandler>::runJsonQuery,
-                            this,
-                            interestPtr);
-    queryThread.detach();
+  // /<prefix>/filters-initialization/<version>[/<seg>], the previous version is kept for the
+  // consumers that started fetching it before the digest changed
+  for (const auto& menu : {m_filtersMenu, m_previousFiltersMenu}) {
+    if (!menu || !menu->name.isPrefixOf(name)) {
+      continue;
+    }
+    uint64_t segmentNo = 0;
+    if (name.size() == menu->name.size() + 1 && name[-1].isSegment()) {
+      segmentNo = name[-1].toSegment();
+    }
+    else if (name.size() != menu->name.size()) {
+      return nullptr;
+    }
+    if (segmentNo < menu->segments.size()) {
+      return menu->segments[segmentNo];
+    }
+    return nullptr;
   }
 
-  // ignore other Interests
+  return nullptr;
 }
 
 template <typename DatabaseHandler>
 void
-QueryAdapter<DatabaseHandler>::onFiltersInitializationInterest(std::shared_ptr<const ndn::Interest> interest)
+QueryAdapter<DatabaseHandler>::scheduleFiltersMenuBuild(const std::string& version)
 {
-  _LOG_DEBUG(">> QueryAdapter::onFiltersInitializationInterest");
+  if (!m_workerPool) {
+    return;
+  }
 
-  if(m_socket != nullptr) {
-    const ndn::ConstBufferPtr digestPtr = m_socket->getRootDigest();
-    std::string digestStr = ndn::toHex(digestPtr->buf(), digestPtr->size());
-    _LOG_DEBUG("Original digest :" << m_chronosyncDigest);
-    _LOG_DEBUG("New digest : " << digestStr);
-    // if the m_chronosyncDigest and the rootdigest are not equal
-    if (digestStr != m_chronosyncDigest) {
-      // (1) update chronosyncDigest
-      // (2) clear all staled ACK data
-      m_mutex.lock();
-      m_chronosyncDigest = digestStr;
-      m_activeQueryToFirstResponse.erase(ndn::Name("/"));
-      m_mutex.unlock();
-      _LOG_DEBUG("Change digest to " << m_chronosyncDigest);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_filtersMenuBuildVersion.empty() ||
+        (m_filtersMenu && m_filtersMenu->version == version)) {
+      return;
     }
+    m_filtersMenuBuildVersion = version;
   }
 
-  auto data = m_activeQueryToFirstResponse.find(*interest);
-  if (data) {
-    m_face->put(*data);
-  }
-  else {
-    populateFiltersMenu(interest);
+  if (!m_workerPool->submit(bind(&QueryAdapter<DatabaseHandler>::populateFiltersMenu,
+                                 this, version))) {
+    _LOG_DEBUG("Filters menu build for version " << version << " is rejected");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_filtersMenuBuildVersion.clear();
   }
-
-  _LOG_DEBUG("<< QueryAdapter::onFiltersInitializationInterest");
 }
 
 template <typename DatabaseHandler>
 void
-QueryAdapter<DatabaseHandler>::populateFiltersMenu(std::shared_ptr<const ndn::Interest> interest)
+QueryAdapter<DatabaseHandler>::populateFiltersMenu(const std::string& version)
 {
   _LOG_DEBUG(">> QueryAdapter::populateFiltersMenu");
   Json::Value filters;
   Json::FastWriter fastWriter;
   getFiltersMenu(filters);
 
-  const std::string filterValue = fastWriter.write(filters);
-
+  std::shared_ptr<FiltersMenu> menu;
   if (!filters.empty()) {
-    // use /<prefix>/filters-initialization/<seg> as data name
-    ndn::Name filterDataName(interest->getName().getPrefix(-1));
+    const std::string filterValue = fastWriter.write(filters);
+
+    menu = std::make_shared<FiltersMenu>();
+    menu->version = version;
+
+    ndn::Name filterDataName(m_prefix);
+    filterDataName.append("filters-initialization");
+    menu->name = ndn::Name(filterDataName)
+                   .append(ndn::name::Component::fromEscapedString(version));
+
+    // the menu is encoded and signed once per version
+    encodeFiltersMenu(menu->name, filterValue, FILTERS_MENU_FRESHNESS, menu->segments);
+    encodeFiltersMenu(filterDataName, filterValue, FILTERS_MENU_LATEST_FRESHNESS,
+                      menu->unversionedSegments);
+
+    const std::string latestValue = menu->name.toUri();
+    menu->latest = std::make_shared<ndn::Data>(ndn::Name(filterDataName).append("latest"));
+    menu->latest->setFreshnessPeriod(ndn::time::milliseconds(FILTERS_MENU_LATEST_FRESHNESS));
+    menu->latest->setContent(reinterpret_cast<const uint8_t*>(latestValue.data()),
+                             latestValue.size());
+    signData(*menu->latest);
+
+    _LOG_DEBUG("Populate Filter Data :" << menu->name << " with "
+               << menu->segments.size() << " segments");
+  }
 
-    const char* payload = filterValue.c_str();
-    size_t payloadLength = filterValue.size();
-    size_t startIndex = 0, seqNo = 0;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_filtersMenuBuildVersion.clear();
+  if (menu) {
+    m_previousFiltersMenu = m_filtersMenu;
+    m_filtersMenu = menu;
+    ++m_nFiltersMenuBuilds;
+  }
+  _LOG_DEBUG("<< QueryAdapter::populateFiltersMenu");
+}
 
-    if (filterValue.length() > PAYLOAD_LIMIT) {
-      payloadLength = PAYLOAD_LIMIT;
-      ndn::Name segmentName = ndn::Name(filterDataName).appendSegment(seqNo);
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::encodeFiltersMenu(const ndn::Name& segmentPrefix,
+                                                 const std::string& menu,
+                                                 uint64_t freshness,
+                                                 std::vector<std::shared_ptr<ndn::Data>>& segments)
+{
+  // the consumer concatenates the segments, so the menu is cut at byte boundaries
+  util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_RAW,
+                               getSegmentPayloadLimit(segmentPrefix, false),
+    [&] (const std::string& payload, uint64_t segmentNo, uint64_t, uint64_t, bool isFinal) {
+      ndn::Name segmentName = ndn::Name(segmentPrefix).appendSegment(segmentNo);
       std::shared_ptr<ndn::Data> filterData = std::make_shared<ndn::Data>(segmentName);
-      // freshnessPeriod 0 means permanent?
-      filterData->setFreshnessPeriod(ndn::time::milliseconds(10));
-      filterData->setContent(reinterpret_cast<const uint8_t*>(payload + startIndex), payloadLength);
-
-      signData(*filterData);
-
-      _LOG_DEBUG("Populate Filter Data :" << segmentName);
-
-      m_mutex.lock();
-      // save the filter results in the activeQueryToFirstResponse structure
-      // when version changes, the activeQueryToFirstResponse should be cleaned
-      m_activeQueryToFirstResponse.insert(*filterData);
-      try {
-        m_face->put(*filterData);
+      filterData->setFreshnessPeriod(ndn::time::milliseconds(freshness));
+      filterData->setContent(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+      if (isFinal) {
+        filterData->setFinalBlockId(ndn::Name::Component::fromSegment(segmentNo));
       }
-      catch (std::exception& e) {
-        _LOG_ERROR(e.what());
-      }
-      m_mutex.unlock();
-
-      seqNo++;
-      startIndex = payloadLength * seqNo + 1;
-    }
-    payloadLength = filterValue.size() - PAYLOAD_LIMIT * seqNo;
 
-    ndn::Name lastSegment = ndn::Name(filterDataName).appendSegment(seqNo);
-    std::shared_ptr<ndn::Data> filterData = std::make_shared<ndn::Data>(lastSegment);
-    filterData->setFreshnessPeriod(ndn::time::milliseconds(10));
-    filterData->setContent(reinterpret_cast<const uint8_t*>(payload + startIndex), payloadLength);
-    filterData->setFinalBlockId(ndn::Name::Component::fromSegment(seqNo));
+      signData(*filterData);
+      segments.push_back(filterData);
+    });
 
-    signData(*filterData);
-    m_mutex.lock();
-    m_activeQueryToFirstResponse.insert(*filterData);
-    m_face->put(*filterData);
-    m_mutex.unlock();
-  }
-  _LOG_DEBUG("<< QueryAdapter::populateFiltersMenu");
+  encoder.appendBytes(menu.data(), menu.size());
+  encoder.finish();
 }
 
 template <typename DatabaseHandler>
@@ -627,6 +2567,21 @@ QueryAdapter<ConnectionPool_T>::getFiltersMenu(Json::Value& value)
   _LOG_DEBUG(">> QueryAdapter::getFiltersMenu");
   Json::Value tmp;
 
+  if (m_filterValues) {
+    std::vector<std::string> values;
+    for (size_t i = 0; i < m_filterCategoryNames.size(); i++) {
+      values.clear();
+      m_filterValues->getValues(i, values);
+      for (const auto& filterValue : values) {
+        tmp[m_filterCategoryNames[i]].append(filterValue);
+      }
+      value.append(tmp);
+      tmp.clear();
+    }
+    _LOG_DEBUG("<< QueryAdapter::getFiltersMenu");
+    return;
+  }
+
   Connection_T conn = ConnectionPool_getConnection(*m_dbConnPool);
   if (!conn) {
     _LOG_DEBUG("No available database connections");
@@ -658,17 +2613,159 @@ QueryAdapter<ConnectionPool_T>::getFiltersMenu(Json::Value& value)
   _LOG_DEBUG("<< QueryAdapter::getFiltersMenu");
 }
 
+template <>
+void
+QueryAdapter<index::CatalogIndex>::getFiltersMenu(Json::Value& value)
+{
+  _LOG_DEBUG(">> QueryAdapter::getFiltersMenu");
+  Json::Value tmp;
+
+  std::vector<std::string> values;
+  for (size_t i = 0; i < m_filterCategoryNames.size(); i++) {
+    const std::string& columnName = m_filterCategoryNames[i];
+    values.clear();
+    m_dbConnPool->findDistinctValues({}, columnName, values);
+
+    for (const auto& filterValue : values) {
+      tmp[columnName].append(filterValue);
+    }
+
+    value.append(tmp);
+    tmp.clear();
+  }
+
+  _LOG_DEBUG("<< QueryAdapter::getFiltersMenu");
+}
+
 template <typename DatabaseHandler>
 void
 QueryAdapter<DatabaseHandler>::signData(ndn::Data& data)
 {
-  if (m_signingId.empty())
+  if (m_signingId.empty()) {
     m_keyChain->sign(data);
-  else {
-    ndn::Name keyName = m_keyChain->getDefaultKeyNameForIdentity(m_signingId);
-    ndn::Name certName = m_keyChain->getDefaultCertificateNameForKey(keyName);
+    return;
+  }
+
+  ndn::Name certName = getSigningCertName();
+  try {
     m_keyChain->sign(data, certName);
   }
+  catch (const std::exception& e) {
+    // the certificate may have been replaced in the KeyChain, so it is looked up again once
+    _LOG_DEBUG("Signing with " << certName << " failed: " << e.what());
+    m_keyChain->sign(data, refreshSigningCertName());
+  }
+}
+
+template <typename DatabaseHandler>
+ndn::Name
+QueryAdapter<DatabaseHandler>::getSigningCertName()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_signingCertMutex);
+    if (!m_signingCertName.empty() && m_signingCertIdentity == m_signingId) {
+      return m_signingCertName;
+    }
+  }
+  return refreshSigningCertName();
+}
+
+template <typename DatabaseHandler>
+ndn::Name
+QueryAdapter<DatabaseHandler>::refreshSigningCertName()
+{
+  ndn::Name identity = m_signingId;
+  ndn::Name keyName = m_keyChain->getDefaultKeyNameForIdentity(identity);
+  ndn::Name certName = m_keyChain->getDefaultCertificateNameForKey(keyName);
+  _LOG_DEBUG("Sign with certificate " << certName);
+
+  std::lock_guard<std::mutex> lock(m_signingCertMutex);
+  m_signingCertName = certName;
+  m_signingCertIdentity = identity;
+  return certName;
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::signData(ndn::Data& data,
+                                        util::SigningPolicy::PacketClass packetClass)
+{
+  m_signingPolicy.sign(data, packetClass, [this] (ndn::Data& unsignedData) {
+      signData(unsignedData);
+    });
+}
+
+template <typename DatabaseHandler>
+std::string
+QueryAdapter<DatabaseHandler>::getChronoSyncDigest()
+{
+  if (m_socket == nullptr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_chronosyncDigest;
+  }
+
+  const ndn::ConstBufferPtr digestPtr = m_socket->getRootDigest();
+  std::string digestStr = ndn::toHex(digestPtr->buf(), digestPtr->size());
+
+  bool isChanged = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    _LOG_DEBUG("Original digest :" << m_chronosyncDigest);
+    _LOG_DEBUG("New digest : " << digestStr);
+    // if the m_chronosyncDigest and the rootdigest are not equal
+    if (digestStr != m_chronosyncDigest) {
+      m_chronosyncDigest = digestStr;
+      isChanged = true;
+      _LOG_DEBUG("Change digest to " << m_chronosyncDigest);
+    }
+  }
+
+  // the menu of the old version keeps being served until the new one is ready
+  if (isChanged) {
+    m_changeLog->markVersion(digestStr);
+    switchSegmentStoreVersion(digestStr);
+    scheduleFiltersMenuBuild(digestStr);
+  }
+  return digestStr;
+}
+
+template <typename DatabaseHandler>
+std::shared_ptr<util::SegmentManifest>
+QueryAdapter<DatabaseHandler>::makeSegmentManifest() const
+{
+  if (!m_isManifestSigned) {
+    return nullptr;
+  }
+  return std::make_shared<util::SegmentManifest>();
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::publishManifest(const ndn::Name& segmentPrefix,
+                                               const util::SegmentManifest& manifest,
+                                               util::SigningPolicy::PacketClass packetClass)
+{
+  ndn::ConstBufferPtr root = manifest.computeRoot();
+
+  Json::Value value;
+  Json::FastWriter fastWriter;
+  value["segments"] = Json::UInt64(manifest.getNSegments());
+  value["root"] = ndn::toHex(root->buf(), root->size());
+  const std::string content = fastWriter.write(value);
+
+  // "manifest" sorts after every segment number, so a prefix Interest for the results still
+  // gets a segment first
+  std::shared_ptr<ndn::Data> data
+    = std::make_shared<ndn::Data>(ndn::Name(segmentPrefix).append("manifest"));
+  data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+  data->setFreshnessPeriod(ndn::time::milliseconds(10000));
+
+  signData(*data);
+
+  _LOG_DEBUG("Publish manifest of " << manifest.getNSegments() << " segments: "
+             << data->getName());
+
+  cacheAndPut(data, packetClass);
 }
 
 template <typename DatabaseHandler>
@@ -694,7 +2791,7 @@ QueryAdapter<DatabaseHandler>::makeAckData(std::shared_ptr<const ndn::Interest>
                   queryResultNameStr.length());
   ack->setFreshnessPeriod(ndn::time::milliseconds(10000));
 
-  signData(*ack);
+  signData(*ack, util::SigningPolicy::PACKET_ACK);
 
   _LOG_DEBUG("Make ACK : " << queryResultNameStr);
 
@@ -712,14 +2809,118 @@ QueryAdapter<DatabaseHandler>::sendNack(const ndn::Name& dataPrefix)
   nack->setFreshnessPeriod(ndn::time::milliseconds(10000));
   nack->setFinalBlockId(ndn::Name::Component::fromSegment(segmentNo));
 
-  signData(*nack);
+  signData(*nack, util::SigningPolicy::PACKET_NACK);
 
   _LOG_DEBUG("Send Nack: " << ndn::Name(dataPrefix).appendSegment(segmentNo));
 
-  m_mutex.lock();
-  m_cache.insert(*nack);
-  m_face->put(*nack);
-  m_mutex.unlock();
+  cacheAndPut(nack, util::SigningPolicy::PACKET_NACK);
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::cacheAndPut(const std::shared_ptr<const ndn::Data>& data,
+                                           util::SigningPolicy::PacketClass packetClass)
+{
+  util::ContentCache::Partition partition =
+    packetClass == util::SigningPolicy::PACKET_AUTOCOMPLETE ?
+    util::ContentCache::PARTITION_INTERACTIVE : util::ContentCache::PARTITION_BULK;
+  m_cache->insert(data, partition);
+  m_faceDispatcher->put(data);
+  storeSegment(*data, partition);
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::storeSegment(const ndn::Data& data,
+                                            util::ContentCache::Partition partition)
+{
+  // only versioned results are kept, /<prefix>/query/<query-params>/<version>/<segment>
+  const ndn::Name& name = data.getName();
+  if (!m_segmentStore || name.size() != m_prefix.size() + 4) {
+    return;
+  }
+
+  // results of an older version, still in flight, are dropped by the store
+  const ndn::Name::Component& version = name[m_prefix.size() + 2];
+  const ndn::Block& wire = data.wireEncode();
+  m_segmentStore->append(std::string(reinterpret_cast<const char*>(version.value()),
+                                     version.value_size()),
+                         wire.wire(), wire.size(), partition);
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::switchSegmentStoreVersion(const std::string& version)
+{
+  if (!m_segmentStore) {
+    return;
+  }
+
+  uint64_t sequence = m_resultDependencies->getSequence();
+  uint64_t nLoaded = m_segmentStore->switchVersion(version,
+    [this, &version, sequence] (const uint8_t* wire, size_t size, uint32_t tag) {
+      std::shared_ptr<ndn::Data> data;
+      try {
+        data = std::make_shared<ndn::Data>(ndn::Block(wire, size));
+      }
+      catch (const std::exception& e) {
+        _LOG_ERROR("Cannot decode a stored segment: " << e.what());
+        return;
+      }
+      m_cache->insert(data, tag == util::ContentCache::PARTITION_INTERACTIVE ?
+                              util::ContentCache::PARTITION_INTERACTIVE :
+                              util::ContentCache::PARTITION_BULK);
+      ++m_nStoredSegmentsLoaded;
+
+      // the conditions of the query are not stored, so its results depend on every name and
+      // are valid until the next publication
+      const ndn::Name& name = data->getName();
+      if (name.get(-1).isSegment() && name.get(-1).toSegment() == 0) {
+        ndn::Name queryName = name.getPrefix(m_prefix.size() + 2);
+        if (getCanonicalQueryName(queryName) == queryName) {
+          m_resultDependencies->add(queryName.toUri(), version,
+                                    util::ResultDependencies::Predicate(), sequence);
+        }
+      }
+    });
+
+  if (nLoaded > 0) {
+    _LOG_DEBUG("Serve " << nLoaded << " stored segments of version " << version);
+  }
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::publishSegment(const std::shared_ptr<ndn::Data>& data,
+                                              util::SigningPolicy::PacketClass packetClass,
+                                              const std::shared_ptr<util::SegmentManifest>& manifest)
+{
+  if (manifest) {
+    // a digest is cheap, so the segment does not go through the signing pipeline
+    m_keyChain->signWithSha256(*data);
+    manifest->add(*data);
+    cacheAndPut(data, packetClass);
+    if (!data->getFinalBlockId().empty()) {
+      publishManifest(data->getName().getPrefix(-1), *manifest, packetClass);
+    }
+    return;
+  }
+
+  if (!m_signingPipeline) {
+    signData(*data, packetClass);
+    cacheAndPut(data, packetClass);
+    return;
+  }
+
+  if (!m_signingPipeline->submit(data,
+                                 [this, packetClass] (ndn::Data& unsignedData) {
+                                   signData(unsignedData, packetClass);
+                                 },
+                                 [this, packetClass] (const std::shared_ptr<ndn::Data>& signedData) {
+                                   cacheAndPut(signedData, packetClass);
+                                 })) {
+    _LOG_DEBUG("Signing pipeline is stopped, drop " << data->getName());
+  }
 }
 
 template <typename DatabaseHandler>
@@ -731,6 +2932,27 @@ QueryAdapter<DatabaseHandler>::json2AutocompletionSql(std::stringstream& sqlQuer
 {
   _LOG_DEBUG(">> QueryAdapter::json2AutocompletionSql");
 
+  std::vector<std::pair<std::string, std::string>> typedComponents;
+  std::string nameField;
+  if (!doAutocompletionSearch(jsonValue, typedComponents, lastComponent, nameField)) {
+    return false;
+  }
+
+  fieldName << nameField;
+  autocompletion2Sql(sqlQuery, typedComponents);
+  return true;
+}
+
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::
+doAutocompletionSearch(Json::Value& jsonValue,
+                       std::vector<std::pair<std::string, std::string>>& typedComponents,
+                       bool& lastComponent,
+                       std::string& nameField)
+{
+  _LOG_DEBUG(">> QueryAdapter::doAutocompletionSearch");
+
   _LOG_DEBUG(jsonValue.toStyledString());
 
   if (jsonValue.type() != Json::objectValue) {
@@ -765,35 +2987,43 @@ QueryAdapter<DatabaseHandler>::json2AutocompletionSql(std::stringstream& sqlQuer
     }
   }
 
-  // 1. get the expected column number by parsing the typedString, so we can get the filed name
+  // get the expected column number by parsing the typedString, so we can get the filed name
   size_t pos = 0;
   size_t start = 1; // start from the 1st char which is not '/'
   size_t count = 0; // also the name to query for
   std::string token;
   std::string delimiter = "/";
-  std::map<std::string, std::string> typedComponents;
   while ((pos = typedString.find(delimiter, start)) != std::string::npos) {
     token = typedString.substr(start, pos - start);
     if (count >= m_nameFields.size() - 1) {
       return false;
     }
 
-    // add column name and value (token) into map
-    typedComponents.insert(std::pair<std::string, std::string>(m_nameFields[count], token));
+    // add column name and value (token)
+    typedComponents.push_back(std::make_pair(m_nameFields[count], token));
     count++;
     start = pos + 1;
   }
 
-  // 2. generate the sql string (append what appears in the typed string, like activity='xxx'),
-  // return true
   if (count == m_nameFields.size() - 1)
     lastComponent = true; // indicate this query is to query the last component
 
-  bool more = false;
+  nameField = m_nameFields[count];
+  return true;
+}
 
-  fieldName << m_nameFields[count];
-  for (std::map<std::string, std::string>::iterator it = typedComponents.begin();
-       it != typedComponents.end(); ++it) {
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::
+autocompletion2Sql(std::stringstream& sqlQuery,
+                   const std::vector<std::pair<std::string, std::string>>& typedComponents)
+{
+  // append what appears in the typed string, like activity='xxx', ordered by column name
+  std::map<std::string, std::string> sortedComponents(typedComponents.begin(),
+                                                      typedComponents.end());
+  bool more = false;
+  for (std::map<std::string, std::string>::iterator it = sortedComponents.begin();
+       it != sortedComponents.end(); ++it) {
     if (more)
       sqlQuery << " AND";
     else
@@ -804,7 +3034,6 @@ QueryAdapter<DatabaseHandler>::json2AutocompletionSql(std::stringstream& sqlQuer
     more = true;
   }
   sqlQuery << ";";
-  return true;
 }
 
 template <typename databasehandler>
@@ -933,29 +3162,11 @@ QueryAdapter<DatabaseHandler>::runJsonQuery(std::shared_ptr<const ndn::Interest>
     return;
   }
 
-  // the version should be replaced with ChronoSync state digest
-  ndn::name::Component version;
-
-  if(m_socket != nullptr) {
-    const ndn::ConstBufferPtr digestPtr = m_socket->getRootDigest();
-    std::string digestStr = ndn::toHex(digestPtr->buf(), digestPtr->size());
-    _LOG_DEBUG("Original digest " << m_chronosyncDigest);
-    _LOG_DEBUG("New digest : " << digestStr);
-    // if the m_chronosyncDigest and the rootdigest are not equal
-    if (digestStr != m_chronosyncDigest) {
-      // (1) update chronosyncDigest
-      // (2) clear all staled ACK data
-      m_mutex.lock();
-      m_chronosyncDigest = digestStr;
-      m_activeQueryToFirstResponse.erase(ndn::Name("/"));
-      m_mutex.unlock();
-      _LOG_DEBUG("Change digest to " << m_chronosyncDigest);
-    }
-    version = ndn::name::Component::fromEscapedString(digestStr);
-  }
-  else {
-    version = ndn::name::Component::fromEscapedString(m_chronosyncDigest);
-  }
+  // the version is the ChronoSync state digest; the changes that arrive from here on may be
+  // missing in the results
+  uint64_t sequence = m_resultDependencies->getSequence();
+  const std::string digest = getChronoSyncDigest();
+  ndn::name::Component version = ndn::name::Component::fromEscapedString(digest);
 
   // 2) From the remainder of the ndn::Interest's ndn::Name, get the JSON out
   Json::Value parsedFromString;
@@ -974,41 +3185,172 @@ QueryAdapter<DatabaseHandler>::runJsonQuery(std::shared_ptr<const ndn::Interest>
   Json::Value tmp;
   std::vector<std::pair<std::string, std::string>> typedComponents;
 
+  // the encoding only changes how the results are written
+  ResultEncoding encoding = RESULT_ENCODING_JSON;
+  if (parsedFromString.isObject() && parsedFromString.isMember("encoding")) {
+    const Json::Value encodingValue = parsedFromString["encoding"];
+    parsedFromString.removeMember("encoding");
+
+    // autocompletion answers are no lists of names, they are only written in Json
+    if (!encodingValue.isString() ||
+        (encodingValue.asString() != "json" && encodingValue.asString() != "tlv") ||
+        (encodingValue.asString() == "tlv" && parsedFromString.isMember("?"))) {
+      sendNack(segmentPrefix);
+      return;
+    }
+    if (encodingValue.asString() == "tlv") {
+      encoding = RESULT_ENCODING_TLV;
+    }
+  }
+
   // expect the autocomplete and the component-based query are separate
+  // if Json::Value contains since as key, is a delta query
+  if (parsedFromString.isObject() && parsedFromString.isMember("since")) {
+    const Json::Value since = parsedFromString["since"];
+    parsedFromString.removeMember("since");
+
+    // autocompletion answers are no lists of names, so they have no changes
+    bool isPrefixBased = parsedFromString.isMember("??");
+    if (!since.isString() || parsedFromString.isMember("?") ||
+        !(isPrefixBased ? doPrefixBasedSearch(parsedFromString, typedComponents) :
+                          doFilterBasedSearch(parsedFromString, typedComponents))) {
+      sendNack(segmentPrefix);
+      return;
+    }
+    if (!prepareSegmentsByChanges(segmentPrefix, typedComponents, since.asString(), encoding)) {
+      // the consumer runs the full query instead
+      sendNack(segmentPrefix);
+      return;
+    }
+  }
   // if Json::Value contains ? as key, is autocompletion
-  if (parsedFromString.get("?", tmp) != tmp) {
+  else if (parsedFromString.get("?", tmp) != tmp) {
     bool lastComponent = false;
-    std::stringstream sqlQuery, fieldName;
+    std::string nameField;
 
-    // must generate the sql string for autocomple, the selected column is changing
-    if (!json2AutocompletionSql(sqlQuery, parsedFromString, lastComponent, fieldName)) {
+    // the selected column is changing with the typed components
+    if (!doAutocompletionSearch(parsedFromString, typedComponents, lastComponent, nameField)) {
       sendNack(segmentPrefix);
       return;
     }
-    prepareSegmentsBySqlString(segmentPrefix, sqlQuery.str(), lastComponent, fieldName.str());
+    prepareSegmentsByAutocompletion(segmentPrefix, typedComponents, lastComponent, nameField);
   }
   else if (parsedFromString.get("??", tmp) != tmp) {
     if (!doPrefixBasedSearch(parsedFromString, typedComponents)) {
       sendNack(segmentPrefix);
       return;
     }
-    prepareSegmentsByParams(typedComponents, segmentPrefix);
+    prepareSegmentsByParams(typedComponents, segmentPrefix, encoding);
   }
   else {
     if (!doFilterBasedSearch(parsedFromString, typedComponents)) {
       sendNack(segmentPrefix);
       return;
     }
-    prepareSegmentsByParams(typedComponents, segmentPrefix);
+    prepareSegmentsByParams(typedComponents, segmentPrefix, encoding);
+  }
+
+  // the results are served for later versions until a publication changes one of the names
+  // they depend on
+  m_resultDependencies->add(interest->getName().toUri(), digest,
+                            makeResultPredicate(typedComponents), sequence);
+}
+
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::
+prepareSegmentsByChanges(const ndn::Name& segmentPrefix,
+                         const std::vector<std::pair<std::string, std::string>>& queryParams,
+                         const std::string& since,
+                         ResultEncoding encoding)
+{
+  _LOG_DEBUG(">> QueryAdapter::prepareSegmentsByChanges");
+
+  std::vector<util::ChangeLog::Change> changes;
+  if (!m_changeLog->getChangesSince(since, changes)) {
+    _LOG_DEBUG("No changes kept since version " << since);
+    return false;
+  }
+
+  // the names whose fields match the patterns, as the statements select them
+  util::ResultDependencies::Predicate predicate = makeResultPredicate(queryParams);
+  std::vector<const util::ChangeLog::Change*> results;
+  std::vector<std::string> components;
+  for (const auto& change : changes) {
+    if (!index::splitName(change.name, components)) {
+      continue;
+    }
+    bool isMatching = true;
+    for (const auto& condition : predicate) {
+      if (condition.field >= components.size() ||
+          !index::matchLikePattern(components[condition.field], condition.pattern)) {
+        isMatching = false;
+        break;
+      }
+    }
+    if (isMatching) {
+      results.push_back(&change);
+    }
+  }
+
+  std::shared_ptr<util::SegmentManifest> manifest = makeSegmentManifest();
+  util::SegmentEncoder encoder(encoding == RESULT_ENCODING_TLV ?
+                                 util::SegmentEncoder::FRAMING_TLV :
+                                 util::SegmentEncoder::FRAMING_JSON_ARRAY,
+                               getSegmentPayloadLimit(segmentPrefix, true),
+    [&] (const std::string& payload, uint64_t segmentNo,
+         uint64_t viewStart, uint64_t viewEnd, bool isFinal) {
+      publishSegment(encodeReplyData(segmentPrefix, payload, segmentNo, isFinal,
+                                     false, results.size(), viewStart, viewEnd, false,
+                                     encoding),
+                     util::SigningPolicy::PACKET_RESULTS, manifest);
+    });
+
+  std::string entry;
+  for (const auto* change : results) {
+    if (encoding == RESULT_ENCODING_TLV) {
+      util::encodeResultTlv(entry, change->name.c_str(), false, change->isRemoved);
+    }
+    else if (change->isRemoved) {
+      // same output as Json::FastWriter for {"name": name, "removed": true}
+      entry.assign("{\"name\":");
+      entry.append(Json::valueToQuotedString(change->name.c_str()));
+      entry.append(",\"removed\":true}");
+    }
+    else {
+      encodeResultEntry(entry, change->name.c_str(), 0);
+    }
+    encoder.appendElement(entry);
   }
+  encoder.finish();
+  return true;
+}
 
+template <typename DatabaseHandler>
+util::ResultDependencies::Predicate
+QueryAdapter<DatabaseHandler>::
+makeResultPredicate(const std::vector<std::pair<std::string, std::string>>& typedComponents) const
+{
+  // the other keys are not bound to the statements, and so do not narrow the results
+  util::ResultDependencies::Predicate predicate;
+  for (const auto& component : typedComponents) {
+    auto field = std::find(m_nameFields.begin(), m_nameFields.end(), component.first);
+    if (field != m_nameFields.end()) {
+      util::ResultDependencies::Condition condition = {
+        static_cast<size_t>(field - m_nameFields.begin()), component.second
+      };
+      predicate.push_back(condition);
+    }
+  }
+  return predicate;
 }
 
 template <typename databasehandler>
 void
 QueryAdapter<databasehandler>::
 prepareSegmentsByParams(std::vector<std::pair<std::string, std::string>>& queryParams,
-                        const ndn::Name& segmentprefix)
+                        const ndn::Name& segmentprefix,
+                        ResultEncoding encoding)
 {
 }
 
@@ -1016,161 +3358,589 @@ template <>
 void
 QueryAdapter<ConnectionPool_T>::
 prepareSegmentsByParams(std::vector<std::pair<std::string, std::string>>& queryParams,
-                        const ndn::Name& segmentPrefix)
+                        const ndn::Name& segmentPrefix,
+                        ResultEncoding encoding)
 {
   _LOG_DEBUG(">> QueryAdapter::prepareSegmentsByParams");
 
-  // the prepared_statement cannot improve the performance, but can simplify the code
-  Connection_T conn = ConnectionPool_getConnection(*m_dbConnPool);
-  if (!conn) {
+  // the statements are prepared once per connection and kept in the statement cache
+  std::unique_ptr<util::StatementCache::Lease> lease = m_statementCache->acquire();
+  if (!lease) {
     // do not answer for this request due to lack of connections, request will come back later
     _LOG_DEBUG("No available database connections");
     return;
   }
-  std::string getRecordNumSqlStr("SELECT count(name) FROM ");
-  getRecordNumSqlStr += m_databaseTable;
-  getRecordNumSqlStr += " WHERE ";
-  for (size_t i = 0; i < m_nameFields.size(); i++) {
-    getRecordNumSqlStr += m_nameFields[i];
-    getRecordNumSqlStr += " LIKE ?";
-    if (i != m_nameFields.size() - 1) {
-      getRecordNumSqlStr += " AND ";
+  Connection_T conn = lease->getConnection();
+
+  // a cursor reads its rows later, so it is bound to the records there are now, which are
+  // also the ones counted
+  uint64_t lastRecordId = 0;
+  if (m_cursors && !readLastRecordId(*lease, lastRecordId)) {
+    return;
+  }
+
+  uint64_t resultCount = 0; // use count sql to get
+  if (m_isResultCountEstimated) {
+    // the listing is the only scan, its last segment carries the exact count
+    resultCount = estimateResultCount(*lease, queryParams);
+  }
+  else {
+    PreparedStatement_T ps4RecordNum = lease->prepare(m_cursors ? m_recordNumUpToIdByParamsSql :
+                                                                  m_recordNumByParamsSql);
+    if (!ps4RecordNum) {
+      return;
+    }
+    bindQueryParams(ps4RecordNum, queryParams);
+    if (m_cursors) {
+      PreparedStatement_setLLong(ps4RecordNum, m_nameFields.size() + 1, lastRecordId);
+    }
+
+    ResultSet_T res4RecordNum;
+    TRY {
+      res4RecordNum = PreparedStatement_executeQuery(ps4RecordNum);
+    }
+    CATCH(SQLException) {
+      _LOG_ERROR(Connection_getLastError(conn));
+      lease->markBroken();
+    }
+    END_TRY;
+
+    // result for record number
+    while (ResultSet_next(res4RecordNum)) {
+      resultCount = ResultSet_getInt(res4RecordNum, 1);
     }
   }
 
-  PreparedStatement_T ps4RecordNum =
-    Connection_prepareStatement(conn, reinterpret_cast<const char*>(getRecordNumSqlStr.c_str()), getRecordNumSqlStr.size());
+  if (m_cursors) {
+    lease.reset();
+    openResultCursor(queryParams, segmentPrefix, encoding, resultCount, lastRecordId);
+    return;
+  }
 
-  // before query, initialize all params for statement
-  for (size_t i = 0; i < m_nameFields.size(); i++) {
-    PreparedStatement_setString(ps4RecordNum, i + 1, "%");
+  PreparedStatement_T ps4Name = lease->prepare(m_nameListByParamsSql);
+  if (!ps4Name) {
+    return;
   }
+  bindQueryParams(ps4Name, queryParams);
 
-  // reset params based on the query
-  for (std::vector<std::pair<std::string, std::string>>::iterator it = queryParams.begin();
-       it != queryParams.end(); ++it) {
-    // dictionary is faster
-    for (size_t i = 0; i < m_nameFields.size(); i++) {
-      if (it->first == m_nameFields[i]) {
-        PreparedStatement_setString(ps4RecordNum, i + 1, it->second.c_str());
+  ResultSet_T res4Name;
+  TRY {
+    res4Name = PreparedStatement_executeQuery(ps4Name);
+  }
+  CATCH(SQLException) {
+    _LOG_ERROR(Connection_getLastError(conn));
+    lease->markBroken();
+  }
+  END_TRY;
+
+  // the segments are only encoded here, so the connection goes back right after the last row
+  generateSegments(res4Name, segmentPrefix, resultCount, false, false, encoding);
+  lease.reset();
+}
+
+template <>
+void
+QueryAdapter<index::CatalogIndex>::
+prepareSegmentsByParams(std::vector<std::pair<std::string, std::string>>& queryParams,
+                        const ndn::Name& segmentPrefix,
+                        ResultEncoding encoding)
+{
+  _LOG_DEBUG(">> QueryAdapter::prepareSegmentsByParams");
+
+  // counting in memory is cheap, so the count is always exact, and it is taken with the
+  // largest id, which bounds the results to the records that are counted
+  uint64_t lastRecordId = 0;
+  uint64_t resultCount = m_dbConnPool->count(queryParams, lastRecordId);
+
+  if (m_cursors) {
+    openResultCursor(queryParams, segmentPrefix, encoding, resultCount, lastRecordId);
+    return;
+  }
+
+  std::shared_ptr<util::SegmentManifest> manifest = makeSegmentManifest();
+  util::SegmentEncoder encoder(encoding == RESULT_ENCODING_TLV ?
+                                 util::SegmentEncoder::FRAMING_TLV :
+                                 util::SegmentEncoder::FRAMING_JSON_ARRAY,
+                               getSegmentPayloadLimit(segmentPrefix, true),
+    [&] (const std::string& payload, uint64_t segmentNo,
+         uint64_t viewStart, uint64_t viewEnd, bool isFinal) {
+      publishSegment(encodeReplyData(segmentPrefix, payload, segmentNo, isFinal,
+                                     false, resultCount, viewStart, viewEnd, false, encoding),
+                     util::SigningPolicy::PACKET_RESULTS, manifest);
+    });
+
+  // the results are read in batches, so publication updates are not held back by a long
+  // listing
+  std::vector<index::CatalogIndex::Record> records;
+  uint64_t afterId = 0;
+  bool isExhausted = false;
+  std::string entry;
+  do {
+    records.clear();
+    m_dbConnPool->find(queryParams, afterId, m_cursorBatchSize, records);
+    isExhausted = (records.size() < m_cursorBatchSize);
+    for (const auto& record : records) {
+      // records inserted between the batches are not counted
+      if (record.id > lastRecordId) {
+        isExhausted = true;
+        break;
       }
+      encodeResultEntry(entry, record.name.c_str(), record.hasMetadata ? 1 : 0, encoding);
+      encoder.appendElement(entry);
+      afterId = record.id;
     }
+  } while (!isExhausted);
+  encoder.finish();
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::
+prepareSegmentsByAutocompletion(const ndn::Name& segmentPrefix,
+                                const std::vector<std::pair<std::string, std::string>>& typedComponents,
+                                bool lastComponent,
+                                const std::string& nameField)
+{
+  std::stringstream sqlQuery;
+  autocompletion2Sql(sqlQuery, typedComponents);
+  prepareSegmentsBySqlString(segmentPrefix, sqlQuery.str(), lastComponent, nameField);
+}
+
+template <>
+void
+QueryAdapter<index::CatalogIndex>::
+prepareSegmentsByAutocompletion(const ndn::Name& segmentPrefix,
+                                const std::vector<std::pair<std::string, std::string>>& typedComponents,
+                                bool lastComponent,
+                                const std::string& nameField)
+{
+  _LOG_DEBUG(">> QueryAdapter::prepareSegmentsByAutocompletion");
+
+  std::vector<std::string> values;
+  m_dbConnPool->findDistinctValues(typedComponents, nameField, values);
+
+  std::shared_ptr<util::SegmentManifest> manifest = makeSegmentManifest();
+  util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_JSON_ARRAY,
+                               getSegmentPayloadLimit(segmentPrefix, true),
+    [&] (const std::string& payload, uint64_t segmentNo,
+         uint64_t viewStart, uint64_t viewEnd, bool isFinal) {
+      publishSegment(encodeReplyData(segmentPrefix, payload, segmentNo, isFinal,
+                                     true, values.size(), viewStart, viewEnd, lastComponent),
+                     util::SigningPolicy::PACKET_AUTOCOMPLETE, manifest);
+    });
+
+  // same entries as generateSegments makes from a one-column result
+  std::string entry;
+  for (const auto& value : values) {
+    encodeResultEntry(entry, value.c_str(), 0);
+    encoder.appendElement(entry);
+  }
+  encoder.finish();
+}
+
+template <typename DatabaseHandler>
+uint64_t
+QueryAdapter<DatabaseHandler>::
+estimateResultCount(util::StatementCache::Lease& lease,
+                    const std::vector<std::pair<std::string, std::string>>& queryParams)
+{
+  PreparedStatement_T ps4Plan = lease.prepare(m_explainNameListByParamsSql);
+  if (!ps4Plan) {
+    return 0;
   }
+  bindQueryParams(ps4Plan, queryParams);
 
-  ResultSet_T res4RecordNum;
+  uint64_t estimate = 0;
   TRY {
-    res4RecordNum = PreparedStatement_executeQuery(ps4RecordNum);
+    ResultSet_T res4Plan = PreparedStatement_executeQuery(ps4Plan);
+    // a single table is read, so the plan has one row
+    if (ResultSet_next(res4Plan)) {
+      estimate = ResultSet_getLLongByName(res4Plan, "rows");
+    }
   }
   CATCH(SQLException) {
-    _LOG_ERROR(Connection_getLastError(conn));
+    _LOG_ERROR(Connection_getLastError(lease.getConnection()));
+    lease.markBroken();
   }
   END_TRY;
 
-  uint64_t resultCount = 0; // use count sql to get
+  return estimate;
+}
 
-  // result for record number
-  while (ResultSet_next(res4RecordNum)) {
-    resultCount = ResultSet_getInt(res4RecordNum, 1);
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::readLastRecordId(util::StatementCache::Lease& lease,
+                                                uint64_t& lastRecordId)
+{
+  PreparedStatement_T ps4LastId = lease.prepare(m_lastRecordIdSql);
+  if (!ps4LastId) {
+    return false;
   }
 
-  // get name list statement
-  std::string getNameListSqlStr("SELECT name, has_metadata FROM ");
-  getNameListSqlStr += m_databaseTable;
-  getNameListSqlStr += " WHERE ";
-  for (size_t i = 0; i < m_nameFields.size(); i++) {
-    getNameListSqlStr += m_nameFields[i];
-    getNameListSqlStr += " LIKE ?";
-    if (i != m_nameFields.size() - 1) {
-      getNameListSqlStr += " AND ";
+  bool isSuccess = true;
+  TRY {
+    ResultSet_T res4LastId = PreparedStatement_executeQuery(ps4LastId);
+    // MAX(id) of an empty table is NULL, which is read as 0
+    if (ResultSet_next(res4LastId)) {
+      lastRecordId = ResultSet_getLLong(res4LastId, 1);
     }
   }
+  CATCH(SQLException) {
+    _LOG_ERROR(Connection_getLastError(lease.getConnection()));
+    lease.markBroken();
+    isSuccess = false;
+  }
+  END_TRY;
+
+  return isSuccess;
+}
 
-  PreparedStatement_T ps4Name =
-    Connection_prepareStatement(conn, reinterpret_cast<const char*>(getNameListSqlStr.c_str()), getNameListSqlStr.size());
+template <typename DatabaseHandler>
+uint64_t
+QueryAdapter<DatabaseHandler>::getEstimatedResultCount(uint64_t estimate,
+                                                       const std::string& payload,
+                                                       uint64_t viewEnd,
+                                                       bool isFinal)
+{
+  if (isFinal) {
+    // only a result without any entry has an empty final segment
+    return (payload.empty() || payload == "[]") ? 0 : viewEnd + 1;
+  }
+  return std::max(estimate, viewEnd + 2);
+}
 
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::
+bindQueryParams(PreparedStatement_T statement,
+                const std::vector<std::pair<std::string, std::string>>& queryParams)
+{
   // before query, initialize all params for statement
   for (size_t i = 0; i < m_nameFields.size(); i++) {
-    PreparedStatement_setString(ps4Name, i + 1, "%");
+    PreparedStatement_setString(statement, i + 1, "%");
   }
 
   // reset params based on the query
-  for (std::vector<std::pair<std::string, std::string>>::iterator it = queryParams.begin();
-       it != queryParams.end(); ++it) {
+  for (auto it = queryParams.begin(); it != queryParams.end(); ++it) {
     // dictionary is faster
     for (size_t i = 0; i < m_nameFields.size(); i++) {
       if (it->first == m_nameFields[i]) {
-        PreparedStatement_setString(ps4Name, i + 1, it->second.c_str());
+        PreparedStatement_setString(statement, i + 1, it->second.c_str());
       }
     }
   }
+}
 
-  ResultSet_T res4Name;
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::setParamsSql()
+{
+  std::string whereClause(" WHERE ");
+  for (size_t i = 0; i < m_nameFields.size(); i++) {
+    whereClause += m_nameFields[i];
+    whereClause += " LIKE ?";
+    if (i != m_nameFields.size() - 1) {
+      whereClause += " AND ";
+    }
+  }
+
+  m_recordNumByParamsSql = "SELECT count(name) FROM " + m_databaseTable + whereClause;
+  m_recordNumUpToIdByParamsSql = m_recordNumByParamsSql + " AND id <= ?";
+  m_nameListByParamsSql = "SELECT name, has_metadata FROM " + m_databaseTable + whereClause;
+  m_explainNameListByParamsSql = "EXPLAIN " + m_nameListByParamsSql;
+  // keyset pagination: the primary key index finds the start of the batch directly
+  m_nameListAfterIdByParamsSql = "SELECT id, name, has_metadata FROM " + m_databaseTable
+                                 + whereClause + " AND id > ? AND id <= ? ORDER BY id LIMIT ?";
+  m_lastRecordIdSql = "SELECT MAX(id) FROM " + m_databaseTable;
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::
+openResultCursor(const std::vector<std::pair<std::string, std::string>>& queryParams,
+                 const ndn::Name& segmentPrefix,
+                 ResultEncoding encoding,
+                 uint64_t resultCount,
+                 uint64_t lastRecordId)
+{
+  std::shared_ptr<util::SegmentManifest> manifest = makeSegmentManifest();
+  auto cursor = std::make_shared<util::ResultCursor>(
+    [this, queryParams, encoding] (uint64_t afterId, uint64_t upToId, size_t limit,
+                                   std::vector<std::string>& entries, uint64_t& lastId) {
+      return fetchResultRows(queryParams, encoding, afterId, upToId, limit, entries, lastId);
+    },
+    lastRecordId,
+    m_cursorBatchSize,
+    getSegmentPayloadLimit(segmentPrefix, true),
+    [this, segmentPrefix, resultCount, manifest, encoding] (const std::string& payload,
+                                                            uint64_t segmentNo,
+                                                            uint64_t viewStart,
+                                                            uint64_t viewEnd,
+                                                            bool isFinal) {
+      uint64_t segmentResultCount = resultCount;
+      if (m_isResultCountEstimated) {
+        segmentResultCount = getEstimatedResultCount(resultCount, payload, viewEnd, isFinal);
+      }
+      publishSegment(encodeReplyData(segmentPrefix, payload, segmentNo, isFinal,
+                                     false, segmentResultCount, viewStart, viewEnd, false,
+                                     encoding),
+                     util::SigningPolicy::PACKET_RESULTS, manifest);
+    },
+    encoding == RESULT_ENCODING_TLV ? util::SegmentEncoder::FRAMING_TLV :
+                                      util::SegmentEncoder::FRAMING_JSON_ARRAY);
+
+  m_cursors->insert(segmentPrefix.toUri(), cursor);
+  advanceResultCursor(cursor, m_cursorPrefetch);
+}
+
+template <typename DatabaseHandler>
+bool
+QueryAdapter<DatabaseHandler>::
+fetchResultRows(const std::vector<std::pair<std::string, std::string>>& queryParams,
+                ResultEncoding encoding,
+                uint64_t afterId,
+                uint64_t upToId,
+                size_t limit,
+                std::vector<std::string>& entries,
+                uint64_t& lastId)
+{
+  return false;
+}
+
+template <>
+bool
+QueryAdapter<ConnectionPool_T>::
+fetchResultRows(const std::vector<std::pair<std::string, std::string>>& queryParams,
+                ResultEncoding encoding,
+                uint64_t afterId,
+                uint64_t upToId,
+                size_t limit,
+                std::vector<std::string>& entries,
+                uint64_t& lastId)
+{
+  std::unique_ptr<util::StatementCache::Lease> lease = m_statementCache->acquire();
+  if (!lease) {
+    _LOG_DEBUG("No available database connections");
+    return false;
+  }
+  Connection_T conn = lease->getConnection();
+
+  PreparedStatement_T ps4Name = lease->prepare(m_nameListAfterIdByParamsSql);
+  if (!ps4Name) {
+    return false;
+  }
+  bindQueryParams(ps4Name, queryParams);
+  PreparedStatement_setLLong(ps4Name, m_nameFields.size() + 1, afterId);
+  PreparedStatement_setLLong(ps4Name, m_nameFields.size() + 2, upToId);
+  PreparedStatement_setLLong(ps4Name, m_nameFields.size() + 3, limit);
+
+  bool isSuccess = true;
   TRY {
-    res4Name = PreparedStatement_executeQuery(ps4Name);
+    ResultSet_T res4Name = PreparedStatement_executeQuery(ps4Name);
+    std::string entry;
+    while (ResultSet_next(res4Name)) {
+      lastId = ResultSet_getLLong(res4Name, 1);
+      encodeResultEntry(entry, ResultSet_getString(res4Name, 2), ResultSet_getInt(res4Name, 3),
+                        encoding);
+      entries.push_back(entry);
+    }
   }
   CATCH(SQLException) {
     _LOG_ERROR(Connection_getLastError(conn));
+    lease->markBroken();
+    isSuccess = false;
   }
   END_TRY;
 
-  generateSegments(res4Name, segmentPrefix, resultCount, false, false);
+  return isSuccess;
+}
 
-  Connection_close(conn);
+template <>
+bool
+QueryAdapter<index::CatalogIndex>::
+fetchResultRows(const std::vector<std::pair<std::string, std::string>>& queryParams,
+                ResultEncoding encoding,
+                uint64_t afterId,
+                uint64_t upToId,
+                size_t limit,
+                std::vector<std::string>& entries,
+                uint64_t& lastId)
+{
+  std::vector<index::CatalogIndex::Record> records;
+  m_dbConnPool->find(queryParams, afterId, limit, records);
+
+  std::string entry;
+  for (const auto& record : records) {
+    // the records come in id order, the rest were inserted after the cursor was opened
+    if (record.id > upToId) {
+      break;
+    }
+    lastId = record.id;
+    encodeResultEntry(entry, record.name.c_str(), record.hasMetadata ? 1 : 0, encoding);
+    entries.push_back(entry);
+  }
+  return true;
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::advanceResultCursor(std::shared_ptr<util::ResultCursor> cursor,
+                                                   uint64_t segmentNo)
+{
+  cursor->advance(segmentNo);
+  m_cursors->cleanup();
 }
 
 template <typename DatabaseHandler>
 void
 QueryAdapter<DatabaseHandler>::generateSegments(ResultSet_T& res,
                                                 const ndn::Name& segmentPrefix,
-                                                int resultCount,
+                                                uint64_t resultCount,
                                                 bool autocomplete,
-                                                bool lastComponent)
+                                                bool lastComponent,
+                                                ResultEncoding encoding)
 {
-  uint64_t segmentno = 0;
-  Json::Value tmp, buf, resultjson;
-  Json::FastWriter fastWriter;
-
   bool twoColumns = false;
   if (ResultSet_getColumnCount(res) > 1) {
     twoColumns = true;
   }
 
-  uint64_t viewstart = 0, viewend = 0;
+  // every row is encoded once, and a segment goes out as soon as it is full
+  std::shared_ptr<util::SegmentManifest> manifest = makeSegmentManifest();
+  util::SegmentEncoder encoder(encoding == RESULT_ENCODING_TLV ?
+                                 util::SegmentEncoder::FRAMING_TLV :
+                                 util::SegmentEncoder::FRAMING_JSON_ARRAY,
+                               getSegmentPayloadLimit(segmentPrefix, true),
+    [&] (const std::string& payload, uint64_t segmentNo,
+         uint64_t viewStart, uint64_t viewEnd, bool isFinal) {
+      uint64_t segmentResultCount = resultCount;
+      if (m_isResultCountEstimated) {
+        segmentResultCount = getEstimatedResultCount(resultCount, payload, viewEnd, isFinal);
+      }
+      publishSegment(encodeReplyData(segmentPrefix, payload, segmentNo, isFinal,
+                                     autocomplete, segmentResultCount, viewStart, viewEnd,
+                                     lastComponent, encoding),
+                     autocomplete ? util::SigningPolicy::PACKET_AUTOCOMPLETE
+                                  : util::SigningPolicy::PACKET_RESULTS,
+                     manifest);
+    });
+
+  std::string entry;
   while (ResultSet_next(res)) {
-    tmp["name"] = ResultSet_getString(res, 1);
-    if (twoColumns) {
-      tmp["has_metadata"] = ResultSet_getInt(res, 2);
-    } else {
-      tmp["has_metadata"] = 0;
-    }
-    buf.append(tmp);
-    const std::string tmpString = fastWriter.write(buf);
-    if (tmpString.length() > PAYLOAD_LIMIT) {
-      std::shared_ptr<ndn::Data> data
-        = makeReplyData(segmentPrefix, resultjson, segmentno, false,
-                        autocomplete, resultCount, viewstart, viewend, lastComponent);
-      m_mutex.lock();
-      m_cache.insert(*data);
-      m_face->put(*data);
-      m_mutex.unlock();
+    encodeResultEntry(entry, ResultSet_getString(res, 1),
+                      twoColumns ? ResultSet_getInt(res, 2) : 0, encoding);
+    encoder.appendElement(entry);
+  }
+  encoder.finish();
+}
 
-      buf.clear();
-      resultjson.clear();
-      segmentno++;
-      viewstart = viewend + 1;
-    }
-    resultjson.append(tmp);
-    buf = resultjson;
-    tmp.clear();
-    viewend++;
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::encodeReplyContent(std::string& content,
+                                                  const std::string& encodedValue,
+                                                  bool isAutocomplete,
+                                                  uint64_t resultCount,
+                                                  uint64_t viewStart,
+                                                  uint64_t viewEnd,
+                                                  bool lastComponent)
+{
+  // the content is written directly instead of through a Json::Value, so the results are not
+  // serialized a second time; the output is the same as Json::FastWriter's
+  content.clear();
+  content.reserve(encodedValue.size() + 128);
+  content.push_back('{');
+  if (lastComponent) {
+    content.append("\"lastComponent\":true,");
+  }
+  if (isAutocomplete) {
+    content.append("\"next\":");
+    content.append(encodedValue);
+    content.push_back(',');
+  }
+  content.append("\"resultCount\":");
+  content.append(std::to_string(resultCount));
+  if (!isAutocomplete) {
+    content.append(",\"results\":");
+    content.append(encodedValue);
+  }
+  content.append(",\"viewEnd\":");
+  content.append(std::to_string(viewEnd));
+  content.append(",\"viewStart\":");
+  content.append(std::to_string(viewStart));
+  content.append("}\n");
+}
+
+template <typename DatabaseHandler>
+size_t
+QueryAdapter<DatabaseHandler>::getSegmentPayloadLimit(const ndn::Name& segmentPrefix,
+                                                      bool hasReplyEnvelope)
+{
+  size_t payloadLimit = m_payloadBudget->getPayloadLimit(segmentPrefix, m_signingId);
+  if (hasReplyEnvelope) {
+    // the query results may be renamed to an equivalent query that is written longer
+    payloadLimit = (payloadLimit > MAX_CANONICAL_QUERY_GROWTH + 1) ?
+                   payloadLimit - MAX_CANONICAL_QUERY_GROWTH : 1;
+    // the largest envelope, plus the terminating NUL that makeReplyData puts in the content
+    std::string envelope;
+    encodeReplyContent(envelope, "", false, std::numeric_limits<uint64_t>::max(),
+                       std::numeric_limits<uint64_t>::max(),
+                       std::numeric_limits<uint64_t>::max(), true);
+    payloadLimit = (payloadLimit > envelope.size() + 1) ? payloadLimit - envelope.size() - 1 : 1;
+  }
+  return payloadLimit;
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::resetPayloadBudget()
+{
+  m_payloadBudget.reset(new util::PayloadBudget(m_maxPacketSize,
+                                                [this] (ndn::Data& data, const ndn::Name&) {
+                                                  signData(data);
+                                                }));
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::resetFaceDispatcher(size_t queueLimit)
+{
+  std::weak_ptr<ndn::Face> weakFace = m_face;
+  m_faceDispatcher = std::make_shared<util::FaceDispatcher>(m_face->getIoService(), queueLimit,
+                       [weakFace] (const ndn::Data& data) {
+                         auto face = weakFace.lock();
+                         if (face) {
+                           face->put(data);
+                         }
+                       });
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::encodeResultEntry(std::string& entry,
+                                                 const char* name,
+                                                 int hasMetadata)
+{
+  // same output as Json::FastWriter for {"has_metadata": hasMetadata, "name": name}
+  entry.assign("{\"has_metadata\":");
+  entry.append(std::to_string(hasMetadata));
+  entry.append(",\"name\":");
+  entry.append(Json::valueToQuotedString(name != nullptr ? name : ""));
+  entry.push_back('}');
+}
+
+template <typename DatabaseHandler>
+void
+QueryAdapter<DatabaseHandler>::encodeResultEntry(std::string& entry,
+                                                 const char* name,
+                                                 int hasMetadata,
+                                                 ResultEncoding encoding)
+{
+  if (encoding == RESULT_ENCODING_TLV) {
+    util::encodeResultTlv(entry, name, hasMetadata != 0, false);
+  }
+  else {
+    encodeResultEntry(entry, name, hasMetadata);
   }
-  std::shared_ptr<ndn::Data> data
-    = makeReplyData(segmentPrefix, resultjson, segmentno, true,
-                    autocomplete, resultCount, viewstart, viewend, lastComponent);
-  m_mutex.lock();
-  m_cache.insert(*data);
-  m_face->put(*data);
-  m_mutex.unlock();
 }
 
 template <typename DatabaseHandler>
@@ -1201,27 +3971,30 @@ QueryAdapter<ConnectionPool_T>::prepareSegmentsBySqlString(const ndn::Name& segm
     return;
   }
 
-  //// just for get the rwo count ...
-  std::string getRecordNumSqlStr("SELECT COUNT( DISTINCT ");
-  getRecordNumSqlStr += nameField;
-  getRecordNumSqlStr += ") FROM ";
-  getRecordNumSqlStr += m_databaseTable;
-  getRecordNumSqlStr += sqlString;
-
-  ResultSet_T res4RecordNum;
-  TRY {
-    res4RecordNum = Connection_executeQuery(conn, reinterpret_cast<const char*>(getRecordNumSqlStr.c_str()), getRecordNumSqlStr.size());
-  }
-  CATCH(SQLException) {
-    _LOG_ERROR(Connection_getLastError(conn));
-  }
-  END_TRY;
-
   uint64_t resultCount = 0;
-  while (ResultSet_next(res4RecordNum)) {
-    resultCount = ResultSet_getInt(res4RecordNum, 1);
+  // with estimated counts, the listing alone gives the count in its last segment
+  if (!m_isResultCountEstimated) {
+    //// just for get the rwo count ...
+    std::string getRecordNumSqlStr("SELECT COUNT( DISTINCT ");
+    getRecordNumSqlStr += nameField;
+    getRecordNumSqlStr += ") FROM ";
+    getRecordNumSqlStr += m_databaseTable;
+    getRecordNumSqlStr += sqlString;
+
+    ResultSet_T res4RecordNum;
+    TRY {
+      res4RecordNum = Connection_executeQuery(conn, reinterpret_cast<const char*>(getRecordNumSqlStr.c_str()), getRecordNumSqlStr.size());
+    }
+    CATCH(SQLException) {
+      _LOG_ERROR(Connection_getLastError(conn));
+    }
+    END_TRY;
+
+    while (ResultSet_next(res4RecordNum)) {
+      resultCount = ResultSet_getInt(res4RecordNum, 1);
+    }
+    ////
   }
-  ////
 
   std::string getNextFieldsSqlStr("SELECT DISTINCT ");
   getNextFieldsSqlStr += nameField;
@@ -1238,7 +4011,9 @@ QueryAdapter<ConnectionPool_T>::prepareSegmentsBySqlString(const ndn::Name& segm
   }
   END_TRY;
 
-  generateSegments(res4NextFields, segmentPrefix, resultCount, true, lastComponent);
+  // autocompletion answers are always written in Json
+  generateSegments(res4NextFields, segmentPrefix, resultCount, true, lastComponent,
+                   RESULT_ENCODING_JSON);
 
   Connection_close(conn);
 }
@@ -1255,28 +4030,66 @@ QueryAdapter<DatabaseHandler>::makeReplyData(const ndn::Name& segmentPrefix,
                                              uint64_t viewEnd,
                                              bool lastComponent)
 {
-  Json::Value entry;
   Json::FastWriter fastWriter;
+  std::string encodedValue = fastWriter.write(value);
+  if (!encodedValue.empty() && encodedValue.back() == '\n') {
+    encodedValue.pop_back();
+  }
 
-  entry["resultCount"] = Json::UInt64(resultCount);;
-  entry["viewStart"] = Json::UInt64(viewStart);
-  entry["viewEnd"] = Json::UInt64(viewEnd);
+  return makeReplyData(segmentPrefix, encodedValue, segmentNo, isFinalBlock, isAutocomplete,
+                       resultCount, viewStart, viewEnd, lastComponent);
+}
 
-  if (lastComponent)
-    entry["lastComponent"] = Json::Value(true);
+template <typename DatabaseHandler>
+std::shared_ptr<ndn::Data>
+QueryAdapter<DatabaseHandler>::makeReplyData(const ndn::Name& segmentPrefix,
+                                             const std::string& encodedValue,
+                                             uint64_t segmentNo,
+                                             bool isFinalBlock,
+                                             bool isAutocomplete,
+                                             uint64_t resultCount,
+                                             uint64_t viewStart,
+                                             uint64_t viewEnd,
+                                             bool lastComponent)
+{
+  std::shared_ptr<ndn::Data> data = encodeReplyData(segmentPrefix, encodedValue, segmentNo,
+                                                    isFinalBlock, isAutocomplete, resultCount,
+                                                    viewStart, viewEnd, lastComponent);
+  signData(*data, isAutocomplete ? util::SigningPolicy::PACKET_AUTOCOMPLETE
+                                 : util::SigningPolicy::PACKET_RESULTS);
+  return data;
+}
 
+template <typename DatabaseHandler>
+std::shared_ptr<ndn::Data>
+QueryAdapter<DatabaseHandler>::encodeReplyData(const ndn::Name& segmentPrefix,
+                                               const std::string& encodedValue,
+                                               uint64_t segmentNo,
+                                               bool isFinalBlock,
+                                               bool isAutocomplete,
+                                               uint64_t resultCount,
+                                               uint64_t viewStart,
+                                               uint64_t viewEnd,
+                                               bool lastComponent,
+                                               ResultEncoding encoding)
+{
   _LOG_DEBUG("resultCount " << resultCount << "; "
              << "viewStart " << viewStart << "; "
              << "viewEnd " << viewEnd);
 
-  if (isAutocomplete) {
-    entry["next"] = value;
-  } else {
-    entry["results"] = value;
+  std::string jsonMessage;
+  size_t payloadLength = 0;
+  if (encoding == RESULT_ENCODING_TLV) {
+    util::encodeReplyTlv(jsonMessage, encodedValue, resultCount, viewStart, viewEnd);
+    payloadLength = jsonMessage.size();
+  }
+  else {
+    encodeReplyContent(jsonMessage, encodedValue, isAutocomplete,
+                       resultCount, viewStart, viewEnd, lastComponent);
+    // the Json content is terminated by a NUL
+    payloadLength = jsonMessage.size() + 1;
   }
-  const std::string jsonMessage = fastWriter.write(entry);
   const char* payload = jsonMessage.c_str();
-  size_t payloadLength = jsonMessage.size() + 1;
   ndn::Name segmentName(segmentPrefix);
   segmentName.appendSegment(segmentNo);
 
@@ -1290,7 +4103,6 @@ QueryAdapter<DatabaseHandler>::makeReplyData(const ndn::Name& segmentPrefix,
 
   _LOG_DEBUG(segmentName);
 
-  signData(*data);
   return data;
 }
 
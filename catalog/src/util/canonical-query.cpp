@@ -0,0 +1,93 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/canonical-query.hpp"
+
+#include <json/reader.h>
+#include <json/value.h>
+#include <json/writer.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace atmos {
+namespace util {
+
+std::string
+canonicalizeJsonQuery(const std::string& jsonQuery, const std::vector<std::string>& nameFields)
+{
+  Json::Value query;
+  Json::Reader reader;
+  if (!reader.parse(jsonQuery, query) || query.type() != Json::objectValue) {
+    return "";
+  }
+
+  try {
+    const Json::Value::Members keys = query.getMemberNames();
+    // the query adapter rejects such queries, and their NACKs are not shared
+    for (const auto& key : keys) {
+      const Json::Value& value = query[key];
+      if (value.isNull() || !value.isConvertibleTo(Json::stringValue)) {
+        return "";
+      }
+    }
+
+    // objects are kept sorted by key, so the writer puts the keys in order
+    Json::Value canonical(Json::objectValue);
+    if (query.isMember("?")) {
+      canonical["?"] = query["?"].asString();
+    }
+    else if (query.isMember("??")) {
+      canonical["??"] = query["??"].asString();
+    }
+    else {
+      for (const auto& key : keys) {
+        if (std::find(nameFields.begin(), nameFields.end(), key) == nameFields.end()) {
+          continue;
+        }
+        std::string value = query[key].asString();
+        // LIKE '%' matches everything, as a missing key does, but LIKE '' only empty fields
+        if (!value.empty() && value.find_first_not_of('%') == std::string::npos) {
+          continue;
+        }
+        canonical[key] = value;
+      }
+    }
+    if (query.isMember("since")) {
+      canonical["since"] = query["since"].asString();
+    }
+    if (query.isMember("encoding") && query["encoding"].asString() != "json") {
+      canonical["encoding"] = query["encoding"].asString();
+    }
+
+    Json::FastWriter writer;
+    std::string canonicalQuery = writer.write(canonical);
+    // the writer ends the document with a newline
+    if (!canonicalQuery.empty() && canonicalQuery[canonicalQuery.size() - 1] == '\n') {
+      canonicalQuery.resize(canonicalQuery.size() - 1);
+    }
+    return canonicalQuery;
+  }
+  catch (const std::exception&) {
+    // a value that claims to be convertible but cannot be written as a string
+    return "";
+  }
+}
+
+} // namespace util
+} // namespace atmos
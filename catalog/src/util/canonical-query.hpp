@@ -0,0 +1,50 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_CANONICAL_QUERY_HPP
+#define ATMOS_UTIL_CANONICAL_QUERY_HPP
+
+#include <string>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * Get the canonical form of a Json query, so that queries that select the same results are
+ * written the same and can share one execution and one set of cached segments.
+ *
+ * The keys are sorted and the values are written as the strings the query is run with. An
+ * autocompletion or prefix query keeps only its "?" or "??" key. A filter query drops the
+ * keys that are not name fields and the non-empty filters that only consist of '%', which
+ * match any value, as the name fields that are not filtered do. An empty filter only matches
+ * empty fields and is kept. The "since" key of a delta query is
+ * kept in every form, and so is the "encoding" key unless it asks for the default "json".
+ *
+ * @param jsonQuery:  the Json query as it appears in the Interest name
+ * @param nameFields: the name fields of the catalog
+ * @return the canonical query, or an empty string if the query cannot be parsed or is
+ *         rejected, so that it is answered as it is
+ */
+std::string
+canonicalizeJsonQuery(const std::string& jsonQuery, const std::vector<std::string>& nameFields);
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_CANONICAL_QUERY_HPP
@@ -0,0 +1,125 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/change-log.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace atmos {
+namespace util {
+
+ChangeLog::ChangeLog(size_t maxChanges)
+  : m_maxChanges(std::max<size_t>(maxChanges, 1))
+  , m_firstPosition(0)
+  , m_nDropped(0)
+{
+}
+
+void
+ChangeLog::markVersion(const std::string& version)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  uint64_t position = m_firstPosition + m_changes.size();
+  // a version that comes back is the same catalog state, the latest mark gives fewer changes
+  m_versions[version] = position;
+  m_versionOrder.push_back(std::make_pair(position, version));
+
+  // versions without changes in between only take one slot each
+  while (m_versionOrder.size() > m_maxChanges) {
+    const auto& oldest = m_versionOrder.front();
+    auto marked = m_versions.find(oldest.second);
+    if (marked != m_versions.end() && marked->second == oldest.first) {
+      m_versions.erase(marked);
+    }
+    m_versionOrder.pop_front();
+  }
+}
+
+void
+ChangeLog::append(const std::vector<std::string>& added, const std::vector<std::string>& removed)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& name : added) {
+    Change change = {name, false};
+    m_changes.push_back(change);
+  }
+  for (const auto& name : removed) {
+    Change change = {name, true};
+    m_changes.push_back(change);
+  }
+  while (m_changes.size() > m_maxChanges) {
+    dropOldest();
+  }
+}
+
+bool
+ChangeLog::getChangesSince(const std::string& version, std::vector<Change>& changes) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto marked = m_versions.find(version);
+  if (marked == m_versions.end() || marked->second < m_firstPosition) {
+    return false;
+  }
+
+  // the last change of a name wins
+  std::map<std::string, bool> netChanges;
+  for (auto change = m_changes.begin() + (marked->second - m_firstPosition);
+       change != m_changes.end(); ++change) {
+    netChanges[change->name] = change->isRemoved;
+  }
+
+  changes.clear();
+  changes.reserve(netChanges.size());
+  for (const auto& change : netChanges) {
+    Change netChange = {change.first, change.second};
+    changes.push_back(netChange);
+  }
+  return true;
+}
+
+ChangeLog::Statistics
+ChangeLog::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Statistics statistics;
+  statistics.nChanges = m_changes.size();
+  statistics.nVersions = m_versions.size();
+  statistics.nDropped = m_nDropped;
+  return statistics;
+}
+
+void
+ChangeLog::dropOldest()
+{
+  m_changes.pop_front();
+  ++m_firstPosition;
+  ++m_nDropped;
+
+  // the versions before the dropped change cannot be served anymore
+  while (!m_versionOrder.empty() && m_versionOrder.front().first < m_firstPosition) {
+    auto marked = m_versions.find(m_versionOrder.front().second);
+    if (marked != m_versions.end() && marked->second == m_versionOrder.front().first) {
+      m_versions.erase(marked);
+    }
+    m_versionOrder.pop_front();
+  }
+}
+
+} // namespace util
+} // namespace atmos
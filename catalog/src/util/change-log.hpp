@@ -0,0 +1,116 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_CHANGE_LOG_HPP
+#define ATMOS_UTIL_CHANGE_LOG_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * ChangeLog keeps the names that the latest publications added to or removed from the
+ * catalog, with the catalog versions in between, so that the changes since a version can be
+ * sent instead of a full result.
+ *
+ * A version is marked when it is first seen, the changes recorded afterwards come after it.
+ * The changes are the net ones, and may include some that a result of the version already
+ * has, so they are meant to be applied as set operations. Once the log is full the oldest
+ * changes are dropped, and the versions before them cannot be served anymore.
+ */
+class ChangeLog : boost::noncopyable
+{
+public:
+  struct Change
+  {
+    std::string name;
+    bool isRemoved;
+  };
+
+  struct Statistics
+  {
+    size_t nChanges;
+    size_t nVersions;
+    uint64_t nDropped;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param maxChanges: the number of changes kept
+   */
+  explicit
+  ChangeLog(size_t maxChanges);
+
+  /**
+   * Mark a version, the changes appended from now on come after it
+   */
+  void
+  markVersion(const std::string& version);
+
+  /**
+   * Record the changes of a publication
+   */
+  void
+  append(const std::vector<std::string>& added, const std::vector<std::string>& removed);
+
+  /**
+   * Get the net changes since a version, sorted by name
+   *
+   * @param version: a marked version
+   * @param changes: to save the last change of every name
+   * @return false if the version has not been marked or its changes have been dropped
+   */
+  bool
+  getChangesSince(const std::string& version, std::vector<Change>& changes) const;
+
+  Statistics
+  getStatistics() const;
+
+private:
+  void
+  dropOldest();
+
+private:
+  const size_t m_maxChanges;
+
+  mutable std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  std::deque<Change> m_changes;
+  // position of m_changes.front() since the log was created
+  uint64_t m_firstPosition;
+  // versions with the position of the first change after them, and in the order of marking
+  std::unordered_map<std::string, uint64_t> m_versions;
+  std::deque<std::pair<uint64_t, std::string>> m_versionOrder;
+  uint64_t m_nDropped;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_CHANGE_LOG_HPP
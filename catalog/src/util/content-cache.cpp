@@ -0,0 +1,311 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/content-cache.hpp"
+
+#include <boost/thread/locks.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace atmos {
+namespace util {
+
+// percentage of a partition taken by the window, which keeps new packets until their
+// consumers had a chance to fetch them
+static const size_t WINDOW_SHARE = 10;
+// counters per row of the frequency sketch of a shard
+static const size_t SKETCH_WIDTH = 1024;
+
+ContentCache::Shard::Shard(size_t sketchWidth)
+  : sketch(sketchWidth)
+  , nMisses(0)
+{
+  for (size_t partition = 0; partition < PARTITION_N; ++partition) {
+    for (auto& region : regions[partition]) {
+      region.memoryUsage = 0;
+      region.memoryLimit = 0;
+    }
+    nHits[partition] = 0;
+    nInsertions[partition] = 0;
+    nEvictions[partition] = 0;
+    nEvictedBytes[partition] = 0;
+    nRejections[partition] = 0;
+  }
+}
+
+ContentCache::ContentCache(size_t memoryLimit, size_t interactiveMemoryLimit,
+                           size_t nShards, size_t shardKeyLength)
+  : m_shardKeyLength(shardKeyLength)
+{
+  if (nShards == 0) {
+    throw std::invalid_argument("ContentCache needs at least one shard");
+  }
+  if (interactiveMemoryLimit > memoryLimit) {
+    throw std::invalid_argument("ContentCache reserves more memory than it has");
+  }
+
+  std::array<size_t, PARTITION_N> partitionLimits;
+  partitionLimits[PARTITION_INTERACTIVE] = interactiveMemoryLimit / nShards;
+  partitionLimits[PARTITION_BULK] = (memoryLimit - interactiveMemoryLimit) / nShards;
+
+  m_shards.reserve(nShards);
+  for (size_t i = 0; i < nShards; ++i) {
+    m_shards.emplace_back(new Shard(SKETCH_WIDTH));
+    for (size_t partition = 0; partition < PARTITION_N; ++partition) {
+      auto& regions = m_shards.back()->regions[partition];
+      regions[AREA_WINDOW].memoryLimit = partitionLimits[partition] * WINDOW_SHARE / 100;
+      regions[AREA_MAIN].memoryLimit = partitionLimits[partition] -
+                                       regions[AREA_WINDOW].memoryLimit;
+    }
+  }
+}
+
+void
+ContentCache::insert(const std::shared_ptr<const ndn::Data>& data, Partition partition)
+{
+  const ndn::Name& name = data->getName();
+  // the name is stored twice, as the key and in the packet
+  size_t size = data->wireEncode().size() + name.wireEncode().size();
+  ndn::time::steady_clock::TimePoint staleAt =
+    ndn::time::steady_clock::now() + data->getFreshnessPeriod();
+  uint64_t keyHash = getKeyHash(name);
+
+  Shard& shard = *m_shards[keyHash % m_shards.size()];
+  boost::unique_lock<boost::shared_mutex> lock(shard.mutex);
+  auto& regions = shard.regions[partition];
+  if (size > regions[AREA_WINDOW].memoryLimit + regions[AREA_MAIN].memoryLimit) {
+    return;
+  }
+
+  auto it = shard.entries.find(name);
+  if (it != shard.entries.end()) {
+    Entry& entry = it->second;
+    Region& region = shard.regions[entry.partition][entry.area];
+    if (entry.partition == partition) {
+      // the packet is replaced in place, the entry keeps its position
+      region.memoryUsage = region.memoryUsage - entry.size + size;
+    }
+    else {
+      // a packet of another class is counted against, and evicted from, its own partition
+      Region& window = regions[AREA_WINDOW];
+      window.clock.splice(window.clock.end(), region.clock, entry.position);
+      region.memoryUsage -= entry.size;
+      window.memoryUsage += size;
+      entry.partition = partition;
+      entry.area = AREA_WINDOW;
+    }
+    entry.data = data;
+    entry.size = size;
+    entry.staleAt = staleAt;
+    entry.isReferenced = true;
+  }
+  else {
+    it = shard.entries.emplace(std::piecewise_construct,
+                               std::forward_as_tuple(name),
+                               std::forward_as_tuple(data, size, staleAt, keyHash,
+                                                     partition)).first;
+    Region& window = regions[AREA_WINDOW];
+    it->second.position = window.clock.insert(window.clock.end(), &it->first);
+    window.memoryUsage += size;
+  }
+  ++shard.nInsertions[partition];
+
+  evict(shard, partition);
+}
+
+std::shared_ptr<const ndn::Data>
+ContentCache::find(const ndn::Interest& interest) const
+{
+  ndn::time::steady_clock::TimePoint now = ndn::time::steady_clock::now();
+
+  if (interest.getName().size() >= m_shardKeyLength) {
+    uint64_t keyHash = getKeyHash(interest.getName());
+    Shard& shard = *m_shards[keyHash % m_shards.size()];
+    // misses count as well, a packet that is requested often is admitted once it arrives
+    shard.sketch.increment(keyHash);
+
+    boost::shared_lock<boost::shared_mutex> lock(shard.mutex);
+    const Entry* entry = findInShard(shard, interest, now);
+    if (entry == nullptr) {
+      ++shard.nMisses;
+      return nullptr;
+    }
+    ++shard.nHits[entry->partition];
+    return entry->data;
+  }
+
+  // the packets under a short name may be in any shard
+  for (const auto& shard : m_shards) {
+    boost::shared_lock<boost::shared_mutex> lock(shard->mutex);
+    const Entry* entry = findInShard(*shard, interest, now);
+    if (entry != nullptr) {
+      ++shard->nHits[entry->partition];
+      return entry->data;
+    }
+  }
+  ++m_shards.front()->nMisses;
+  return nullptr;
+}
+
+ContentCache::Statistics
+ContentCache::getStatistics() const
+{
+  Statistics statistics = Statistics();
+  for (const auto& shard : m_shards) {
+    statistics.nMisses += shard->nMisses;
+    for (size_t partition = 0; partition < PARTITION_N; ++partition) {
+      PartitionStatistics& partitionStatistics = statistics.partitions[partition];
+      {
+        boost::shared_lock<boost::shared_mutex> lock(shard->mutex);
+        for (const auto& region : shard->regions[partition]) {
+          partitionStatistics.nEntries += region.clock.size();
+          partitionStatistics.memoryUsage += region.memoryUsage;
+          partitionStatistics.memoryLimit += region.memoryLimit;
+        }
+      }
+      partitionStatistics.nHits += shard->nHits[partition];
+      partitionStatistics.nInsertions += shard->nInsertions[partition];
+      partitionStatistics.nEvictions += shard->nEvictions[partition];
+      partitionStatistics.nEvictedBytes += shard->nEvictedBytes[partition];
+      partitionStatistics.nRejections += shard->nRejections[partition];
+    }
+  }
+  return statistics;
+}
+
+uint64_t
+ContentCache::getKeyHash(const ndn::Name& name) const
+{
+  // FNV-1a over the values of the key components
+  uint64_t hash = 14695981039346656037ULL;
+  size_t keyLength = std::min(name.size(), m_shardKeyLength);
+  for (size_t i = 0; i < keyLength; ++i) {
+    const ndn::Name::Component& component = name[i];
+    for (size_t j = 0; j < component.value_size(); ++j) {
+      hash = (hash ^ component.value()[j]) * 1099511628211ULL;
+    }
+    hash = (hash ^ '/') * 1099511628211ULL;
+  }
+  return hash;
+}
+
+const ContentCache::Entry*
+ContentCache::findInShard(const Shard& shard, const ndn::Interest& interest,
+                          const ndn::time::steady_clock::TimePoint& now)
+{
+  // a packet is stored under its name without the implicit digest, Interest::matchesData
+  // checks the digest
+  const ndn::Name* prefix = &interest.getName();
+  ndn::Name digestlessName;
+  if (!prefix->empty() && prefix->get(-1).isImplicitSha256Digest()) {
+    digestlessName = prefix->getPrefix(-1);
+    prefix = &digestlessName;
+  }
+
+  const Entry* match = nullptr;
+  for (auto it = shard.entries.lower_bound(*prefix);
+       it != shard.entries.end() && prefix->isPrefixOf(it->first);
+       ++it) {
+    const Entry& entry = it->second;
+    if (interest.getMustBeFresh() && entry.staleAt <= now) {
+      continue;
+    }
+    if (!interest.matchesData(*entry.data)) {
+      continue;
+    }
+    match = &entry;
+    // the entries are in canonical order, so the first match is the leftmost child
+    if (interest.getChildSelector() != 1) {
+      break;
+    }
+  }
+
+  if (match != nullptr) {
+    match->isReferenced.store(true, std::memory_order_relaxed);
+  }
+  return match;
+}
+
+void
+ContentCache::evict(Shard& shard, Partition partition)
+{
+  Region& window = shard.regions[partition][AREA_WINDOW];
+  Region& main = shard.regions[partition][AREA_MAIN];
+
+  while (window.memoryUsage > window.memoryLimit) {
+    auto candidate = selectVictim(shard, window);
+    Entry& candidateEntry = candidate->second;
+
+    main.clock.splice(main.clock.end(), window.clock, candidateEntry.position);
+    window.memoryUsage -= candidateEntry.size;
+    main.memoryUsage += candidateEntry.size;
+    candidateEntry.area = AREA_MAIN;
+
+    // the candidate is at the end of the CLOCK list, so the hand visits the others first
+    uint8_t candidateFrequency = shard.sketch.estimate(candidateEntry.keyHash);
+    while (main.memoryUsage > main.memoryLimit) {
+      auto victim = selectVictim(shard, main);
+      if (victim == candidate) {
+        erase(shard, victim);
+        break;
+      }
+      if (candidateFrequency >= shard.sketch.estimate(victim->second.keyHash)) {
+        erase(shard, victim);
+      }
+      else {
+        ++shard.nRejections[partition];
+        erase(shard, candidate);
+        break;
+      }
+    }
+  }
+
+  // a replaced packet may have grown
+  while (main.memoryUsage > main.memoryLimit) {
+    erase(shard, selectVictim(shard, main));
+  }
+}
+
+ContentCache::EntryMap::iterator
+ContentCache::selectVictim(Shard& shard, Region& region)
+{
+  while (true) {
+    auto it = shard.entries.find(*region.clock.front());
+    if (!it->second.isReferenced.exchange(false, std::memory_order_relaxed)) {
+      return it;
+    }
+    region.clock.splice(region.clock.end(), region.clock, region.clock.begin());
+  }
+}
+
+void
+ContentCache::erase(Shard& shard, EntryMap::iterator entry)
+{
+  Region& region = shard.regions[entry->second.partition][entry->second.area];
+  region.clock.erase(entry->second.position);
+  region.memoryUsage -= entry->second.size;
+  ++shard.nEvictions[entry->second.partition];
+  shard.nEvictedBytes[entry->second.partition] += entry->second.size;
+  shard.entries.erase(entry);
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,233 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_CONTENT_CACHE_HPP
+#define ATMOS_UTIL_CONTENT_CACHE_HPP
+
+#include "util/frequency-sketch.hpp"
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/interest.hpp>
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * ContentCache keeps signed Data packets within a byte budget and answers Interests from them.
+ *
+ * The packets are spread over shards by a hash of the first name components (the key), so that
+ * all the packets an Interest can match sit in one shard. Lookups take the shard lock shared,
+ * mark the entry as used and count the key in a frequency sketch, so they do not wait for each
+ * other. Inserts take it exclusively.
+ *
+ * Every partition has its own share of the budget, so bulk results cannot evict the interactive
+ * ones. Within a partition, eviction follows W-TinyLFU: a new packet enters a small window and
+ * is always kept for a while. When it leaves the window, it only replaces the victim of the
+ * main area if its key is at least as frequent as the victim's, so a scan of rarely requested
+ * packets cannot push out the popular ones. Both areas pick their victims with CLOCK, an entry
+ * used since it was last considered gets a second chance.
+ */
+class ContentCache : boost::noncopyable
+{
+public:
+  enum Partition {
+    /// answers to autocompletion queries
+    PARTITION_INTERACTIVE,
+    /// results of filter and prefix queries, and everything else
+    PARTITION_BULK,
+    PARTITION_N
+  };
+
+  /**
+   * Counters of one partition, summed over the shards
+   */
+  struct PartitionStatistics
+  {
+    size_t nEntries;
+    size_t memoryUsage;
+    size_t memoryLimit;
+    uint64_t nHits;
+    uint64_t nInsertions;
+    uint64_t nEvictions;
+    uint64_t nEvictedBytes;
+    uint64_t nRejections;   // evictions of packets that left the window and lost against
+                            // a more frequent main victim
+  };
+
+  /**
+   * Snapshot of the cache counters
+   */
+  struct Statistics
+  {
+    uint64_t nMisses;       // the partition of a miss is unknown
+    std::array<PartitionStatistics, PARTITION_N> partitions;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param memoryLimit:            the number of bytes all packets may take
+   * @param interactiveMemoryLimit: the part of memoryLimit reserved for PARTITION_INTERACTIVE,
+   *                                the rest is for PARTITION_BULK
+   * @param nShards:                the number of shards, must be positive
+   * @param shardKeyLength:         the number of leading name components in the key, an Interest
+   *                                with a shorter name is looked up in every shard
+   */
+  ContentCache(size_t memoryLimit, size_t interactiveMemoryLimit,
+               size_t nShards, size_t shardKeyLength);
+
+  /**
+   * Store a signed packet, replacing the one with the same name
+   *
+   * A packet larger than the budget of its partition in a shard is not stored. A replaced
+   * packet moves to the partition of the new one.
+   */
+  void
+  insert(const std::shared_ptr<const ndn::Data>& data, Partition partition);
+
+  /**
+   * @return the packet that satisfies the Interest, or nullptr
+   */
+  std::shared_ptr<const ndn::Data>
+  find(const ndn::Interest& interest) const;
+
+  size_t
+  getNShards() const
+  {
+    return m_shards.size();
+  }
+
+  Statistics
+  getStatistics() const;
+
+private:
+  typedef std::list<const ndn::Name*> ClockList;
+
+  enum Area {
+    AREA_WINDOW,
+    AREA_MAIN,
+    AREA_N
+  };
+
+  struct Entry
+  {
+    Entry(const std::shared_ptr<const ndn::Data>& data,
+          size_t size,
+          const ndn::time::steady_clock::TimePoint& staleAt,
+          uint64_t keyHash,
+          Partition partition)
+      : data(data)
+      , size(size)
+      , staleAt(staleAt)
+      , keyHash(keyHash)
+      , partition(partition)
+      , area(AREA_WINDOW)
+      , isReferenced(false)
+    {
+    }
+
+    std::shared_ptr<const ndn::Data> data;
+    size_t size;
+    ndn::time::steady_clock::TimePoint staleAt;
+    uint64_t keyHash;
+    Partition partition;
+    Area area;
+    ClockList::iterator position;
+    // set by lookups, cleared when the entry gets its second chance
+    mutable std::atomic<bool> isReferenced;
+  };
+  typedef std::map<ndn::Name, Entry> EntryMap;
+
+  /**
+   * An area of a partition, the entries are in the order the CLOCK hand visits them
+   */
+  struct Region
+  {
+    ClockList clock;
+    size_t memoryUsage;
+    size_t memoryLimit;
+  };
+
+  struct Shard
+  {
+    explicit
+    Shard(size_t sketchWidth);
+
+    mutable boost::shared_mutex mutex;
+    // @{ needs the exclusive lock to change
+    EntryMap entries;
+    std::array<std::array<Region, AREA_N>, PARTITION_N> regions;
+    // @}
+    mutable FrequencySketch sketch;
+    mutable std::atomic<uint64_t> nMisses;
+    mutable std::array<std::atomic<uint64_t>, PARTITION_N> nHits;
+    std::array<std::atomic<uint64_t>, PARTITION_N> nInsertions;
+    std::array<std::atomic<uint64_t>, PARTITION_N> nEvictions;
+    std::array<std::atomic<uint64_t>, PARTITION_N> nEvictedBytes;
+    std::array<std::atomic<uint64_t>, PARTITION_N> nRejections;
+  };
+
+  uint64_t
+  getKeyHash(const ndn::Name& name) const;
+
+  /**
+   * Look up the Interest in one shard, the caller holds its lock
+   */
+  static const Entry*
+  findInShard(const Shard& shard, const ndn::Interest& interest,
+              const ndn::time::steady_clock::TimePoint& now);
+
+  /**
+   * Move the packets that overflow the window of the partition to the main area, and evict
+   * until both areas are within their budget. The caller holds the exclusive lock.
+   */
+  static void
+  evict(Shard& shard, Partition partition);
+
+  /**
+   * Advance the CLOCK hand of the region to the next entry that was not used since it was last
+   * visited, the region must not be empty
+   */
+  static EntryMap::iterator
+  selectVictim(Shard& shard, Region& region);
+
+  static void
+  erase(Shard& shard, EntryMap::iterator entry);
+
+private:
+  const size_t m_shardKeyLength;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_CONTENT_CACHE_HPP
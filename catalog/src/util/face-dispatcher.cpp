@@ -0,0 +1,160 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/face-dispatcher.hpp"
+#include "util/logger.hpp"
+
+#include <exception>
+#include <stdexcept>
+
+namespace atmos {
+namespace util {
+
+#ifdef HAVE_LOG4CXX
+  INIT_LOGGER("FaceDispatcher");
+#endif
+
+FaceDispatcher::FaceDispatcher(boost::asio::io_service& ioService,
+                               size_t queueLimit,
+                               const Sink& sink)
+  : m_ioService(ioService)
+  , m_queueLimit(queueLimit)
+  , m_sink(sink)
+  , m_head(nullptr)
+  , m_isDrainScheduled(false)
+  , m_queueLength(0)
+  , m_maxQueueLength(0)
+  , m_nDropped(0)
+  , m_nPackets(0)
+  , m_nBatches(0)
+  , m_maxBatchSize(0)
+  , m_totalHandOffMicroseconds(0)
+  , m_maxHandOffMicroseconds(0)
+{
+  if (m_queueLimit == 0) {
+    throw std::invalid_argument("FaceDispatcher needs a positive queue limit");
+  }
+}
+
+FaceDispatcher::~FaceDispatcher()
+{
+  Node* node = m_head.exchange(nullptr);
+  while (node != nullptr) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+bool
+FaceDispatcher::put(const std::shared_ptr<const ndn::Data>& data)
+{
+  // counted before the node is published, so a drain that takes it never decrements the length
+  // below zero
+  size_t length = ++m_queueLength;
+  if (length > m_queueLimit) {
+    --m_queueLength;
+    ++m_nDropped;
+    return false;
+  }
+  size_t maxLength = m_maxQueueLength.load(std::memory_order_relaxed);
+  while (length > maxLength && !m_maxQueueLength.compare_exchange_weak(maxLength, length)) {
+  }
+
+  Node* node = new Node{data, Clock::now(), m_head.load(std::memory_order_relaxed)};
+  while (!m_head.compare_exchange_weak(node->next, node,
+                                       std::memory_order_release, std::memory_order_relaxed)) {
+  }
+
+  // drain() clears the flag before it takes the list, so a packet pushed after that is either
+  // taken by the running drain or schedules the next one
+  if (!m_isDrainScheduled.exchange(true)) {
+    m_ioService.post(std::bind(&FaceDispatcher::drain, shared_from_this()));
+  }
+  return true;
+}
+
+FaceDispatcher::Statistics
+FaceDispatcher::getStatistics() const
+{
+  Statistics statistics;
+  statistics.nPackets = m_nPackets;
+  statistics.nBatches = m_nBatches;
+  statistics.nDropped = m_nDropped;
+  statistics.queueLength = m_queueLength;
+  statistics.maxQueueLength = m_maxQueueLength;
+  statistics.maxBatchSize = m_maxBatchSize;
+  statistics.totalHandOffMicroseconds = m_totalHandOffMicroseconds;
+  statistics.maxHandOffMicroseconds = m_maxHandOffMicroseconds;
+  return statistics;
+}
+
+void
+FaceDispatcher::drain()
+{
+  m_isDrainScheduled = false;
+  Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+  if (node == nullptr) {
+    return;
+  }
+
+  // reverse the list into push order
+  Node* batch = nullptr;
+  while (node != nullptr) {
+    Node* next = node->next;
+    node->next = batch;
+    batch = node;
+    node = next;
+  }
+
+  size_t batchSize = 0;
+  uint64_t totalHandOff = 0;
+  uint64_t maxHandOff = m_maxHandOffMicroseconds;
+  while (batch != nullptr) {
+    uint64_t handOff = std::chrono::duration_cast<std::chrono::microseconds>(
+                         Clock::now() - batch->enqueued).count();
+    totalHandOff += handOff;
+    if (handOff > maxHandOff) {
+      maxHandOff = handOff;
+    }
+
+    try {
+      m_sink(*batch->data);
+    }
+    catch (const std::exception& e) {
+      _LOG_ERROR("Cannot put " << batch->data->getName() << ": " << e.what());
+    }
+
+    Node* next = batch->next;
+    delete batch;
+    batch = next;
+    ++batchSize;
+  }
+
+  m_queueLength -= batchSize;
+  m_nPackets += batchSize;
+  ++m_nBatches;
+  if (batchSize > m_maxBatchSize) {
+    m_maxBatchSize = batchSize;
+  }
+  m_totalHandOffMicroseconds += totalHandOff;
+  m_maxHandOffMicroseconds = maxHandOff;
+}
+
+} // namespace util
+} // namespace atmos
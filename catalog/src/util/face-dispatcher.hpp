@@ -0,0 +1,136 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_FACE_DISPATCHER_HPP
+#define ATMOS_UTIL_FACE_DISPATCHER_HPP
+
+#include <ndn-cxx/data.hpp>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace atmos {
+namespace util {
+
+/**
+ * FaceDispatcher hands Data packets from any thread to the thread that runs the Face.
+ *
+ * Producers push onto a lock-free list and only the push that finds the list idle posts a
+ * drain task to the io_service, so a burst of segments costs one post. The drain task takes
+ * the whole list at once and puts the packets in the order they were pushed.
+ *
+ * The queue is bounded, and a packet that finds it full is dropped rather than blocking the
+ * producer: the adapters cache every packet before they put it, so the retransmitted Interest
+ * is answered from the cache once the Face thread catches up, while blocking would stall the
+ * query and signing threads behind it.
+ *
+ * The dispatcher must be owned by a std::shared_ptr, the posted drain task keeps it alive.
+ */
+class FaceDispatcher : public std::enable_shared_from_this<FaceDispatcher>,
+                       boost::noncopyable
+{
+public:
+  /**
+   * Called on the io_service thread for every packet, usually Face::put
+   */
+  typedef std::function<void(const ndn::Data&)> Sink;
+
+  /**
+   * Snapshot of the dispatcher counters
+   */
+  struct Statistics
+  {
+    uint64_t nPackets;              // packets given to the sink
+    uint64_t nBatches;              // drain tasks that put at least one packet
+    uint64_t nDropped;              // packets dropped because the queue was full
+    size_t queueLength;
+    size_t maxQueueLength;          // high-water mark of the queue
+    size_t maxBatchSize;
+    uint64_t totalHandOffMicroseconds; // time from put() to the sink for all packets
+    uint64_t maxHandOffMicroseconds;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param ioService:  the io_service of the Face
+   * @param queueLimit: the number of packets that can wait for the io_service thread
+   * @param sink:       called for every packet on the io_service thread
+   */
+  FaceDispatcher(boost::asio::io_service& ioService, size_t queueLimit, const Sink& sink);
+
+  /**
+   * Frees the packets that were never drained
+   */
+  ~FaceDispatcher();
+
+  /**
+   * Enqueue a packet, can be called from any thread and does not block
+   *
+   * @return false if the queue is full and the packet is dropped
+   */
+  bool
+  put(const std::shared_ptr<const ndn::Data>& data);
+
+  Statistics
+  getStatistics() const;
+
+private:
+  void
+  drain();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Node
+  {
+    std::shared_ptr<const ndn::Data> data;
+    Clock::time_point enqueued;
+    Node* next;
+  };
+
+  boost::asio::io_service& m_ioService;
+  const size_t m_queueLimit;
+  const Sink m_sink;
+
+  // most recently pushed packet first
+  std::atomic<Node*> m_head;
+  std::atomic<bool> m_isDrainScheduled;
+
+  std::atomic<size_t> m_queueLength;
+  std::atomic<size_t> m_maxQueueLength;
+  std::atomic<uint64_t> m_nDropped;
+  // @{ only written by drain()
+  std::atomic<uint64_t> m_nPackets;
+  std::atomic<uint64_t> m_nBatches;
+  std::atomic<size_t> m_maxBatchSize;
+  std::atomic<uint64_t> m_totalHandOffMicroseconds;
+  std::atomic<uint64_t> m_maxHandOffMicroseconds;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_FACE_DISPATCHER_HPP
@@ -0,0 +1,102 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/frequency-sketch.hpp"
+
+namespace atmos {
+namespace util {
+
+const uint8_t FrequencySketch::MAX_COUNT;
+const size_t FrequencySketch::N_ROWS;
+
+static size_t
+roundUpToPowerOfTwo(size_t n)
+{
+  size_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+
+FrequencySketch::FrequencySketch(size_t width)
+  : m_width(roundUpToPowerOfTwo(width))
+  , m_sampleSize(10 * m_width)
+  , m_counters(new std::atomic<uint8_t>[N_ROWS * m_width])
+  , m_nSamples(0)
+  , m_nResets(0)
+{
+  for (size_t i = 0; i < N_ROWS * m_width; ++i) {
+    m_counters[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void
+FrequencySketch::increment(uint64_t hash)
+{
+  for (size_t row = 0; row < N_ROWS; ++row) {
+    std::atomic<uint8_t>& counter = m_counters[getIndex(hash, row)];
+    uint8_t count = counter.load(std::memory_order_relaxed);
+    while (count < MAX_COUNT &&
+           !counter.compare_exchange_weak(count, count + 1, std::memory_order_relaxed)) {
+    }
+  }
+
+  // only the increment that completes the sample halves the counters
+  if (++m_nSamples == m_sampleSize) {
+    reset();
+  }
+}
+
+uint8_t
+FrequencySketch::estimate(uint64_t hash) const
+{
+  uint8_t minCount = MAX_COUNT;
+  for (size_t row = 0; row < N_ROWS; ++row) {
+    uint8_t count = m_counters[getIndex(hash, row)].load(std::memory_order_relaxed);
+    if (count < minCount) {
+      minCount = count;
+    }
+  }
+  return minCount;
+}
+
+size_t
+FrequencySketch::getIndex(uint64_t hash, size_t row) const
+{
+  // a different odd multiplier per row makes the rows independent
+  static const uint64_t SEEDS[N_ROWS] = {0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL,
+                                         0x165667b19e3779f9ULL, 0xd6e8feb86659fd93ULL};
+  uint64_t h = hash * SEEDS[row];
+  h ^= h >> 32;
+  return row * m_width + (h & (m_width - 1));
+}
+
+void
+FrequencySketch::reset()
+{
+  for (size_t i = 0; i < N_ROWS * m_width; ++i) {
+    m_counters[i].store(m_counters[i].load(std::memory_order_relaxed) >> 1,
+                        std::memory_order_relaxed);
+  }
+  m_nSamples -= m_sampleSize / 2;
+  ++m_nResets;
+}
+
+} // namespace util
+} // namespace atmos
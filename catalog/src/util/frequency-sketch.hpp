@@ -0,0 +1,95 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_FREQUENCY_SKETCH_HPP
+#define ATMOS_UTIL_FREQUENCY_SKETCH_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace atmos {
+namespace util {
+
+/**
+ * FrequencySketch estimates how often keys were seen recently, for TinyLFU cache admission.
+ *
+ * It is a Count-Min sketch of 4-bit counters: a key increments one counter in each of four rows
+ * and its estimate is the smallest of them. After a sample of ten times the row width, all
+ * counters are halved, so the estimates follow the recent popularity. The counters are atomic
+ * and can be incremented from any thread, concurrent updates may lose an increment.
+ */
+class FrequencySketch : boost::noncopyable
+{
+public:
+  static const uint8_t MAX_COUNT = 15;
+
+  /**
+   * Constructor
+   *
+   * @param width: the number of counters per row, rounded up to a power of two
+   */
+  explicit
+  FrequencySketch(size_t width);
+
+  /**
+   * Count one occurrence of the key
+   *
+   * @param hash: a hash of the key
+   */
+  void
+  increment(uint64_t hash);
+
+  /**
+   * @return the estimated number of recent occurrences of the key, at most MAX_COUNT
+   */
+  uint8_t
+  estimate(uint64_t hash) const;
+
+  /**
+   * @return the number of times the counters were halved
+   */
+  uint64_t
+  getNResets() const
+  {
+    return m_nResets;
+  }
+
+private:
+  size_t
+  getIndex(uint64_t hash, size_t row) const;
+
+  void
+  reset();
+
+private:
+  static const size_t N_ROWS = 4;
+
+  const size_t m_width;
+  const uint64_t m_sampleSize;
+  std::unique_ptr<std::atomic<uint8_t>[]> m_counters;
+  std::atomic<uint64_t> m_nSamples;
+  std::atomic<uint64_t> m_nResets;
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_FREQUENCY_SKETCH_HPP
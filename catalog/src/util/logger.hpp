@@ -57,6 +57,8 @@
 
 #else // HAVE_LOG4CXX
 
+#include <iostream>
+
 #define INIT_LOGGER(name)
 #define _LOG_FUNCTION(x)
 #define _LOG_FUNCTION_NOARGS
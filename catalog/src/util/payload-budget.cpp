@@ -0,0 +1,103 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/payload-budget.hpp"
+
+#include <ndn-cxx/encoding/tlv.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace atmos {
+namespace util {
+
+// ECDSA signatures are DER encoded and their size changes from one packet to the next
+static const size_t SIGNATURE_SIZE_SLACK = 8;
+
+PayloadBudget::PayloadBudget(size_t maxPacketSize, const Signer& signer)
+  : m_maxPacketSize(maxPacketSize)
+  , m_signer(signer)
+{
+  if (m_maxPacketSize == 0) {
+    throw std::invalid_argument("PayloadBudget needs a positive packet size");
+  }
+}
+
+size_t
+PayloadBudget::getPayloadLimit(const ndn::Name& segmentPrefix, const ndn::Name& signingId)
+{
+  // the largest segment component is the worst case for the name
+  ndn::Name segmentName(segmentPrefix);
+  segmentName.appendSegment(std::numeric_limits<uint64_t>::max());
+
+  // TLV value of the Data packet without the content bytes
+  size_t innerSize = getFixedOverhead(signingId) + segmentName.wireEncode().size();
+
+  // Data and Content lengths grow with the payload, so shrink until the packet fits
+  size_t payloadSize = (m_maxPacketSize > innerSize) ? m_maxPacketSize - innerSize : 0;
+  while (payloadSize > 0) {
+    size_t valueSize = innerSize + ndn::tlv::sizeOfVarNumber(payloadSize) - 1 + payloadSize;
+    size_t packetSize = 1 + ndn::tlv::sizeOfVarNumber(valueSize) + valueSize;
+    if (packetSize <= m_maxPacketSize) {
+      break;
+    }
+    payloadSize -= std::min(payloadSize, packetSize - m_maxPacketSize);
+  }
+
+  return std::max<size_t>(payloadSize, 1);
+}
+
+void
+PayloadBudget::reset()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_fixedOverheads.clear();
+}
+
+size_t
+PayloadBudget::getFixedOverhead(const ndn::Name& signingId)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_fixedOverheads.find(signingId);
+    if (it != m_fixedOverheads.end()) {
+      return it->second;
+    }
+  }
+
+  // the signer may take a while, it is run without the lock and the result is idempotent
+  ndn::Data data;
+  // a non-default content type, freshness period and final block id are the largest MetaInfo
+  data.setContentType(ndn::tlv::ContentType_Key);
+  data.setFreshnessPeriod(ndn::time::milliseconds(std::numeric_limits<int64_t>::max()));
+  data.setFinalBlockId(ndn::Name::Component::fromSegment(std::numeric_limits<uint64_t>::max()));
+  m_signer(data, signingId);
+
+  const ndn::Block& wire = data.wireEncode();
+  // the empty name is two bytes, and the empty Content TLV is kept since it is always encoded
+  size_t overhead = wire.value_size() - data.getName().wireEncode().size()
+                    + SIGNATURE_SIZE_SLACK;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_fixedOverheads[signingId] = overhead;
+  return overhead;
+}
+
+} // namespace util
+} // namespace atmos
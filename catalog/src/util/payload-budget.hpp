@@ -0,0 +1,99 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_PAYLOAD_BUDGET_HPP
+#define ATMOS_UTIL_PAYLOAD_BUDGET_HPP
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/name.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace atmos {
+namespace util {
+
+/**
+ * PayloadBudget computes how many content bytes fit in a signed Data packet.
+ *
+ * The overhead of MetaInfo and signature is measured once per signing identity by signing an
+ * empty Data packet with a worst-case MetaInfo. The name overhead only depends on the encoded
+ * name size, so it is computed for every segment prefix without signing again.
+ */
+class PayloadBudget : boost::noncopyable
+{
+public:
+  /**
+   * Signs the Data packet with the given signing identity, an empty identity is the default one
+   */
+  typedef std::function<void(ndn::Data& data, const ndn::Name& signingId)> Signer;
+
+  /**
+   * Constructor
+   *
+   * @param maxPacketSize: the size limit of a whole Data packet, e.g., ndn::MAX_NDN_PACKET_SIZE
+   *                       or the link MTU
+   * @param signer:        the function that signs the outgoing Data packets
+   */
+  PayloadBudget(size_t maxPacketSize, const Signer& signer);
+
+  /**
+   * Get the maximum content size of segment Data packets
+   *
+   * @param segmentPrefix: the Data name without the segment component
+   * @param signingId:     the identity that signs the segments
+   * @return the number of content bytes, at least 1 so that a segment can always be made
+   */
+  size_t
+  getPayloadLimit(const ndn::Name& segmentPrefix, const ndn::Name& signingId);
+
+  size_t
+  getMaxPacketSize() const
+  {
+    return m_maxPacketSize;
+  }
+
+  /**
+   * Forget the measured overheads, e.g., after the signing keys changed
+   */
+  void
+  reset();
+
+private:
+  /**
+   * @return the encoded size of the Data TLV value when the name and the content are empty
+   */
+  size_t
+  getFixedOverhead(const ndn::Name& signingId);
+
+private:
+  const size_t m_maxPacketSize;
+  const Signer m_signer;
+
+  std::mutex m_mutex;
+  std::map<ndn::Name, size_t> m_fixedOverheads;
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_PAYLOAD_BUDGET_HPP
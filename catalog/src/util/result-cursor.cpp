@@ -0,0 +1,180 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/result-cursor.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace atmos {
+namespace util {
+
+ResultCursor::ResultCursor(const RowFetcher& fetchRows,
+                           uint64_t lastRowId,
+                           size_t batchSize,
+                           size_t payloadLimit,
+                           const SegmentEncoder::SegmentCallback& onSegment,
+                           SegmentEncoder::Framing framing)
+  : m_fetchRows(fetchRows)
+  , m_lastRowId(lastRowId)
+  , m_batchSize(batchSize)
+  , m_payloadLimit(payloadLimit)
+  , m_encoder(framing, payloadLimit, onSegment)
+  , m_lastId(0)
+  , m_isExhausted(false)
+  , m_isFinished(false)
+  , m_nSegments(0)
+  , m_memoryUsage(payloadLimit)
+{
+  if (m_batchSize == 0) {
+    throw std::invalid_argument("ResultCursor needs a positive batch size");
+  }
+}
+
+bool
+ResultCursor::advance(uint64_t segmentNo)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // a segment is emitted when the first row of the next one arrives, or at the end
+  while (!m_isFinished && m_encoder.getNSegments() <= segmentNo) {
+    if (!m_pendingEntries.empty()) {
+      m_encoder.appendElement(m_pendingEntries.front());
+      m_pendingEntries.pop_front();
+      continue;
+    }
+
+    if (m_isExhausted) {
+      m_encoder.finish();
+      m_isFinished = true;
+      break;
+    }
+
+    std::vector<std::string> entries;
+    uint64_t lastId = m_lastId;
+    if (!m_fetchRows(m_lastId, m_lastRowId, m_batchSize, entries, lastId)) {
+      break;
+    }
+    // a short batch is the last one, as is a batch that reaches the end of the snapshot
+    m_isExhausted = (entries.size() < m_batchSize || lastId >= m_lastRowId);
+    m_lastId = lastId;
+    m_pendingEntries.assign(entries.begin(), entries.end());
+  }
+
+  size_t memoryUsage = m_payloadLimit;
+  for (const auto& entry : m_pendingEntries) {
+    memoryUsage += entry.size();
+  }
+  m_memoryUsage = memoryUsage;
+  m_nSegments = m_encoder.getNSegments();
+
+  return m_nSegments > segmentNo;
+}
+
+ResultCursorTable::ResultCursorTable(std::chrono::milliseconds timeToLive, size_t memoryLimit)
+  : m_timeToLive(timeToLive)
+  , m_memoryLimit(memoryLimit)
+  , m_nOpened(0)
+  , m_nExpired(0)
+  , m_nEvicted(0)
+{
+}
+
+std::shared_ptr<ResultCursor>
+ResultCursorTable::find(const std::string& key)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(key);
+  if (it == m_index.end()) {
+    return nullptr;
+  }
+
+  it->second->lastUsed = Clock::now();
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return it->second->cursor;
+}
+
+void
+ResultCursorTable::insert(const std::string& key, const std::shared_ptr<ResultCursor>& cursor)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    erase(it->second);
+  }
+
+  m_entries.push_front(Entry{key, cursor, Clock::now()});
+  m_index[key] = m_entries.begin();
+  ++m_nOpened;
+}
+
+void
+ResultCursorTable::cleanup()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Clock::time_point expiry = Clock::now() - m_timeToLive;
+
+  size_t memoryUsage = 0;
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (it->cursor->isFinished()) {
+      // its segments are all in the cache
+      erase(it++);
+    }
+    else if (it->lastUsed < expiry) {
+      ++m_nExpired;
+      erase(it++);
+    }
+    else {
+      memoryUsage += it->cursor->getMemoryUsage();
+      ++it;
+    }
+  }
+
+  while (memoryUsage > m_memoryLimit && !m_entries.empty()) {
+    memoryUsage -= std::min(memoryUsage, m_entries.back().cursor->getMemoryUsage());
+    ++m_nEvicted;
+    erase(std::prev(m_entries.end()));
+  }
+}
+
+ResultCursorTable::Statistics
+ResultCursorTable::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Statistics statistics;
+  statistics.nCursors = m_entries.size();
+  statistics.memoryUsage = 0;
+  for (const auto& entry : m_entries) {
+    statistics.memoryUsage += entry.cursor->getMemoryUsage();
+  }
+  statistics.nOpened = m_nOpened;
+  statistics.nExpired = m_nExpired;
+  statistics.nEvicted = m_nEvicted;
+  return statistics;
+}
+
+void
+ResultCursorTable::erase(EntryList::iterator entry)
+{
+  m_index.erase(entry->key);
+  m_entries.erase(entry);
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,226 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_RESULT_CURSOR_HPP
+#define ATMOS_UTIL_RESULT_CURSOR_HPP
+
+#include "util/segment-encoder.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * ResultCursor produces the segments of one query result on demand.
+ *
+ * Rows are read in batches with keyset pagination: every batch starts after the largest row
+ * id of the previous one, so no database connection or result set is held between Interests.
+ * The cursor only keeps the rows of the current batch and the segment being filled.
+ *
+ * The result is the rows up to the largest id when the cursor is opened: rows published
+ * while it is read do not change a result that has been named and partly sent already.
+ */
+class ResultCursor : boost::noncopyable
+{
+public:
+  /**
+   * Reads the next batch of rows in ascending id order
+   *
+   * @param afterId: only rows with a larger id are returned, 0 for the first batch
+   * @param upToId:  only rows with this or a smaller id are returned
+   * @param limit:   the maximum number of rows
+   * @param entries: to save the encoded result of every row
+   * @param lastId:  to save the id of the last row
+   * @return false if the rows cannot be read now
+   */
+  typedef std::function<bool(uint64_t afterId,
+                             uint64_t upToId,
+                             size_t limit,
+                             std::vector<std::string>& entries,
+                             uint64_t& lastId)> RowFetcher;
+
+  /**
+   * Constructor
+   *
+   * @param fetchRows:    reads the batches
+   * @param lastRowId:    the largest row id when the cursor is opened, the end of the result
+   * @param batchSize:    the number of rows read at a time
+   * @param payloadLimit: the size limit of the results in a segment
+   * @param onSegment:    called for every segment that is produced, in order
+   * @param framing:      how the results are laid out in a segment, a Json array or TLV
+   *                      elements
+   */
+  ResultCursor(const RowFetcher& fetchRows,
+               uint64_t lastRowId,
+               size_t batchSize,
+               size_t payloadLimit,
+               const SegmentEncoder::SegmentCallback& onSegment,
+               SegmentEncoder::Framing framing = SegmentEncoder::FRAMING_JSON_ARRAY);
+
+  /**
+   * Produce segments until the given segment exists or the result ends
+   *
+   * Concurrent calls are serialized, segments that exist already are not produced again.
+   *
+   * @return true if the segment has been produced by this or an earlier call
+   */
+  bool
+  advance(uint64_t segmentNo);
+
+  /**
+   * @return whether the final segment has been produced
+   */
+  bool
+  isFinished() const
+  {
+    return m_isFinished;
+  }
+
+  /**
+   * @return the number of segments produced so far
+   */
+  uint64_t
+  getNSegments() const
+  {
+    return m_nSegments;
+  }
+
+  /**
+   * @return the approximate number of bytes held by the cursor
+   */
+  size_t
+  getMemoryUsage() const
+  {
+    return m_memoryUsage;
+  }
+
+private:
+  const RowFetcher m_fetchRows;
+  const uint64_t m_lastRowId;
+  const size_t m_batchSize;
+  const size_t m_payloadLimit;
+
+  std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  SegmentEncoder m_encoder;
+  std::deque<std::string> m_pendingEntries;
+  uint64_t m_lastId;
+  bool m_isExhausted;
+  // @}
+  std::atomic<bool> m_isFinished;
+  std::atomic<uint64_t> m_nSegments;
+  std::atomic<size_t> m_memoryUsage;
+};
+
+/**
+ * ResultCursorTable keeps the open cursors, keyed by the segment prefix of the result.
+ *
+ * A cursor is dropped when it has not been used for the time-to-live or has produced its final
+ * segment, and the least recently used cursors are dropped when the cursors together hold
+ * more memory than the limit.
+ */
+class ResultCursorTable : boost::noncopyable
+{
+public:
+  struct Statistics
+  {
+    size_t nCursors;
+    size_t memoryUsage;
+    uint64_t nOpened;
+    uint64_t nExpired;
+    uint64_t nEvicted;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param timeToLive:  how long an unused cursor is kept
+   * @param memoryLimit: the number of bytes all cursors may hold
+   */
+  ResultCursorTable(std::chrono::milliseconds timeToLive, size_t memoryLimit);
+
+  /**
+   * Find a cursor and mark it as recently used
+   *
+   * @return the cursor, or nullptr if there is none
+   */
+  std::shared_ptr<ResultCursor>
+  find(const std::string& key);
+
+  /**
+   * Add or replace a cursor
+   */
+  void
+  insert(const std::string& key, const std::shared_ptr<ResultCursor>& cursor);
+
+  /**
+   * Drop the finished and expired cursors, then the least recently used ones until the
+   * memory limit is met
+   */
+  void
+  cleanup();
+
+  Statistics
+  getStatistics() const;
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Entry
+  {
+    std::string key;
+    std::shared_ptr<ResultCursor> cursor;
+    Clock::time_point lastUsed;
+  };
+  // most recently used first
+  typedef std::list<Entry> EntryList;
+
+  void
+  erase(EntryList::iterator entry);
+
+private:
+  const std::chrono::milliseconds m_timeToLive;
+  const size_t m_memoryLimit;
+
+  mutable std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  EntryList m_entries;
+  std::unordered_map<std::string, EntryList::iterator> m_index;
+  uint64_t m_nOpened;
+  uint64_t m_nExpired;
+  uint64_t m_nEvicted;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_RESULT_CURSOR_HPP
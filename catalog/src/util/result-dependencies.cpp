@@ -0,0 +1,215 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/result-dependencies.hpp"
+#include "index/catalog-index.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace atmos {
+namespace util {
+
+static std::string
+toLower(const std::string& value)
+{
+  std::string lower(value);
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [] (unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return lower;
+}
+
+ResultDependencies::ResultDependencies(size_t maxEntries)
+  : m_maxEntries(std::max<size_t>(maxEntries, 1))
+  , m_sequence(0)
+  , m_nAdded(0)
+  , m_nOutdated(0)
+  , m_nInvalidated(0)
+  , m_nEvicted(0)
+{
+}
+
+uint64_t
+ResultDependencies::getSequence() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_sequence;
+}
+
+void
+ResultDependencies::add(const std::string& key, const std::string& version,
+                        const Predicate& predicate, uint64_t sequence)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto existing = m_entries.find(key);
+  if (existing != m_entries.end()) {
+    erase(existing);
+  }
+  if (sequence != m_sequence) {
+    ++m_nOutdated;
+    return;
+  }
+
+  Entry entry;
+  entry.version = version;
+  entry.isIndexed = false;
+  for (const auto& condition : predicate) {
+    Condition lowerCondition = {condition.field, toLower(condition.pattern)};
+    entry.predicate.push_back(lowerCondition);
+    if (!entry.isIndexed &&
+        lowerCondition.pattern.find_first_of("%_\\") == std::string::npos) {
+      entry.isIndexed = true;
+      entry.indexKey = std::make_pair(lowerCondition.field, lowerCondition.pattern);
+    }
+  }
+
+  if (entry.isIndexed) {
+    m_byValue[entry.indexKey].insert(key);
+  }
+  else {
+    m_unindexed.insert(key);
+  }
+  entry.order = m_order.insert(m_order.end(), key);
+  m_entries.emplace(key, std::move(entry));
+  ++m_nAdded;
+
+  while (m_entries.size() > m_maxEntries) {
+    erase(m_entries.find(m_order.front()));
+    ++m_nEvicted;
+  }
+}
+
+bool
+ResultDependencies::find(const std::string& key, std::string& version) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto entry = m_entries.find(key);
+  if (entry == m_entries.end()) {
+    return false;
+  }
+  version = entry->second.version;
+  return true;
+}
+
+void
+ResultDependencies::invalidate(const std::vector<std::string>& fieldValues)
+{
+  std::vector<std::string> lowerValues(fieldValues.size());
+  std::transform(fieldValues.begin(), fieldValues.end(), lowerValues.begin(), &toLower);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_sequence;
+
+  std::vector<std::string> invalidated;
+  for (const auto& key : m_unindexed) {
+    if (matches(m_entries[key].predicate, lowerValues)) {
+      invalidated.push_back(key);
+    }
+  }
+  for (size_t field = 0; field < lowerValues.size(); ++field) {
+    auto candidates = m_byValue.find(std::make_pair(field, lowerValues[field]));
+    if (candidates == m_byValue.end()) {
+      continue;
+    }
+    for (const auto& key : candidates->second) {
+      if (matches(m_entries[key].predicate, lowerValues)) {
+        invalidated.push_back(key);
+      }
+    }
+  }
+  // entries indexed by a field the name does not have
+  for (auto candidates = m_byValue.lower_bound(std::make_pair(lowerValues.size(), std::string()));
+       candidates != m_byValue.end(); ++candidates) {
+    for (const auto& key : candidates->second) {
+      if (matches(m_entries[key].predicate, lowerValues)) {
+        invalidated.push_back(key);
+      }
+    }
+  }
+
+  for (const auto& key : invalidated) {
+    auto entry = m_entries.find(key);
+    if (entry != m_entries.end()) {
+      erase(entry);
+      ++m_nInvalidated;
+    }
+  }
+}
+
+void
+ResultDependencies::invalidateAll()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_sequence;
+  m_nInvalidated += m_entries.size();
+  m_entries.clear();
+  m_order.clear();
+  m_byValue.clear();
+  m_unindexed.clear();
+}
+
+ResultDependencies::Statistics
+ResultDependencies::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Statistics statistics;
+  statistics.nEntries = m_entries.size();
+  statistics.nAdded = m_nAdded;
+  statistics.nOutdated = m_nOutdated;
+  statistics.nInvalidated = m_nInvalidated;
+  statistics.nEvicted = m_nEvicted;
+  return statistics;
+}
+
+bool
+ResultDependencies::matches(const Predicate& predicate,
+                            const std::vector<std::string>& fieldValues)
+{
+  for (const auto& condition : predicate) {
+    // a field the name does not have, or an escape that LIKE would interpret, cannot be
+    // ruled out
+    if (condition.field >= fieldValues.size() ||
+        condition.pattern.find('\\') != std::string::npos) {
+      continue;
+    }
+    if (!index::matchLikePattern(fieldValues[condition.field], condition.pattern)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+ResultDependencies::erase(EntryMap::iterator entry)
+{
+  if (entry->second.isIndexed) {
+    auto keys = m_byValue.find(entry->second.indexKey);
+    keys->second.erase(entry->first);
+    if (keys->second.empty()) {
+      m_byValue.erase(keys);
+    }
+  }
+  else {
+    m_unindexed.erase(entry->first);
+  }
+  m_order.erase(entry->second.order);
+  m_entries.erase(entry);
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,164 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_RESULT_DEPENDENCIES_HPP
+#define ATMOS_UTIL_RESULT_DEPENDENCIES_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * ResultDependencies keeps, for every query, the version of its latest results and the name
+ * field values these results depend on.
+ *
+ * A publication change only invalidates the results whose conditions match one of the
+ * added or removed names, so the results of the other queries are still served after the
+ * catalog version has moved on. Matching is conservative: patterns are compared without
+ * case, and a condition that cannot be evaluated matches.
+ *
+ * Results are indexed by one of their exact conditions, so a change only checks the results
+ * that have this field value or no exact condition at all.
+ */
+class ResultDependencies : boost::noncopyable
+{
+public:
+  /**
+   * The results depend on the catalog names whose field matches the SQL LIKE pattern
+   */
+  struct Condition
+  {
+    size_t field;
+    std::string pattern;
+  };
+  // all conditions must match, no condition depends on every name
+  typedef std::vector<Condition> Predicate;
+
+  struct Statistics
+  {
+    size_t nEntries;
+    uint64_t nAdded;
+    uint64_t nOutdated;
+    uint64_t nInvalidated;
+    uint64_t nEvicted;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param maxEntries: the number of queries that are tracked, the oldest entries are dropped
+   */
+  explicit
+  ResultDependencies(size_t maxEntries);
+
+  /**
+   * @return the number of changes so far, to be passed to add()
+   */
+  uint64_t
+  getSequence() const;
+
+  /**
+   * Record the results of a query, replacing earlier ones
+   *
+   * @param key:       the query, e.g. /<prefix>/query/<query-params>
+   * @param version:   the version of the results
+   * @param predicate: the conditions of the query
+   * @param sequence:  getSequence() from before the query read the catalog. The results are
+   *                   not recorded if a change has arrived since then, it may be missing.
+   */
+  void
+  add(const std::string& key, const std::string& version, const Predicate& predicate,
+      uint64_t sequence);
+
+  /**
+   * Find the version of the latest results of a query that are still valid
+   *
+   * @return false if the query has no valid results
+   */
+  bool
+  find(const std::string& key, std::string& version) const;
+
+  /**
+   * Invalidate the results that depend on an added or removed name
+   *
+   * @param fieldValues: the name fields of the catalog name
+   */
+  void
+  invalidate(const std::vector<std::string>& fieldValues);
+
+  /**
+   * Invalidate all results, e.g. for a change that cannot be split into name fields
+   */
+  void
+  invalidateAll();
+
+  Statistics
+  getStatistics() const;
+
+private:
+  struct Entry
+  {
+    std::string version;
+    Predicate predicate;
+    // the exact condition the entry is indexed by, or none
+    bool isIndexed;
+    std::pair<size_t, std::string> indexKey;
+    std::list<std::string>::iterator order;
+  };
+  typedef std::unordered_map<std::string, Entry> EntryMap;
+
+  static bool
+  matches(const Predicate& predicate, const std::vector<std::string>& fieldValues);
+
+  void
+  erase(EntryMap::iterator entry);
+
+private:
+  const size_t m_maxEntries;
+
+  mutable std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  EntryMap m_entries;
+  // oldest first
+  std::list<std::string> m_order;
+  // keys of the entries by (field, lower-case value) of their exact condition
+  std::map<std::pair<size_t, std::string>, std::set<std::string>> m_byValue;
+  // keys of the entries without an exact condition
+  std::set<std::string> m_unindexed;
+  uint64_t m_sequence;
+  uint64_t m_nAdded;
+  uint64_t m_nOutdated;
+  uint64_t m_nInvalidated;
+  uint64_t m_nEvicted;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_RESULT_DEPENDENCIES_HPP
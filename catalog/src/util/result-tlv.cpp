@@ -0,0 +1,146 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/result-tlv.hpp"
+
+#include <ndn-cxx/name.hpp>
+
+#include <exception>
+
+namespace atmos {
+namespace util {
+
+// TLV types of the NDN packet format
+static const uint64_t TLV_NAME = 7;
+static const uint64_t TLV_GENERIC_NAME_COMPONENT = 8;
+
+static size_t
+sizeOfVarNumber(uint64_t number)
+{
+  return number < 253 ? 1 : number <= 0xFFFF ? 3 : number <= 0xFFFFFFFF ? 5 : 9;
+}
+
+static void
+appendVarNumber(std::string& out, uint64_t number)
+{
+  size_t nBytes = 0;
+  if (number < 253) {
+    out.push_back(static_cast<char>(number));
+    return;
+  }
+  else if (number <= 0xFFFF) {
+    out.push_back(static_cast<char>(253));
+    nBytes = 2;
+  }
+  else if (number <= 0xFFFFFFFF) {
+    out.push_back(static_cast<char>(254));
+    nBytes = 4;
+  }
+  else {
+    out.push_back(static_cast<char>(255));
+    nBytes = 8;
+  }
+  // network byte order
+  for (size_t i = nBytes; i > 0; --i) {
+    out.push_back(static_cast<char>((number >> ((i - 1) * 8)) & 0xFF));
+  }
+}
+
+static void
+appendNonNegativeIntegerBlock(std::string& out, uint64_t type, uint64_t value)
+{
+  size_t nBytes = value <= 0xFF ? 1 : value <= 0xFFFF ? 2 : value <= 0xFFFFFFFF ? 4 : 8;
+  appendVarNumber(out, type);
+  appendVarNumber(out, nBytes);
+  for (size_t i = nBytes; i > 0; --i) {
+    out.push_back(static_cast<char>((value >> ((i - 1) * 8)) & 0xFF));
+  }
+}
+
+void
+encodeResultTlv(std::string& entry, const char* name, bool hasMetadata, bool isRemoved)
+{
+  // the component values, which the Name parser has unescaped
+  ndn::Name parsedName;
+  bool isParsed = true;
+  if (name != nullptr) {
+    try {
+      parsedName = ndn::Name(name);
+    }
+    catch (const std::exception&) {
+      isParsed = false;
+    }
+  }
+
+  size_t nameLength = 0;
+  if (isParsed) {
+    for (const auto& component : parsedName) {
+      nameLength += 1 + sizeOfVarNumber(component.value_size()) + component.value_size();
+    }
+  }
+  else {
+    size_t size = std::char_traits<char>::length(name);
+    nameLength = 1 + sizeOfVarNumber(size) + size;
+  }
+
+  size_t resultLength = 1 + sizeOfVarNumber(nameLength) + nameLength +
+                        (hasMetadata ? 2 : 0) + (isRemoved ? 2 : 0);
+  entry.clear();
+  entry.reserve(2 + sizeOfVarNumber(resultLength) + resultLength);
+  appendVarNumber(entry, tlv::Result);
+  appendVarNumber(entry, resultLength);
+
+  appendVarNumber(entry, TLV_NAME);
+  appendVarNumber(entry, nameLength);
+  if (isParsed) {
+    for (const auto& component : parsedName) {
+      appendVarNumber(entry, TLV_GENERIC_NAME_COMPONENT);
+      appendVarNumber(entry, component.value_size());
+      entry.append(reinterpret_cast<const char*>(component.value()), component.value_size());
+    }
+  }
+  else {
+    appendVarNumber(entry, TLV_GENERIC_NAME_COMPONENT);
+    appendVarNumber(entry, std::char_traits<char>::length(name));
+    entry.append(name);
+  }
+
+  if (hasMetadata) {
+    appendVarNumber(entry, tlv::HasMetadata);
+    appendVarNumber(entry, 0);
+  }
+  if (isRemoved) {
+    appendVarNumber(entry, tlv::Removed);
+    appendVarNumber(entry, 0);
+  }
+}
+
+void
+encodeReplyTlv(std::string& content, const std::string& encodedResults, uint64_t resultCount,
+               uint64_t viewStart, uint64_t viewEnd)
+{
+  content.clear();
+  content.reserve(encodedResults.size() + 3 * 11);
+  appendNonNegativeIntegerBlock(content, tlv::ResultCount, resultCount);
+  appendNonNegativeIntegerBlock(content, tlv::ViewStart, viewStart);
+  appendNonNegativeIntegerBlock(content, tlv::ViewEnd, viewEnd);
+  content.append(encodedResults);
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,78 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_RESULT_TLV_HPP
+#define ATMOS_UTIL_RESULT_TLV_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace atmos {
+namespace util {
+
+namespace tlv {
+
+/**
+ * TLV types of the binary query results, from the application range. The content of a
+ * query-results segment is
+ *
+ *   ResultCount ViewStart ViewEnd Result*
+ *
+ * with the counts as NonNegativeIntegers, and every result is
+ *
+ *   Result ::= RESULT-TYPE TLV-LENGTH Name [HasMetadata] [Removed]
+ *
+ * where HasMetadata and Removed are empty flags, Removed only in the answers of delta queries.
+ */
+enum {
+  ResultCount = 128,
+  ViewStart   = 129,
+  ViewEnd     = 130,
+  Result      = 131,
+  HasMetadata = 132,
+  Removed     = 133
+};
+
+} // namespace tlv
+
+/**
+ * Encode one query result as a Result element
+ *
+ * @param entry:       string to save the element, previous content is discarded
+ * @param name:        the catalog name as a URI, may be NULL. A name that cannot be parsed is
+ *                     encoded as a single component that holds the whole string.
+ * @param hasMetadata: the has_metadata flag of the record
+ * @param isRemoved:   whether the name was removed from the results of a delta query
+ */
+void
+encodeResultTlv(std::string& entry, const char* name, bool hasMetadata, bool isRemoved);
+
+/**
+ * Write the content of a query-results segment in the binary encoding
+ *
+ * @param content:        string to save the content, previous content is discarded
+ * @param encodedResults: the Result elements of the segment, as produced by encodeResultTlv
+ */
+void
+encodeReplyTlv(std::string& content, const std::string& encodedResults, uint64_t resultCount,
+               uint64_t viewStart, uint64_t viewEnd);
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_RESULT_TLV_HPP
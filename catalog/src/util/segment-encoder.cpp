@@ -0,0 +1,123 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/segment-encoder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace atmos {
+namespace util {
+
+SegmentEncoder::SegmentEncoder(Framing framing,
+                               size_t payloadLimit,
+                               const SegmentCallback& onSegment)
+  : m_framing(framing)
+  , m_payloadLimit(payloadLimit)
+  , m_onSegment(onSegment)
+  , m_segmentNo(0)
+  , m_nItems(0)
+  , m_viewStart(0)
+  , m_isFinished(false)
+{
+  if (m_payloadLimit == 0) {
+    throw std::invalid_argument("SegmentEncoder needs a positive payload limit");
+  }
+
+  m_buffer.reserve(m_payloadLimit + 1);
+  if (m_framing == FRAMING_JSON_ARRAY) {
+    m_buffer.push_back('[');
+  }
+}
+
+void
+SegmentEncoder::appendElement(const std::string& element)
+{
+  if (m_framing == FRAMING_RAW || m_isFinished) {
+    throw std::logic_error("SegmentEncoder cannot take an element");
+  }
+
+  bool isJson = (m_framing == FRAMING_JSON_ARRAY);
+  bool isEmpty = (m_nItems == m_viewStart);
+  // element, and the separator and closing bracket of a Json array
+  size_t newSize = m_buffer.size() + element.size() + (isJson ? (isEmpty ? 0 : 1) + 1 : 0);
+  if (!isEmpty && newSize > m_payloadLimit) {
+    emit(false);
+    isEmpty = true;
+  }
+
+  if (isJson && !isEmpty) {
+    m_buffer.push_back(',');
+  }
+  m_buffer.append(element);
+  ++m_nItems;
+}
+
+void
+SegmentEncoder::appendBytes(const char* bytes, size_t length)
+{
+  if (m_framing != FRAMING_RAW || m_isFinished) {
+    throw std::logic_error("SegmentEncoder cannot take raw bytes");
+  }
+
+  // a full buffer is only emitted once more bytes arrive, so that the last segment is always
+  // emitted by finish() and carries the final block flag
+  while (length > 0) {
+    if (m_buffer.size() == m_payloadLimit) {
+      emit(false);
+    }
+    size_t chunk = std::min(length, m_payloadLimit - m_buffer.size());
+    m_buffer.append(bytes, chunk);
+    m_nItems += chunk;
+    bytes += chunk;
+    length -= chunk;
+  }
+}
+
+void
+SegmentEncoder::finish()
+{
+  if (m_isFinished) {
+    return;
+  }
+  emit(true);
+  m_isFinished = true;
+}
+
+void
+SegmentEncoder::emit(bool isFinal)
+{
+  if (m_framing == FRAMING_JSON_ARRAY) {
+    m_buffer.push_back(']');
+  }
+
+  uint64_t viewEnd = (m_nItems > m_viewStart) ? m_nItems - 1 : m_viewStart;
+  m_onSegment(m_buffer, m_segmentNo, m_viewStart, viewEnd, isFinal);
+
+  ++m_segmentNo;
+  m_viewStart = m_nItems;
+
+  // keep the allocated capacity for the next segment
+  m_buffer.clear();
+  if (m_framing == FRAMING_JSON_ARRAY) {
+    m_buffer.push_back('[');
+  }
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,132 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_SEGMENT_ENCODER_HPP
+#define ATMOS_UTIL_SEGMENT_ENCODER_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace atmos {
+namespace util {
+
+/**
+ * SegmentEncoder cuts a stream of encoded items into segment payloads.
+ *
+ * Items are copied once into a reusable buffer while a running byte count is kept, and a
+ * segment is handed to the callback as soon as the next item would push the buffer over the
+ * payload limit. The last segment is only emitted by finish(), so it can be flagged as final.
+ */
+class SegmentEncoder : boost::noncopyable
+{
+public:
+  enum Framing {
+    /// every segment is a Json array, items are Json values that are never split
+    FRAMING_JSON_ARRAY,
+    /// the payload is a byte stream cut at the payload limit, the consumer concatenates it
+    FRAMING_RAW,
+    /// every segment is a sequence of TLV elements, items are whole elements that are never split
+    FRAMING_TLV
+  };
+
+  /**
+   * Callback for a finished segment
+   *
+   * @param payload:   the segment payload, only valid during the call
+   * @param segmentNo: the segment number, starting from 0
+   * @param viewStart: index of the first item (byte for FRAMING_RAW) in the segment
+   * @param viewEnd:   index of the last item (byte for FRAMING_RAW) in the segment
+   * @param isFinal:   whether this is the last segment
+   */
+  typedef std::function<void(const std::string& payload,
+                             uint64_t segmentNo,
+                             uint64_t viewStart,
+                             uint64_t viewEnd,
+                             bool isFinal)> SegmentCallback;
+
+  /**
+   * Constructor
+   *
+   * @param framing:      how items are laid out in a segment
+   * @param payloadLimit: the maximum payload size of a segment in bytes
+   * @param onSegment:    callback for every finished segment
+   */
+  SegmentEncoder(Framing framing, size_t payloadLimit, const SegmentCallback& onSegment);
+
+  /**
+   * Add an encoded Json value as the next array element, FRAMING_JSON_ARRAY, or an encoded
+   * TLV element, FRAMING_TLV
+   *
+   * An item that does not fit in an empty segment is emitted alone in an oversized segment.
+   */
+  void
+  appendElement(const std::string& element);
+
+  /**
+   * Add bytes to the stream, FRAMING_RAW only
+   */
+  void
+  appendBytes(const char* bytes, size_t length);
+
+  /**
+   * Emit the remaining items as the final segment. Nothing can be appended afterwards.
+   */
+  void
+  finish();
+
+  /**
+   * @return the number of segments emitted so far
+   */
+  uint64_t
+  getNSegments() const
+  {
+    return m_segmentNo;
+  }
+
+  /**
+   * @return the number of items (bytes for FRAMING_RAW) appended so far
+   */
+  uint64_t
+  getNItems() const
+  {
+    return m_nItems;
+  }
+
+private:
+  void
+  emit(bool isFinal);
+
+private:
+  const Framing m_framing;
+  const size_t m_payloadLimit;
+  const SegmentCallback m_onSegment;
+
+  std::string m_buffer;
+  uint64_t m_segmentNo;
+  uint64_t m_nItems;
+  uint64_t m_viewStart;
+  bool m_isFinished;
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_SEGMENT_ENCODER_HPP
@@ -0,0 +1,83 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/segment-manifest.hpp"
+
+#include <ndn-cxx/util/digest.hpp>
+
+namespace atmos {
+namespace util {
+
+void
+SegmentManifest::add(const ndn::Data& segment)
+{
+  // the implicit digest is the SHA-256 of the whole packet, signature included
+  const ndn::name::Component& digest = segment.getFullName().get(-1);
+  ndn::ConstBufferPtr leaf = std::make_shared<ndn::Buffer>(digest.value(), digest.value_size());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_digests.push_back(leaf);
+}
+
+size_t
+SegmentManifest::getNSegments() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_digests.size();
+}
+
+ndn::ConstBufferPtr
+SegmentManifest::computeRoot() const
+{
+  std::vector<ndn::ConstBufferPtr> leaves;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    leaves = m_digests;
+  }
+  return computeRoot(std::move(leaves));
+}
+
+ndn::ConstBufferPtr
+SegmentManifest::computeRoot(std::vector<ndn::ConstBufferPtr> leaves)
+{
+  if (leaves.empty()) {
+    ndn::util::Sha256 empty;
+    return empty.computeDigest();
+  }
+
+  // every pass halves the level in place
+  size_t levelSize = leaves.size();
+  while (levelSize > 1) {
+    size_t parentSize = 0;
+    for (size_t i = 0; i < levelSize; i += 2) {
+      if (i + 1 == levelSize) {
+        leaves[parentSize++] = leaves[i];
+        continue;
+      }
+      ndn::util::Sha256 parent;
+      parent.update(leaves[i]->buf(), leaves[i]->size());
+      parent.update(leaves[i + 1]->buf(), leaves[i + 1]->size());
+      leaves[parentSize++] = parent.computeDigest();
+    }
+    levelSize = parentSize;
+  }
+  return leaves.front();
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,75 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_SEGMENT_MANIFEST_HPP
+#define ATMOS_UTIL_SEGMENT_MANIFEST_HPP
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * SegmentManifest collects the implicit digests of the segments of one result, so that a
+ * single signed packet can cover all of them.
+ *
+ * The segments themselves only carry a SHA-256 digest signature. The manifest holds the Merkle
+ * root of their implicit digests, in segment order: a parent is the SHA-256 of its two children
+ * concatenated, and an odd node at the end of a level is carried up unchanged.
+ */
+class SegmentManifest : boost::noncopyable
+{
+public:
+  /**
+   * Add the next segment, segments must be added in order
+   *
+   * @param segment: the signed segment
+   */
+  void
+  add(const ndn::Data& segment);
+
+  size_t
+  getNSegments() const;
+
+  /**
+   * @return the Merkle root of the segments added so far
+   */
+  ndn::ConstBufferPtr
+  computeRoot() const;
+
+  /**
+   * @return the Merkle root of the given leaves, the SHA-256 of nothing if there are none
+   */
+  static ndn::ConstBufferPtr
+  computeRoot(std::vector<ndn::ConstBufferPtr> leaves);
+
+private:
+  mutable std::mutex m_mutex;
+  std::vector<ndn::ConstBufferPtr> m_digests;
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_SEGMENT_MANIFEST_HPP
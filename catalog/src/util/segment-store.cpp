@@ -0,0 +1,252 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/segment-store.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace atmos {
+namespace util {
+
+#ifdef HAVE_LOG4CXX
+  INIT_LOGGER("SegmentStore");
+#endif
+
+const size_t SegmentStore::MAX_VERSION_SIZE;
+
+// header: magic, format, version size, version
+static const char MAGIC[8] = {'A', 'T', 'M', 'O', 'S', 'S', 'E', 'G'};
+static const uint32_t FORMAT = 1;
+static const size_t FORMAT_OFFSET = sizeof(MAGIC);
+static const size_t VERSION_SIZE_OFFSET = FORMAT_OFFSET + sizeof(uint32_t);
+static const size_t VERSION_OFFSET = VERSION_SIZE_OFFSET + sizeof(uint32_t);
+static const size_t HEADER_SIZE = VERSION_OFFSET + SegmentStore::MAX_VERSION_SIZE;
+
+// record: size, tag, checksum, reserved, then the bytes padded to 8
+static const size_t RECORD_HEADER_SIZE = 4 * sizeof(uint32_t);
+
+static size_t
+getRecordSize(size_t size)
+{
+  return RECORD_HEADER_SIZE + ((size + 7) & ~static_cast<size_t>(7));
+}
+
+static uint32_t
+load32(const uint8_t* p)
+{
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static void
+store32(uint8_t* p, uint32_t value)
+{
+  std::memcpy(p, &value, sizeof(value));
+}
+
+SegmentStore::SegmentStore(const std::string& path, size_t fileSize)
+  : m_path(path)
+  , m_fd(-1)
+  , m_map(nullptr)
+  , m_fileSize(fileSize)
+  , m_end(HEADER_SIZE)
+  , m_isVisited(false)
+  , m_statistics()
+{
+  if (m_fileSize < HEADER_SIZE + RECORD_HEADER_SIZE) {
+    throw Error("Segment store " + m_path + " is too small");
+  }
+
+  m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (m_fd < 0) {
+    throw Error("Cannot open segment store " + m_path + ": " + std::strerror(errno));
+  }
+
+  // a new file reads as zeros, which is an empty store without a version
+  if (::ftruncate(m_fd, m_fileSize) != 0) {
+    int error = errno;
+    ::close(m_fd);
+    throw Error("Cannot resize segment store " + m_path + ": " + std::strerror(error));
+  }
+
+  void* map = ::mmap(nullptr, m_fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (map == MAP_FAILED) {
+    int error = errno;
+    ::close(m_fd);
+    throw Error("Cannot map segment store " + m_path + ": " + std::strerror(error));
+  }
+  m_map = static_cast<uint8_t*>(map);
+
+  m_statistics.fileSize = m_fileSize;
+  scan();
+}
+
+SegmentStore::~SegmentStore()
+{
+  ::msync(m_map, m_fileSize, MS_ASYNC);
+  ::munmap(m_map, m_fileSize);
+  ::close(m_fd);
+}
+
+uint64_t
+SegmentStore::switchVersion(const std::string& version, const Visitor& visitor)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (version != m_version) {
+    reset(version);
+    return 0;
+  }
+  if (m_isVisited) {
+    return 0;
+  }
+  m_isVisited = true;
+
+  uint64_t nVisited = 0;
+  for (size_t offset = HEADER_SIZE; offset < m_end; ) {
+    size_t size = load32(m_map + offset);
+    visitor(m_map + offset + RECORD_HEADER_SIZE, size, load32(m_map + offset + 4));
+    offset += getRecordSize(size);
+    ++nVisited;
+  }
+  _LOG_DEBUG("Loaded " << nVisited << " records of version " << version << " from " << m_path);
+  return nVisited;
+}
+
+bool
+SegmentStore::append(const std::string& version, const uint8_t* wire, size_t size, uint32_t tag)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t recordSize = getRecordSize(size);
+  if (version != m_version || size == 0 || m_end + recordSize > m_fileSize) {
+    ++m_statistics.nDropped;
+    return false;
+  }
+
+  uint8_t* record = m_map + m_end;
+  std::memcpy(record + RECORD_HEADER_SIZE, wire, size);
+  store32(record + 4, tag);
+  store32(record + 8, computeChecksum(wire, size, tag));
+  store32(record + 12, 0);
+  // the size is written last, so a record is never valid before its bytes are
+  store32(record, static_cast<uint32_t>(size));
+  m_end += recordSize;
+
+  // the bytes after the last record may belong to an old version, they must not look valid
+  if (m_end + RECORD_HEADER_SIZE <= m_fileSize) {
+    std::memset(m_map + m_end, 0, RECORD_HEADER_SIZE);
+  }
+
+  ++m_statistics.nRecords;
+  ++m_statistics.nAppended;
+  m_statistics.usedSize = m_end;
+  return true;
+}
+
+std::string
+SegmentStore::getVersion() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_version;
+}
+
+SegmentStore::Statistics
+SegmentStore::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_statistics;
+}
+
+void
+SegmentStore::scan()
+{
+  m_version.clear();
+  m_end = HEADER_SIZE;
+  m_statistics.nRecords = 0;
+
+  uint32_t versionSize = load32(m_map + VERSION_SIZE_OFFSET);
+  if (std::memcmp(m_map, MAGIC, sizeof(MAGIC)) != 0 ||
+      load32(m_map + FORMAT_OFFSET) != FORMAT ||
+      versionSize > MAX_VERSION_SIZE) {
+    m_statistics.usedSize = m_end;
+    return;
+  }
+  m_version.assign(reinterpret_cast<const char*>(m_map + VERSION_OFFSET), versionSize);
+
+  while (m_end + RECORD_HEADER_SIZE <= m_fileSize) {
+    const uint8_t* record = m_map + m_end;
+    size_t size = load32(record);
+    if (size == 0 || m_end + getRecordSize(size) > m_fileSize ||
+        load32(record + 8) != computeChecksum(record + RECORD_HEADER_SIZE, size,
+                                              load32(record + 4))) {
+      break;
+    }
+    m_end += getRecordSize(size);
+    ++m_statistics.nRecords;
+  }
+  m_statistics.usedSize = m_end;
+
+  _LOG_DEBUG("Opened " << m_path << " with " << m_statistics.nRecords << " records of version "
+             << m_version);
+}
+
+void
+SegmentStore::reset(const std::string& version)
+{
+  if (version.size() > MAX_VERSION_SIZE) {
+    // no record can be appended until a shorter version becomes current
+    _LOG_ERROR("Version " << version << " is too long for " << m_path);
+  }
+
+  std::memcpy(m_map, MAGIC, sizeof(MAGIC));
+  store32(m_map + FORMAT_OFFSET, FORMAT);
+  size_t versionSize = std::min(version.size(), MAX_VERSION_SIZE);
+  store32(m_map + VERSION_SIZE_OFFSET, static_cast<uint32_t>(versionSize));
+  std::memset(m_map + VERSION_OFFSET, 0, MAX_VERSION_SIZE);
+  std::memcpy(m_map + VERSION_OFFSET, version.data(), versionSize);
+  std::memset(m_map + HEADER_SIZE, 0, RECORD_HEADER_SIZE);
+
+  m_version = version.size() > MAX_VERSION_SIZE ? std::string() : version;
+  m_end = HEADER_SIZE;
+  m_isVisited = true;
+  m_statistics.nRecords = 0;
+  m_statistics.usedSize = m_end;
+  ++m_statistics.nResets;
+}
+
+uint32_t
+SegmentStore::computeChecksum(const uint8_t* wire, size_t size, uint32_t tag)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261U ^ tag;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ wire[i]) * 16777619U;
+  }
+  return hash;
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,153 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_SEGMENT_STORE_HPP
+#define ATMOS_UTIL_SEGMENT_STORE_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace atmos {
+namespace util {
+
+/**
+ * SegmentStore keeps the encoded query results of one version in a memory-mapped file, so
+ * that they survive a restart of the catalog.
+ *
+ * The file has a fixed size and starts with a header that names the version, followed by the
+ * records appended since that version became current. Every record carries a checksum, so a
+ * record torn by a crash ends the file instead of being read. Switching to another version
+ * discards the records of the old one.
+ */
+class SegmentStore : boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * Callback for a stored record
+   *
+   * @param wire: the record bytes, only valid during the call
+   * @param size: the number of bytes
+   * @param tag:  the tag the record was appended with
+   */
+  typedef std::function<void(const uint8_t* wire, size_t size, uint32_t tag)> Visitor;
+
+  /**
+   * Snapshot of the store counters
+   */
+  struct Statistics
+  {
+    size_t fileSize;
+    size_t usedSize;
+    uint64_t nRecords;    // records of the current version
+    uint64_t nAppended;
+    uint64_t nDropped;    // records of another version, or that did not fit
+    uint64_t nResets;
+  };
+
+  /// the longest version that fits in the header
+  static const size_t MAX_VERSION_SIZE = 128;
+
+  /**
+   * Open or create the file and map it. The records of an existing file are kept until the
+   * first call to switchVersion().
+   *
+   * @param path:     the file
+   * @param fileSize: the size of the file in bytes, the records of an existing file that do not
+   *                  fit are lost
+   * @throw Error if the file cannot be opened or mapped
+   */
+  SegmentStore(const std::string& path, size_t fileSize);
+
+  /**
+   * Unmaps and closes the file, the records stay in it
+   */
+  ~SegmentStore();
+
+  /**
+   * Make a version the current one. If the file holds the records of this version, they are
+   * passed to the visitor, once per opened file; otherwise they are discarded.
+   *
+   * @return the number of records visited
+   */
+  uint64_t
+  switchVersion(const std::string& version, const Visitor& visitor);
+
+  /**
+   * Append a record of the current version, records of other versions are dropped
+   *
+   * @return false if the record was dropped
+   */
+  bool
+  append(const std::string& version, const uint8_t* wire, size_t size, uint32_t tag);
+
+  std::string
+  getVersion() const;
+
+  Statistics
+  getStatistics() const;
+
+private:
+  /**
+   * Find the end of the valid records and count them
+   */
+  void
+  scan();
+
+  /**
+   * Start an empty file for the version
+   */
+  void
+  reset(const std::string& version);
+
+  static uint32_t
+  computeChecksum(const uint8_t* wire, size_t size, uint32_t tag);
+
+private:
+  const std::string m_path;
+  int m_fd;
+  uint8_t* m_map;
+  size_t m_fileSize;
+
+  mutable std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  std::string m_version;
+  size_t m_end;
+  bool m_isVisited;
+  Statistics m_statistics;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_SEGMENT_STORE_HPP
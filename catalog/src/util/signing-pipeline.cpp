@@ -0,0 +1,171 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/signing-pipeline.hpp"
+#include "util/logger.hpp"
+
+#include <exception>
+#include <stdexcept>
+
+namespace atmos {
+namespace util {
+
+#ifdef HAVE_LOG4CXX
+  INIT_LOGGER("SigningPipeline");
+#endif
+
+SigningPipeline::SigningPipeline(size_t nThreads, size_t maxQueueLength)
+  : m_maxQueueLength(maxQueueLength)
+  , m_isStopped(false)
+  , m_statistics()
+{
+  if (nThreads == 0) {
+    throw std::invalid_argument("SigningPipeline needs at least one thread");
+  }
+  if (m_maxQueueLength == 0) {
+    throw std::invalid_argument("SigningPipeline needs a positive queue length");
+  }
+
+  m_threads.reserve(nThreads);
+  for (size_t i = 0; i < nThreads; ++i) {
+    m_threads.emplace_back(&SigningPipeline::run, this);
+  }
+}
+
+SigningPipeline::~SigningPipeline()
+{
+  stop();
+}
+
+bool
+SigningPipeline::submit(const std::shared_ptr<ndn::Data>& data,
+                        const Signer& signer,
+                        const Sink& sink)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_spaceCv.wait(lock, [this] { return m_isStopped || m_queue.size() < m_maxQueueLength; });
+    if (m_isStopped) {
+      return false;
+    }
+
+    m_queue.push_back(Entry{data, signer, sink, Clock::now()});
+    m_pending.insert(data->getName());
+    if (m_queue.size() > m_statistics.maxQueueLength) {
+      m_statistics.maxQueueLength = m_queue.size();
+    }
+  }
+  m_queueCv.notify_one();
+  return true;
+}
+
+void
+SigningPipeline::waitFor(const ndn::Name& prefix)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_doneCv.wait(lock, [this, &prefix] { return !hasPending(prefix); });
+}
+
+void
+SigningPipeline::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isStopped) {
+      return;
+    }
+    m_isStopped = true;
+    for (const auto& entry : m_queue) {
+      m_pending.erase(m_pending.find(entry.data->getName()));
+    }
+    m_queue.clear();
+  }
+  m_queueCv.notify_all();
+  m_spaceCv.notify_all();
+  m_doneCv.notify_all();
+
+  for (auto& thread : m_threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+SigningPipeline::Statistics
+SigningPipeline::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Statistics statistics = m_statistics;
+  statistics.queueLength = m_queue.size();
+  return statistics;
+}
+
+bool
+SigningPipeline::hasPending(const ndn::Name& prefix) const
+{
+  // a name sorts right after its prefix, before any name that does not extend the prefix
+  auto it = m_pending.lower_bound(prefix);
+  return it != m_pending.end() && prefix.isPrefixOf(*it);
+}
+
+void
+SigningPipeline::run()
+{
+  while (true) {
+    Entry entry;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_queueCv.wait(lock, [this] { return m_isStopped || !m_queue.empty(); });
+      if (m_isStopped) {
+        return;
+      }
+
+      entry = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+    m_spaceCv.notify_one();
+
+    Clock::time_point signStart = Clock::now();
+    Clock::time_point sinkStart = signStart;
+    try {
+      entry.signer(*entry.data);
+      sinkStart = Clock::now();
+      entry.sink(entry.data);
+    }
+    catch (const std::exception& e) {
+      _LOG_ERROR("Signing " << entry.data->getName() << " failed: " << e.what());
+    }
+    Clock::time_point sinkEnd = Clock::now();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_pending.erase(m_pending.find(entry.data->getName()));
+      ++m_statistics.nSigned;
+      m_statistics.totalWaitMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+                                              signStart - entry.enqueueTime).count();
+      m_statistics.totalSignMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+                                              sinkStart - signStart).count();
+      m_statistics.totalSinkMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+                                              sinkEnd - sinkStart).count();
+    }
+    m_doneCv.notify_all();
+  }
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,157 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_SIGNING_PIPELINE_HPP
+#define ATMOS_UTIL_SIGNING_PIPELINE_HPP
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/name.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * SigningPipeline signs Data packets on its own threads and hands them to a sink.
+ *
+ * The producer only encodes the packets, so reading the results, signing and putting the
+ * segments overlap. The queue is bounded: submit() blocks while it is full, which slows the
+ * producer down to the signing rate instead of dropping segments.
+ */
+class SigningPipeline : boost::noncopyable
+{
+public:
+  typedef std::function<void(ndn::Data& data)> Signer;
+  typedef std::function<void(const std::shared_ptr<ndn::Data>& data)> Sink;
+
+  /**
+   * Snapshot of the pipeline counters, the times are summed over all packets
+   */
+  struct Statistics
+  {
+    uint64_t nSigned;
+    size_t queueLength;
+    size_t maxQueueLength;          // high-water mark of the queue
+    uint64_t totalWaitMicroseconds; // time spent in the queue
+    uint64_t totalSignMicroseconds; // time spent in the signer
+    uint64_t totalSinkMicroseconds; // time spent in the sink
+  };
+
+  /**
+   * Constructor
+   *
+   * @param nThreads:       number of signing threads, must be positive
+   * @param maxQueueLength: number of packets that can wait for a thread, must be positive
+   */
+  SigningPipeline(size_t nThreads, size_t maxQueueLength);
+
+  /**
+   * Stops the pipeline, queued packets that have not been signed yet are discarded
+   */
+  ~SigningPipeline();
+
+  /**
+   * Enqueue a packet, blocks while the queue is full
+   *
+   * @param data:   the unsigned packet
+   * @param signer: signs the packet, called from a signing thread
+   * @param sink:   called with the signed packet from the same thread
+   * @return false if the pipeline is stopped, in which case the packet is not signed
+   */
+  bool
+  submit(const std::shared_ptr<ndn::Data>& data, const Signer& signer, const Sink& sink);
+
+  /**
+   * Blocks until no packet under the prefix is queued or being signed
+   */
+  void
+  waitFor(const ndn::Name& prefix);
+
+  /**
+   * Wakes up all threads and waits for the packets being signed
+   */
+  void
+  stop();
+
+  size_t
+  getNThreads() const
+  {
+    return m_threads.size();
+  }
+
+  size_t
+  getMaxQueueLength() const
+  {
+    return m_maxQueueLength;
+  }
+
+  Statistics
+  getStatistics() const;
+
+private:
+  void
+  run();
+
+  bool
+  hasPending(const ndn::Name& prefix) const;
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Entry
+  {
+    std::shared_ptr<ndn::Data> data;
+    Signer signer;
+    Sink sink;
+    Clock::time_point enqueueTime;
+  };
+
+  const size_t m_maxQueueLength;
+  std::vector<std::thread> m_threads;
+
+  mutable std::mutex m_mutex;
+  // signals the signing threads, the blocked producers and the waitFor callers
+  std::condition_variable m_queueCv;
+  std::condition_variable m_spaceCv;
+  std::condition_variable m_doneCv;
+  // @{ needs m_mutex protection
+  std::deque<Entry> m_queue;
+  // names of the queued packets and of those being signed, in canonical order so that the
+  // names under a prefix are adjacent
+  std::multiset<ndn::Name> m_pending;
+  bool m_isStopped;
+  Statistics m_statistics;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_SIGNING_PIPELINE_HPP
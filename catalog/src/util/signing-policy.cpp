@@ -0,0 +1,123 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/signing-policy.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+SigningPolicy::SigningPolicy(ndn::KeyChain& keyChain)
+  : m_keyChain(keyChain)
+{
+  m_methods.fill(METHOD_KEY);
+}
+
+void
+SigningPolicy::setMethod(PacketClass packetClass, Method method)
+{
+  // the other packets are rare, they keep the key
+  if (packetClass != PACKET_OTHER) {
+    m_methods[packetClass] = method;
+  }
+}
+
+void
+SigningPolicy::setSigningId(const ndn::Name& signingId)
+{
+  m_ecdsaCertName.clear();
+  if (std::find(m_methods.begin(), m_methods.end(), METHOD_ECDSA) == m_methods.end()) {
+    return;
+  }
+
+  ndn::Name identity = signingId.empty() ? m_keyChain.getDefaultIdentity() : signingId;
+
+  // the default key comes first, so it is used when it is an ECDSA key
+  std::vector<ndn::Name> keyNames;
+  m_keyChain.getAllKeyNamesOfIdentity(identity, keyNames, true);
+  m_keyChain.getAllKeyNamesOfIdentity(identity, keyNames, false);
+  for (const auto& keyName : keyNames) {
+    if (m_keyChain.getPublicKey(keyName)->getKeyType() == ndn::KEY_TYPE_ECDSA) {
+      m_ecdsaCertName = m_keyChain.getDefaultCertificateNameForKey(keyName);
+      return;
+    }
+  }
+
+  throw Error("Identity " + identity.toUri() + " has no ECDSA key");
+}
+
+void
+SigningPolicy::sign(ndn::Data& data, PacketClass packetClass, const KeySigner& signWithKey) const
+{
+  switch (m_methods[packetClass]) {
+  case METHOD_ECDSA:
+    m_keyChain.sign(data, m_ecdsaCertName);
+    break;
+  case METHOD_DIGEST:
+    m_keyChain.signWithSha256(data);
+    break;
+  case METHOD_KEY:
+  default:
+    signWithKey(data);
+    break;
+  }
+}
+
+bool
+SigningPolicy::parsePacketClass(const std::string& name, PacketClass& packetClass)
+{
+  if (name == "ack") {
+    packetClass = PACKET_ACK;
+  }
+  else if (name == "nack") {
+    packetClass = PACKET_NACK;
+  }
+  else if (name == "autocomplete") {
+    packetClass = PACKET_AUTOCOMPLETE;
+  }
+  else if (name == "results") {
+    packetClass = PACKET_RESULTS;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+bool
+SigningPolicy::parseMethod(const std::string& name, Method& method)
+{
+  if (name == "key") {
+    method = METHOD_KEY;
+  }
+  else if (name == "ecdsa") {
+    method = METHOD_ECDSA;
+  }
+  else if (name == "digest") {
+    method = METHOD_DIGEST;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+} // namespace util
+} // namespace atmos
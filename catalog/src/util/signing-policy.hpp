@@ -0,0 +1,135 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_SIGNING_POLICY_HPP
+#define ATMOS_UTIL_SIGNING_POLICY_HPP
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace atmos {
+namespace util {
+
+/**
+ * SigningPolicy picks how every class of packet an adapter sends is signed.
+ *
+ * The default is the key of the signing identity for every class, usually RSA. Packets that
+ * are sent at a high rate can use an ECDSA key of the same identity, which is much cheaper to
+ * sign with, or only a SHA-256 digest, which protects the integrity but not the origin.
+ */
+class SigningPolicy
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  enum PacketClass {
+    PACKET_ACK,
+    PACKET_NACK,
+    PACKET_AUTOCOMPLETE,
+    PACKET_RESULTS,
+    /// status, filters menu, manifests, always signed with the key
+    PACKET_OTHER,
+    N_PACKET_CLASSES
+  };
+
+  enum Method {
+    /// the default certificate of the signing identity
+    METHOD_KEY,
+    /// the default certificate of an ECDSA key of the signing identity
+    METHOD_ECDSA,
+    /// a SHA-256 digest
+    METHOD_DIGEST
+  };
+
+  /**
+   * Signs with the default certificate of the signing identity
+   */
+  typedef std::function<void(ndn::Data& data)> KeySigner;
+
+  explicit
+  SigningPolicy(ndn::KeyChain& keyChain);
+
+  void
+  setMethod(PacketClass packetClass, Method method);
+
+  Method
+  getMethod(PacketClass packetClass) const
+  {
+    return m_methods[packetClass];
+  }
+
+  /**
+   * Finds the certificates of the methods in use, must be called after the methods are set
+   *
+   * @param signingId: the signing identity, the default identity if empty
+   * @throw Error if an ECDSA method is used and the identity has no ECDSA key
+   */
+  void
+  setSigningId(const ndn::Name& signingId);
+
+  /**
+   * Signs a packet as the policy says for its class
+   *
+   * @param data:        the packet
+   * @param packetClass: the class of the packet
+   * @param signWithKey: used for METHOD_KEY
+   */
+  void
+  sign(ndn::Data& data, PacketClass packetClass, const KeySigner& signWithKey) const;
+
+  /**
+   * Parse a packet class name of the "signing" config section: ack, nack, autocomplete or
+   * results
+   *
+   * @return false if the name is unknown
+   */
+  static bool
+  parsePacketClass(const std::string& name, PacketClass& packetClass);
+
+  /**
+   * Parse a method name of the "signing" config section: key, ecdsa or digest
+   *
+   * @return false if the name is unknown
+   */
+  static bool
+  parseMethod(const std::string& name, Method& method);
+
+private:
+  ndn::KeyChain& m_keyChain;
+  std::array<Method, N_PACKET_CLASSES> m_methods;
+  ndn::Name m_ecdsaCertName;
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_SIGNING_POLICY_HPP
@@ -0,0 +1,156 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/statement-cache.hpp"
+#include "util/logger.hpp"
+
+namespace atmos {
+namespace util {
+
+#ifdef HAVE_LOG4CXX
+  INIT_LOGGER("StatementCache");
+#endif
+
+StatementCache::StatementCache(const std::shared_ptr<ConnectionPool_T>& pool,
+                               size_t maxIdleConnections)
+  : m_pool(pool)
+  , m_maxIdleConnections(maxIdleConnections)
+  , m_nLeased(0)
+  , m_nHits(0)
+  , m_nMisses(0)
+{
+}
+
+StatementCache::~StatementCache()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto& connection : m_idleConnections) {
+    Connection_close(connection->connection);
+  }
+  m_idleConnections.clear();
+}
+
+std::unique_ptr<StatementCache::Lease>
+StatementCache::acquire()
+{
+  std::unique_ptr<CachedConnection> connection;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_idleConnections.empty()) {
+      connection = std::move(m_idleConnections.back());
+      m_idleConnections.pop_back();
+    }
+    ++m_nLeased;
+  }
+
+  if (!connection) {
+    Connection_T conn = ConnectionPool_getConnection(*m_pool);
+    if (!conn) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      --m_nLeased;
+      return nullptr;
+    }
+    connection.reset(new CachedConnection);
+    connection->connection = conn;
+  }
+
+  return std::unique_ptr<Lease>(new Lease(*this, std::move(connection)));
+}
+
+StatementCache::Statistics
+StatementCache::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Statistics statistics;
+  statistics.nHits = m_nHits;
+  statistics.nMisses = m_nMisses;
+  statistics.nIdleConnections = m_idleConnections.size();
+  statistics.nConnections = m_nLeased + m_idleConnections.size();
+  return statistics;
+}
+
+void
+StatementCache::release(std::unique_ptr<CachedConnection> connection, bool isBroken)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    --m_nLeased;
+    if (!isBroken && m_idleConnections.size() < m_maxIdleConnections) {
+      m_idleConnections.push_back(std::move(connection));
+      return;
+    }
+  }
+
+  // closing the connection frees its statements and gives it back to the pool
+  Connection_close(connection->connection);
+}
+
+void
+StatementCache::countLookup(bool isHit)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (isHit) {
+    ++m_nHits;
+  }
+  else {
+    ++m_nMisses;
+  }
+}
+
+StatementCache::Lease::Lease(StatementCache& cache, std::unique_ptr<CachedConnection> connection)
+  : m_cache(cache)
+  , m_connection(std::move(connection))
+  , m_isBroken(false)
+{
+}
+
+StatementCache::Lease::~Lease()
+{
+  m_cache.release(std::move(m_connection), m_isBroken);
+}
+
+PreparedStatement_T
+StatementCache::Lease::prepare(const std::string& sql)
+{
+  auto it = m_connection->statements.find(sql);
+  if (it != m_connection->statements.end()) {
+    m_cache.countLookup(true);
+    return it->second;
+  }
+  m_cache.countLookup(false);
+
+  PreparedStatement_T statement = nullptr;
+  TRY {
+    statement = Connection_prepareStatement(m_connection->connection,
+                                            reinterpret_cast<const char*>(sql.c_str()),
+                                            sql.size());
+  }
+  CATCH(SQLException) {
+    _LOG_ERROR(Connection_getLastError(m_connection->connection));
+    m_isBroken = true;
+  }
+  END_TRY;
+
+  if (statement != nullptr) {
+    m_connection->statements[sql] = statement;
+  }
+  return statement;
+}
+
+} // namespace util
+} // namespace atmos
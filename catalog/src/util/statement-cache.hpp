@@ -0,0 +1,156 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_STATEMENT_CACHE_HPP
+#define ATMOS_UTIL_STATEMENT_CACHE_HPP
+
+#include <zdb/zdb.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * StatementCache keeps prepared statements alive across queries.
+ *
+ * Closing a pooled connection also frees its prepared statements, so the cache holds on to
+ * the connections it takes from the pool and keeps a table of prepared statements, keyed by
+ * SQL string, for each of them. A connection is leased to one thread at a time.
+ */
+class StatementCache : boost::noncopyable
+{
+public:
+  struct Statistics
+  {
+    uint64_t nHits;
+    uint64_t nMisses;
+    size_t nConnections;     // connections held by the cache, leased or idle
+    size_t nIdleConnections;
+  };
+
+  class Lease;
+
+  /**
+   * Constructor
+   *
+   * @param pool:               the pool to take the connections from
+   * @param maxIdleConnections: the number of idle connections kept with their statements, the
+   *                            others are returned to the pool
+   */
+  StatementCache(const std::shared_ptr<ConnectionPool_T>& pool, size_t maxIdleConnections);
+
+  /**
+   * Returns all connections to the pool
+   */
+  ~StatementCache();
+
+  /**
+   * Lease a connection, an idle one with prepared statements if there is one
+   *
+   * @return the lease, or nullptr if the pool has no connection available
+   */
+  std::unique_ptr<Lease>
+  acquire();
+
+  Statistics
+  getStatistics() const;
+
+private:
+  struct CachedConnection
+  {
+    Connection_T connection;
+    std::unordered_map<std::string, PreparedStatement_T> statements;
+  };
+
+  void
+  release(std::unique_ptr<CachedConnection> connection, bool isBroken);
+
+  void
+  countLookup(bool isHit);
+
+private:
+  const std::shared_ptr<ConnectionPool_T> m_pool;
+  const size_t m_maxIdleConnections;
+
+  mutable std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  std::vector<std::unique_ptr<CachedConnection>> m_idleConnections;
+  size_t m_nLeased;
+  uint64_t m_nHits;
+  uint64_t m_nMisses;
+  // @}
+};
+
+/**
+ * A connection leased from the StatementCache, given back when the lease is destroyed
+ */
+class StatementCache::Lease : boost::noncopyable
+{
+public:
+  ~Lease();
+
+  Connection_T
+  getConnection() const
+  {
+    return m_connection->connection;
+  }
+
+  /**
+   * Get the prepared statement for the SQL string, preparing it on the first use
+   *
+   * The parameters of a cached statement keep the values of its previous use, so all of them
+   * must be set before it is executed.
+   *
+   * @return the statement, or nullptr if it cannot be prepared, in which case the connection
+   *         is not reused
+   */
+  PreparedStatement_T
+  prepare(const std::string& sql);
+
+  /**
+   * Do not reuse the connection, e.g., after an SQL error
+   */
+  void
+  markBroken()
+  {
+    m_isBroken = true;
+  }
+
+private:
+  Lease(StatementCache& cache, std::unique_ptr<CachedConnection> connection);
+
+  friend class StatementCache;
+
+private:
+  StatementCache& m_cache;
+  std::unique_ptr<CachedConnection> m_connection;
+  bool m_isBroken;
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_STATEMENT_CACHE_HPP
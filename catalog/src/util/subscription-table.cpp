@@ -0,0 +1,156 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/subscription-table.hpp"
+#include "index/catalog-index.hpp"
+
+#include <stdexcept>
+
+namespace atmos {
+namespace util {
+
+SubscriptionTable::SubscriptionTable(size_t maxSubscriptions,
+                                     std::chrono::milliseconds timeToLive)
+  : m_maxSubscriptions(maxSubscriptions)
+  , m_timeToLive(timeToLive)
+  , m_nSubscribed(0)
+  , m_nRejected(0)
+  , m_nExpired(0)
+  , m_nNotifications(0)
+{
+  if (m_maxSubscriptions == 0) {
+    throw std::invalid_argument("SubscriptionTable needs a positive number of subscriptions");
+  }
+}
+
+bool
+SubscriptionTable::subscribe(const std::string& key,
+                             const ResultDependencies::Predicate& predicate,
+                             uint64_t& nextSequence)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Clock::time_point now = Clock::now();
+
+  auto it = m_subscriptions.find(key);
+  if (it == m_subscriptions.end()) {
+    if (m_subscriptions.size() >= m_maxSubscriptions) {
+      expire(now);
+    }
+    if (m_subscriptions.size() >= m_maxSubscriptions) {
+      ++m_nRejected;
+      return false;
+    }
+    it = m_subscriptions.insert(std::make_pair(key, Subscription())).first;
+    it->second.predicate = predicate;
+    it->second.nextSequence = 0;
+    ++m_nSubscribed;
+  }
+
+  it->second.lastUsed = now;
+  nextSequence = it->second.nextSequence;
+  return true;
+}
+
+bool
+SubscriptionTable::refresh(const std::string& key, uint64_t& nextSequence)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_subscriptions.find(key);
+  if (it == m_subscriptions.end()) {
+    return false;
+  }
+
+  it->second.lastUsed = Clock::now();
+  nextSequence = it->second.nextSequence;
+  return true;
+}
+
+void
+SubscriptionTable::match(const std::vector<ChangeLog::Change>& changes,
+                         std::vector<Notification>& notifications)
+{
+  notifications.clear();
+
+  // split the names once for all subscriptions, names that cannot be split match nothing
+  std::vector<std::vector<std::string>> fieldValues(changes.size());
+  std::vector<bool> isSplit(changes.size());
+  for (size_t i = 0; i < changes.size(); ++i) {
+    isSplit[i] = index::splitName(changes[i].name, fieldValues[i]);
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  expire(Clock::now());
+
+  for (auto& subscription : m_subscriptions) {
+    Notification notification;
+    for (size_t i = 0; i < changes.size(); ++i) {
+      if (!isSplit[i]) {
+        continue;
+      }
+      bool isMatching = true;
+      for (const auto& condition : subscription.second.predicate) {
+        if (condition.field >= fieldValues[i].size() ||
+            !index::matchLikePattern(fieldValues[i][condition.field], condition.pattern)) {
+          isMatching = false;
+          break;
+        }
+      }
+      if (isMatching) {
+        notification.changes.push_back(i);
+      }
+    }
+
+    if (!notification.changes.empty()) {
+      notification.key = subscription.first;
+      notification.sequence = subscription.second.nextSequence++;
+      notifications.push_back(std::move(notification));
+      ++m_nNotifications;
+    }
+  }
+}
+
+void
+SubscriptionTable::expire(Clock::time_point now)
+{
+  Clock::time_point expiry = now - m_timeToLive;
+  for (auto it = m_subscriptions.begin(); it != m_subscriptions.end();) {
+    if (it->second.lastUsed < expiry) {
+      ++m_nExpired;
+      it = m_subscriptions.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+SubscriptionTable::Statistics
+SubscriptionTable::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Statistics statistics;
+  statistics.nSubscriptions = m_subscriptions.size();
+  statistics.nSubscribed = m_nSubscribed;
+  statistics.nRejected = m_nRejected;
+  statistics.nExpired = m_nExpired;
+  statistics.nNotifications = m_nNotifications;
+  return statistics;
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,141 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_SUBSCRIPTION_TABLE_HPP
+#define ATMOS_UTIL_SUBSCRIPTION_TABLE_HPP
+
+#include "util/change-log.hpp"
+#include "util/result-dependencies.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * SubscriptionTable keeps the standing queries, whose consumers are notified of the
+ * publications that change their results instead of polling the query.
+ *
+ * Every subscription numbers its notifications. A batch of publication changes makes one
+ * notification for every subscription that one of the changes matches. A subscription is
+ * dropped when it has not been refreshed for the time-to-live.
+ */
+class SubscriptionTable : boost::noncopyable
+{
+public:
+  /**
+   * The changes of a batch that match a subscription
+   */
+  struct Notification
+  {
+    std::string key;
+    uint64_t sequence;
+    // indices into the batch
+    std::vector<size_t> changes;
+  };
+
+  struct Statistics
+  {
+    size_t nSubscriptions;
+    uint64_t nSubscribed;
+    uint64_t nRejected;
+    uint64_t nExpired;
+    uint64_t nNotifications;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param maxSubscriptions: the number of subscriptions that can be registered
+   * @param timeToLive:       how long a subscription that is not refreshed is kept
+   */
+  SubscriptionTable(size_t maxSubscriptions, std::chrono::milliseconds timeToLive);
+
+  /**
+   * Register a subscription, or refresh it if it exists
+   *
+   * @param key:          the standing query, e.g. its canonical form
+   * @param predicate:    the conditions a changed name must match, exact and case-sensitive
+   * @param nextSequence: set to the sequence number of the next notification
+   * @return false if the table is full
+   */
+  bool
+  subscribe(const std::string& key, const ResultDependencies::Predicate& predicate,
+            uint64_t& nextSequence);
+
+  /**
+   * Keep a subscription for another time-to-live
+   *
+   * @param nextSequence: set to the sequence number of the next notification
+   * @return false if there is no such subscription
+   */
+  bool
+  refresh(const std::string& key, uint64_t& nextSequence);
+
+  /**
+   * Match a batch of publication changes against the subscriptions, after dropping the
+   * expired ones
+   *
+   * @param changes:       the added and removed names
+   * @param notifications: set to one notification per matching subscription
+   */
+  void
+  match(const std::vector<ChangeLog::Change>& changes,
+        std::vector<Notification>& notifications);
+
+  Statistics
+  getStatistics() const;
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Subscription
+  {
+    ResultDependencies::Predicate predicate;
+    uint64_t nextSequence;
+    Clock::time_point lastUsed;
+  };
+
+  void
+  expire(Clock::time_point now);
+
+private:
+  const size_t m_maxSubscriptions;
+  const std::chrono::milliseconds m_timeToLive;
+
+  mutable std::mutex m_mutex;
+  // @{ needs m_mutex protection
+  std::map<std::string, Subscription> m_subscriptions;
+  uint64_t m_nSubscribed;
+  uint64_t m_nRejected;
+  uint64_t m_nExpired;
+  uint64_t m_nNotifications;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_SUBSCRIPTION_TABLE_HPP
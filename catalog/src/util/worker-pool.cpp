@@ -0,0 +1,137 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/worker-pool.hpp"
+#include "util/logger.hpp"
+
+#include <exception>
+#include <stdexcept>
+
+namespace atmos {
+namespace util {
+
+#ifdef HAVE_LOG4CXX
+  INIT_LOGGER("WorkerPool");
+#endif
+
+WorkerPool::WorkerPool(size_t nThreads, size_t maxQueueLength)
+  : m_maxQueueLength(maxQueueLength)
+  , m_isStopped(false)
+  , m_statistics()
+{
+  if (nThreads == 0) {
+    throw std::invalid_argument("WorkerPool needs at least one thread");
+  }
+
+  m_threads.reserve(nThreads);
+  for (size_t i = 0; i < nThreads; ++i) {
+    m_threads.emplace_back(&WorkerPool::run, this);
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  stop();
+}
+
+bool
+WorkerPool::submit(const Task& task)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isStopped || m_queue.size() >= m_maxQueueLength) {
+      ++m_statistics.nRejected;
+      return false;
+    }
+
+    m_queue.emplace_back(task, Clock::now());
+    ++m_statistics.nAccepted;
+    if (m_queue.size() > m_statistics.maxQueueLength) {
+      m_statistics.maxQueueLength = m_queue.size();
+    }
+  }
+  m_cv.notify_one();
+  return true;
+}
+
+void
+WorkerPool::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isStopped) {
+      return;
+    }
+    m_isStopped = true;
+    m_queue.clear();
+  }
+  m_cv.notify_all();
+
+  for (auto& thread : m_threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+WorkerPool::Statistics
+WorkerPool::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Statistics statistics = m_statistics;
+  statistics.queueLength = m_queue.size();
+  return statistics;
+}
+
+void
+WorkerPool::run()
+{
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_isStopped || !m_queue.empty(); });
+      if (m_isStopped) {
+        return;
+      }
+
+      task.swap(m_queue.front().first);
+      uint64_t wait = std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - m_queue.front().second).count();
+      m_queue.pop_front();
+
+      m_statistics.totalWaitMicroseconds += wait;
+      if (wait > m_statistics.maxWaitMicroseconds) {
+        m_statistics.maxWaitMicroseconds = wait;
+      }
+    }
+
+    try {
+      task();
+    }
+    catch (const std::exception& e) {
+      _LOG_ERROR("Worker task failed: " << e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_statistics.nCompleted;
+  }
+}
+
+} // namespace util
+} // namespace atmos
@@ -0,0 +1,128 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef ATMOS_UTIL_WORKER_POOL_HPP
+#define ATMOS_UTIL_WORKER_POOL_HPP
+
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace atmos {
+namespace util {
+
+/**
+ * WorkerPool runs tasks on a fixed number of threads fed by a bounded run queue.
+ *
+ * A task is only admitted when the queue has room; otherwise submit() returns false and the
+ * caller decides what to do with the request (the adapters simply drop it, and the consumer
+ * retransmits the Interest later).
+ */
+class WorkerPool : boost::noncopyable
+{
+public:
+  typedef std::function<void()> Task;
+
+  /**
+   * Snapshot of the pool counters
+   */
+  struct Statistics
+  {
+    uint64_t nAccepted;
+    uint64_t nRejected;
+    uint64_t nCompleted;
+    size_t queueLength;
+    size_t maxQueueLength;        // high-water mark of the run queue
+    uint64_t totalWaitMicroseconds; // time spent in the queue by all started tasks
+    uint64_t maxWaitMicroseconds;
+  };
+
+  /**
+   * Constructor
+   *
+   * @param nThreads:       number of worker threads, must be positive
+   * @param maxQueueLength: number of tasks that can wait for a thread
+   */
+  WorkerPool(size_t nThreads, size_t maxQueueLength);
+
+  /**
+   * Stops the pool, queued tasks that have not started yet are discarded
+   */
+  ~WorkerPool();
+
+  /**
+   * Enqueue a task
+   *
+   * @return false if the run queue is full or the pool is stopped, in which case the task is
+   *         not run
+   */
+  bool
+  submit(const Task& task);
+
+  /**
+   * Wakes up all threads and waits for the running tasks to return
+   */
+  void
+  stop();
+
+  size_t
+  getNThreads() const
+  {
+    return m_threads.size();
+  }
+
+  size_t
+  getMaxQueueLength() const
+  {
+    return m_maxQueueLength;
+  }
+
+  Statistics
+  getStatistics() const;
+
+private:
+  void
+  run();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  const size_t m_maxQueueLength;
+  std::vector<std::thread> m_threads;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  // @{ needs m_mutex protection
+  std::deque<std::pair<Task, Clock::time_point>> m_queue;
+  bool m_isStopped;
+  Statistics m_statistics;
+  // @}
+};
+
+} // namespace util
+} // namespace atmos
+
+#endif // ATMOS_UTIL_WORKER_POOL_HPP
@@ -0,0 +1,243 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/catalog-index.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  class CatalogIndexFixture
+  {
+  public:
+    CatalogIndexFixture()
+      : catalogIndex({"activity", "product", "organization", "model"})
+    {
+      BOOST_REQUIRE(catalogIndex.insert("/CMIP5/output1/CSU/GCM1", false));
+      BOOST_REQUIRE(catalogIndex.insert("/CMIP5/output1/CSU/GCM2", true));
+      BOOST_REQUIRE(catalogIndex.insert("/CMIP5/output2/NCAR/GCM1", false));
+      BOOST_REQUIRE(catalogIndex.insert("/CMIP6/output1/NCAR/GCM3", false));
+    }
+
+    std::vector<std::string>
+    findNames(const index::CatalogIndex::QueryParams& params,
+              uint64_t afterId = 0,
+              size_t limit = 100)
+    {
+      std::vector<index::CatalogIndex::Record> records;
+      catalogIndex.find(params, afterId, limit, records);
+      std::vector<std::string> names;
+      for (const auto& record : records) {
+        names.push_back(record.name);
+      }
+      return names;
+    }
+
+  protected:
+    index::CatalogIndex catalogIndex;
+  };
+
+  BOOST_FIXTURE_TEST_SUITE(CatalogIndexTestSuite, CatalogIndexFixture)
+
+  BOOST_AUTO_TEST_CASE(CatalogIndexInsert)
+  {
+    BOOST_CHECK_EQUAL(catalogIndex.size(), 4);
+    // duplicate name
+    BOOST_CHECK(!catalogIndex.insert("/CMIP5/output1/CSU/GCM1", false));
+    // wrong number of components
+    BOOST_CHECK(!catalogIndex.insert("/CMIP5/output1/CSU", false));
+    BOOST_CHECK(!catalogIndex.insert("CMIP5/output1/CSU/GCM9", false));
+    BOOST_CHECK(catalogIndex.insert("ndn:/CMIP5/output1/CSU/GCM9", false));
+    BOOST_CHECK_EQUAL(catalogIndex.size(), 5);
+  }
+
+  BOOST_AUTO_TEST_CASE(CatalogIndexFilterQuery)
+  {
+    BOOST_CHECK_EQUAL(catalogIndex.count({}), 4);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"activity", "CMIP5"}}), 3);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"activity", "CMIP5"}, {"model", "GCM1"}}), 2);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"activity", "CMIP7"}}), 0);
+    // prefix queries
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"activity", "CMIP5"}, {"product", "output1"}}), 2);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"activity", "CMIP5"}, {"product", "output3"}}), 0);
+    // fields that are not name fields are ignored
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"unknown", "x"}, {"organization", "NCAR"}}), 2);
+
+    std::vector<std::string> expected = {"/CMIP5/output1/CSU/GCM1", "/CMIP5/output2/NCAR/GCM1"};
+    std::vector<std::string> names = findNames({{"model", "GCM1"}});
+    BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), expected.begin(), expected.end());
+
+    std::vector<index::CatalogIndex::Record> records;
+    catalogIndex.find({{"model", "GCM2"}}, 0, 100, records);
+    BOOST_REQUIRE_EQUAL(records.size(), 1);
+    BOOST_CHECK_EQUAL(records[0].id, 2);
+    BOOST_CHECK(records[0].hasMetadata);
+  }
+
+  BOOST_AUTO_TEST_CASE(CatalogIndexLikeQuery)
+  {
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"activity", "CMIP%"}}), 4);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"model", "GCM_"}}), 4);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"organization", "N%"}}), 2);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"organization", "%A%R"}}), 2);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"organization", "%X%"}}), 0);
+
+    BOOST_CHECK(index::matchLikePattern("output1", "out%1"));
+    BOOST_CHECK(index::matchLikePattern("", "%"));
+    BOOST_CHECK(!index::matchLikePattern("", "_"));
+    BOOST_CHECK(!index::matchLikePattern("output1", "out%2"));
+    BOOST_CHECK(index::matchLikePattern("aab", "%ab"));
+  }
+
+  BOOST_AUTO_TEST_CASE(CatalogIndexPagination)
+  {
+    std::vector<index::CatalogIndex::Record> records;
+    catalogIndex.find({}, 0, 3, records);
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    uint64_t lastId = records.back().id;
+
+    records.clear();
+    catalogIndex.find({}, lastId, 3, records);
+    BOOST_REQUIRE_EQUAL(records.size(), 1);
+    BOOST_CHECK_EQUAL(records[0].name, "/CMIP6/output1/NCAR/GCM3");
+
+    records.clear();
+    catalogIndex.find({}, 100, 3, records);
+    BOOST_CHECK(records.empty());
+
+    // the count comes with the largest id, later records have larger ones
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"activity", "CMIP5"}}, lastId), 3);
+    BOOST_CHECK_EQUAL(lastId, 4);
+    BOOST_CHECK(catalogIndex.insert("/CMIP5/output3/CSU/GCM1", false));
+    records.clear();
+    catalogIndex.find({{"activity", "CMIP5"}}, 3, 3, records);
+    BOOST_REQUIRE_EQUAL(records.size(), 1);
+    BOOST_CHECK_GT(records[0].id, lastId);
+  }
+
+  BOOST_AUTO_TEST_CASE(CatalogIndexErase)
+  {
+    BOOST_CHECK(catalogIndex.erase("/CMIP5/output1/CSU/GCM1"));
+    BOOST_CHECK(!catalogIndex.erase("/CMIP5/output1/CSU/GCM1"));
+    BOOST_CHECK_EQUAL(catalogIndex.size(), 3);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"model", "GCM1"}}), 1);
+
+    // the dictionary drops values no record uses
+    BOOST_CHECK(catalogIndex.erase("/CMIP5/output1/CSU/GCM2"));
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"organization", "CSU"}}), 0);
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"organization", "%S%"}}), 0);
+
+    // the slots are compacted, ids are kept
+    BOOST_CHECK(catalogIndex.insert("/CMIP5/output1/CSU/GCM1", false));
+    std::vector<index::CatalogIndex::Record> records;
+    catalogIndex.find({}, 0, 100, records);
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    BOOST_CHECK_EQUAL(records[0].id, 3);
+    BOOST_CHECK_EQUAL(records[1].id, 4);
+    BOOST_CHECK_EQUAL(records[2].id, 5);
+    BOOST_CHECK_EQUAL(records[2].name, "/CMIP5/output1/CSU/GCM1");
+    BOOST_CHECK_EQUAL(catalogIndex.count({{"organization", "CSU"}}), 1);
+  }
+
+  BOOST_AUTO_TEST_CASE(CatalogIndexDistinctValues)
+  {
+    std::vector<std::string> values;
+    BOOST_CHECK(catalogIndex.findDistinctValues({{"activity", "CMIP5"}}, "organization", values));
+    std::vector<std::string> expected = {"CSU", "NCAR"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+    values.clear();
+    BOOST_CHECK(catalogIndex.findDistinctValues({{"activity", "CMIP5"}, {"organization", "CSU"}},
+                                         "model", values));
+    expected = {"GCM1", "GCM2"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+    // typed components are not patterns
+    values.clear();
+    BOOST_CHECK(catalogIndex.findDistinctValues({{"activity", "CMIP_"}}, "organization", values));
+    BOOST_CHECK(values.empty());
+
+    // fields that are not leading ones are answered from the postings
+    values.clear();
+    BOOST_CHECK(catalogIndex.findDistinctValues({{"organization", "NCAR"}}, "model", values));
+    expected = {"GCM1", "GCM3"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+    values.clear();
+    BOOST_CHECK(catalogIndex.findDistinctValues({{"activity", "CMIP9"}}, "product", values));
+    BOOST_CHECK(values.empty());
+
+    values.clear();
+    BOOST_CHECK(!catalogIndex.findDistinctValues({}, "unknown", values));
+  }
+
+  BOOST_AUTO_TEST_CASE(CatalogIndexManyRecords)
+  {
+    // enough records for dense posting bitmaps, checked against a scan of the same records
+    index::CatalogIndex manyRecords({"a", "b", "c"});
+    std::vector<std::vector<std::string>> rows;
+    for (int i = 0; i < 30000; i++) {
+      std::vector<std::string> row = {"a" + std::to_string(i % 3), "b" + std::to_string(i % 7),
+                                      "c" + std::to_string(i % 11)};
+      BOOST_REQUIRE(manyRecords.insert("/" + row[0] + "/" + row[1] + "/" + row[2] + "/" +
+                                       std::to_string(i), row, false));
+      rows.push_back(row);
+    }
+    for (int i = 0; i < 30000; i += 5) {
+      BOOST_REQUIRE(manyRecords.erase("/" + rows[i][0] + "/" + rows[i][1] + "/" + rows[i][2] +
+                                      "/" + std::to_string(i)));
+    }
+
+    uint64_t nExpected = 0;
+    uint64_t lastExpectedId = 0;
+    for (int i = 0; i < 30000; i++) {
+      if (i % 5 != 0 && rows[i][0] == "a1" && rows[i][2] == "c4") {
+        ++nExpected;
+        lastExpectedId = i + 1;
+      }
+    }
+    index::CatalogIndex::QueryParams params = {{"a", "a1"}, {"c", "c4"}};
+    BOOST_CHECK_EQUAL(manyRecords.count(params), nExpected);
+
+    uint64_t nFound = 0;
+    uint64_t afterId = 0;
+    std::vector<index::CatalogIndex::Record> records;
+    do {
+      records.clear();
+      manyRecords.find(params, afterId, 100, records);
+      for (const auto& record : records) {
+        BOOST_CHECK(record.id > afterId);
+        afterId = record.id;
+        ++nFound;
+      }
+    } while (!records.empty());
+    BOOST_CHECK_EQUAL(nFound, nExpected);
+    BOOST_CHECK_EQUAL(afterId, lastExpectedId);
+
+    BOOST_CHECK_EQUAL(manyRecords.count({{"b", "b%"}, {"c", "c4"}}),
+                      manyRecords.count({{"c", "c4"}}));
+
+    // the trie and the postings agree on prefix queries
+    BOOST_CHECK_EQUAL(manyRecords.count({{"a", "a1"}, {"b", "b2"}}),
+                      manyRecords.count({{"a", "a_"}, {"a", "a1"}, {"b", "b2"}}));
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,70 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/distinct-values.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(DistinctValuesTestSuite)
+
+  BOOST_AUTO_TEST_CASE(DistinctValuesAddRemove)
+  {
+    index::DistinctValues distinctValues(2);
+    uint64_t version = distinctValues.getVersion();
+
+    distinctValues.add({"CMIP5", "CSU"});
+    distinctValues.add({"CMIP5", "NCAR"}, 2);
+    BOOST_CHECK(distinctValues.getVersion() != version);
+
+    std::vector<std::string> values;
+    distinctValues.getValues(1, values);
+    std::vector<std::string> expected = {"CSU", "NCAR"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+    // a value stays while some record has it
+    version = distinctValues.getVersion();
+    distinctValues.remove({"CMIP5", "NCAR"});
+    BOOST_CHECK_EQUAL(distinctValues.getVersion(), version);
+    distinctValues.remove({"CMIP5", "CSU"});
+    BOOST_CHECK(distinctValues.getVersion() != version);
+
+    values.clear();
+    distinctValues.getValues(1, values);
+    expected = {"NCAR"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+    // unknown values and wrong sizes are ignored
+    distinctValues.remove({"CMIP6", "GFDL"});
+    distinctValues.add({"CMIP6"});
+    values.clear();
+    distinctValues.getValues(0, values);
+    expected = {"CMIP5"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+    distinctValues.clear();
+    values.clear();
+    distinctValues.getValues(0, values);
+    BOOST_CHECK(values.empty());
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
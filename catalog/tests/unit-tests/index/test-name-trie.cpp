@@ -0,0 +1,87 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/name-trie.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(NameTrieTestSuite)
+
+  BOOST_AUTO_TEST_CASE(NameTrieInsertFind)
+  {
+    index::NameTrie trie;
+    trie.insert({1, 2, 3});
+    trie.insert({1, 2, 4});
+    trie.insert({1, 5, 3});
+    trie.insert({6, 2, 3});
+    trie.insert({1, 2, 3});
+
+    BOOST_CHECK_EQUAL(trie.getCount(index::NameTrie::ROOT), 5);
+
+    std::vector<uint32_t> prefix = {1, 2};
+    index::NameTrie::NodeId node = trie.find(prefix, 2);
+    BOOST_REQUIRE(node != index::NameTrie::NONE);
+    BOOST_CHECK_EQUAL(trie.getCount(node), 3);
+
+    std::vector<uint32_t> children;
+    trie.getChildren(node, children);
+    std::vector<uint32_t> expected = {3, 4};
+    BOOST_CHECK_EQUAL_COLLECTIONS(children.begin(), children.end(),
+                                  expected.begin(), expected.end());
+
+    children.clear();
+    trie.getChildren(trie.find(prefix, 1), children);
+    expected = {2, 5};
+    BOOST_CHECK_EQUAL_COLLECTIONS(children.begin(), children.end(),
+                                  expected.begin(), expected.end());
+
+    BOOST_CHECK(trie.find({7}, 1) == index::NameTrie::NONE);
+    BOOST_CHECK(trie.find({1, 9}, 2) == index::NameTrie::NONE);
+    BOOST_CHECK(trie.find({1, 9}, 0) == index::NameTrie::ROOT);
+  }
+
+  BOOST_AUTO_TEST_CASE(NameTrieErase)
+  {
+    index::NameTrie trie;
+    trie.insert({1, 2, 3});
+    trie.insert({1, 2, 4});
+    size_t nNodes = trie.getNNodes();
+    BOOST_CHECK_EQUAL(nNodes, 5);
+
+    BOOST_CHECK(!trie.erase({1, 2, 5}));
+    BOOST_CHECK(trie.erase({1, 2, 4}));
+    BOOST_CHECK_EQUAL(trie.getNNodes(), 4);
+    BOOST_CHECK(trie.find({1, 2, 4}, 3) == index::NameTrie::NONE);
+    BOOST_CHECK_EQUAL(trie.getCount(trie.find({1}, 1)), 1);
+
+    // the freed node is reused
+    trie.insert({1, 7, 4});
+    BOOST_CHECK_EQUAL(trie.getNNodes(), 6);
+
+    BOOST_CHECK(trie.erase({1, 2, 3}));
+    BOOST_CHECK(trie.erase({1, 7, 4}));
+    BOOST_CHECK_EQUAL(trie.getNNodes(), 1);
+    BOOST_CHECK_EQUAL(trie.getCount(index::NameTrie::ROOT), 0);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
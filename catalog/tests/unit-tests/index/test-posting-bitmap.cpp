@@ -0,0 +1,129 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "index/posting-bitmap.hpp"
+#include "boost-test.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+namespace atmos{
+namespace tests{
+
+  static std::vector<uint32_t>
+  getIds(const index::PostingBitmap& bitmap)
+  {
+    std::vector<uint32_t> ids;
+    bitmap.select(0, bitmap.getCardinality() + 1, ids);
+    return ids;
+  }
+
+  BOOST_AUTO_TEST_SUITE(PostingBitmapTestSuite)
+
+  BOOST_AUTO_TEST_CASE(PostingBitmapAddRemove)
+  {
+    index::PostingBitmap bitmap;
+    BOOST_CHECK(bitmap.empty());
+    BOOST_CHECK(bitmap.add(5));
+    BOOST_CHECK(!bitmap.add(5));
+    BOOST_CHECK(bitmap.add(70000));
+    BOOST_CHECK(bitmap.add(0));
+    BOOST_CHECK_EQUAL(bitmap.getCardinality(), 3);
+    BOOST_CHECK(bitmap.contains(70000));
+    BOOST_CHECK(!bitmap.contains(6));
+
+    BOOST_CHECK(bitmap.remove(5));
+    BOOST_CHECK(!bitmap.remove(5));
+    BOOST_CHECK(!bitmap.remove(123456));
+    std::vector<uint32_t> expected = {0, 70000};
+    std::vector<uint32_t> ids = getIds(bitmap);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(), expected.begin(), expected.end());
+  }
+
+  BOOST_AUTO_TEST_CASE(PostingBitmapDenseChunk)
+  {
+    // enough ids to turn the first chunk into a bitmap
+    index::PostingBitmap bitmap;
+    for (uint32_t id = 0; id < 20000; id += 2) {
+      BOOST_CHECK(bitmap.add(id));
+    }
+    BOOST_CHECK_EQUAL(bitmap.getCardinality(), 10000);
+    BOOST_CHECK(bitmap.contains(19998));
+    BOOST_CHECK(!bitmap.contains(19999));
+
+    std::vector<uint32_t> ids;
+    bitmap.select(101, 3, ids);
+    std::vector<uint32_t> expected = {102, 104, 106};
+    BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(), expected.begin(), expected.end());
+
+    // and back to an array
+    for (uint32_t id = 0; id < 19000; id += 2) {
+      BOOST_CHECK(bitmap.remove(id));
+    }
+    BOOST_CHECK_EQUAL(bitmap.getCardinality(), 500);
+    ids = getIds(bitmap);
+    BOOST_REQUIRE_EQUAL(ids.size(), 500);
+    BOOST_CHECK_EQUAL(ids.front(), 19000);
+    BOOST_CHECK_EQUAL(ids.back(), 19998);
+    BOOST_CHECK(bitmap.getMemoryUsage() < 8192);
+  }
+
+  BOOST_AUTO_TEST_CASE(PostingBitmapSetOperations)
+  {
+    // every combination of sparse and dense chunks
+    std::set<uint32_t> multiplesOf2, multiplesOf3;
+    index::PostingBitmap bitmap2, bitmap3;
+    for (uint32_t id = 0; id < 200000; id += 2) {
+      multiplesOf2.insert(id);
+      bitmap2.add(id);
+    }
+    for (uint32_t id = 0; id < 300000; id += (id < 100000 ? 3 : 99)) {
+      multiplesOf3.insert(id);
+      bitmap3.add(id);
+    }
+
+    std::vector<uint32_t> expected;
+    std::set_intersection(multiplesOf2.begin(), multiplesOf2.end(),
+                          multiplesOf3.begin(), multiplesOf3.end(),
+                          std::back_inserter(expected));
+    index::PostingBitmap intersection = bitmap2;
+    intersection.intersectWith(bitmap3);
+    BOOST_CHECK_EQUAL(intersection.getCardinality(), expected.size());
+    std::vector<uint32_t> ids = getIds(intersection);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(), expected.begin(), expected.end());
+
+    expected.clear();
+    std::set_union(multiplesOf2.begin(), multiplesOf2.end(),
+                   multiplesOf3.begin(), multiplesOf3.end(),
+                   std::back_inserter(expected));
+    index::PostingBitmap combined = bitmap3;
+    combined.uniteWith(bitmap2);
+    BOOST_CHECK_EQUAL(combined.getCardinality(), expected.size());
+    ids = getIds(combined);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ids.begin(), ids.end(), expected.begin(), expected.end());
+
+    index::PostingBitmap empty;
+    combined.intersectWith(empty);
+    BOOST_CHECK(combined.empty());
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -23,6 +23,7 @@
 
 #include <boost/mpl/list.hpp>
 #include <boost/thread.hpp>
+#include <ndn-cxx/encoding/block-helpers.hpp>
 #include <ndn-cxx/util/dummy-client-face.hpp>
 #include <boost/property_tree/info_parser.hpp>
 
@@ -104,7 +105,8 @@ namespace tests{
 
     void
     prepareSegmentsByParams(std::vector<std::pair<std::string, std::string>>& queryParams,
-                            const ndn::Name& segmentPrefix)
+                            const ndn::Name& segmentPrefix,
+                            ResultEncoding /*encoding*/)
     {
       //BOOST_CHECK_EQUAL(sqlString, "SELECT name FROM cmip5 WHERE name=\'test\';");
       for (auto it = queryParams.begin() ; it != queryParams.end(); ++it) {
@@ -119,15 +121,13 @@ namespace tests{
       std::shared_ptr<ndn::Data> data = makeReplyData(segmentPrefix,
                                                       fileList, 0, true, false,
                                                       3, 0, 2, true);
-      m_mutex.lock();
-      m_cache.insert(*data);
-      m_mutex.unlock();
+      m_cache->insert(data, util::ContentCache::PARTITION_BULK);
     }
 
     std::shared_ptr<const ndn::Data>
     getDataFromCache(const ndn::Interest& interest)
     {
-      return m_cache.find(interest);
+      return m_cache->find(interest);
     }
 
     void
@@ -153,6 +153,15 @@ namespace tests{
       return doPrefixBasedSearch(jsonValue, typedComponents);
     }
 
+    static uint64_t
+    testGetEstimatedResultCount(uint64_t estimate,
+                                const std::string& payload,
+                                uint64_t viewEnd,
+                                bool isFinal)
+    {
+      return getEstimatedResultCount(estimate, payload, viewEnd, isFinal);
+    }
+
     bool
     testDoFilterBasedSearch(Json::Value& jsonValue,
                             std::vector<std::pair<std::string, std::string>>& typedComponents)
@@ -160,7 +169,107 @@ namespace tests{
       return doFilterBasedSearch(jsonValue, typedComponents);
     }
 
+    ndn::Name
+    testGetCanonicalQueryName(const ndn::Name& name) const
+    {
+      return getCanonicalQueryName(name);
+    }
+
+    bool
+    testAnswerFromCanonicalQuery(const ndn::Interest& interest, const ndn::Name& canonicalName)
+    {
+      return answerFromCanonicalQuery(interest, canonicalName);
+    }
+
+    void
+    insertIntoCache(const std::shared_ptr<const ndn::Data>& data)
+    {
+      m_cache->insert(data, util::ContentCache::PARTITION_BULK);
+    }
+
+    uint64_t
+    getNCanonicalQueryCopies() const
+    {
+      return m_nCanonicalQueryCopies;
+    }
+
+    void
+    subscriptionTest(const ndn::Interest& interest)
+    {
+      onSubscriptionInterest(interest);
+    }
+
+    void
+    waitForSegments(const ndn::Name& prefix)
+    {
+      if (m_signingPipeline) {
+        m_signingPipeline->waitFor(prefix);
+      }
+    }
+
+    bool
+    hasValidResults(const ndn::Name& queryName) const
+    {
+      std::string version;
+      return m_resultDependencies->find(queryName.toUri(), version);
+    }
+
+  };
+
+  class CatalogIndexAdapterTest : public query::QueryAdapter<index::CatalogIndex>
+  {
+  public:
+    CatalogIndexAdapterTest(const std::shared_ptr<ndn::util::DummyClientFace>& face,
+                            const std::shared_ptr<ndn::KeyChain>& keyChain,
+                            const std::shared_ptr<chronosync::Socket>& syncSocket)
+      : query::QueryAdapter<index::CatalogIndex>(face, keyChain, syncSocket)
+      , nRecordsBeforeFailure(0)
+    {
+    }
+
+    virtual
+    ~CatalogIndexAdapterTest()
+    {
+    }
+
+    void setDatabaseTable(const std::string& databaseTable)
+    {
+      m_databaseTable.assign(databaseTable);
+    }
+
+    void setNameFields(const std::vector<std::string>& nameFields)
+    {
+      m_nameFields = nameFields;
+    }
+
+    void
+    configAdapter(const util::ConfigSection& section,
+                  const ndn::Name& prefix)
+    {
+      onConfig(section, false, std::string("test.txt"), prefix);
+    }
+
+    bool
+    hasCatalogIndex() const
+    {
+      return m_dbConnPool != nullptr;
+    }
+
+  protected:
+    // the database connection is lost after nRecordsBeforeFailure records
+    virtual void
+    readCatalogRecords(const util::ConnectionDetails& /*databaseId*/,
+                       const CatalogRecordCallback& onRecord)
+    {
+      std::vector<std::string> fieldValues(m_nameFields.size(), "x");
+      for (size_t i = 0; i < nRecordsBeforeFailure; i++) {
+        onRecord("/x/" + std::to_string(i), fieldValues, false);
+      }
+      throw Error("Cannot load the catalog index: Lost connection to MySQL server");
+    }
 
+  public:
+    size_t nRecordsBeforeFailure;
   };
 
   class QueryAdapterFixture : public UnitTestTimeFixture
@@ -606,6 +715,232 @@ modeling_realm='Modeling' AND organization='Organization' AND product='Product'
     BOOST_CHECK_EQUAL(false, queryAdapterTest2.testDoPrefixBasedSearch(testJson2, resultComponents));
   }
 
+  BOOST_AUTO_TEST_CASE(QueryAdapterEstimatedResultCountTest)
+  {
+    // the final segment has the exact count
+    BOOST_CHECK_EQUAL(QueryAdapterTest::testGetEstimatedResultCount(1000, "[\"a\",\"b\"]", 41,
+                                                                    true), 42);
+    BOOST_CHECK_EQUAL(QueryAdapterTest::testGetEstimatedResultCount(1000, "[]", 0, true), 0);
+
+    // the others keep the estimate, unless more results have been seen already
+    BOOST_CHECK_EQUAL(QueryAdapterTest::testGetEstimatedResultCount(1000, "[\"a\"]", 9,
+                                                                    false), 1000);
+    BOOST_CHECK_EQUAL(QueryAdapterTest::testGetEstimatedResultCount(5, "[\"a\"]", 9, false), 11);
+  }
+
+  BOOST_AUTO_TEST_CASE(QueryAdapterCanonicalQueryNameTest)
+  {
+    initializeQueryAdapterTest2();
+
+    // the query-params are replaced, the version and the segment are kept
+    ndn::Name name("/test/query");
+    name.append("{ \"model\": \"x\", \"activity\": \"%\", \"experiment\": \"y\" }");
+    name.append("version").appendSegment(2);
+    ndn::Name canonicalName("/test/query");
+    canonicalName.append("{\"experiment\":\"y\",\"model\":\"x\"}");
+    canonicalName.append("version").appendSegment(2);
+    BOOST_CHECK_EQUAL(queryAdapterTest2.testGetCanonicalQueryName(name), canonicalName);
+    BOOST_CHECK_EQUAL(queryAdapterTest2.testGetCanonicalQueryName(canonicalName), canonicalName);
+
+    // a broken query is answered under its own name
+    ndn::Name broken("/test/query");
+    broken.append("{\"model\":");
+    BOOST_CHECK_EQUAL(queryAdapterTest2.testGetCanonicalQueryName(broken), broken);
+
+    // the packets of the canonical query would not fit under a much longer name
+    ndn::Name padded("/test/query");
+    padded.append(ndn::Name::Component("{\"model\":\"x\"" + std::string(200, ' ') + "}"));
+    BOOST_CHECK_EQUAL(queryAdapterTest2.testGetCanonicalQueryName(padded), padded);
+  }
+
+  BOOST_AUTO_TEST_CASE(QueryAdapterCanonicalQueryCopyTest)
+  {
+    initializeQueryAdapterTest2();
+    ndn::Name canonicalName("/test/query");
+    canonicalName.append(ndn::Name::Component("{\"model\":\"x\"}"));
+    canonicalName.append("version").appendSegment(0);
+    auto canonicalData = std::make_shared<ndn::Data>(canonicalName);
+    keyChain->signWithSha256(*canonicalData);
+    queryAdapterTest2.insertIntoCache(canonicalData);
+
+    ndn::Name name("/test/query");
+    name.append(ndn::Name::Component("{ \"model\": \"x\", \"activity\": \"%\" }"));
+    name.append("version").appendSegment(0);
+    ndn::Interest interest(name);
+    BOOST_CHECK(queryAdapterTest2.testAnswerFromCanonicalQuery(interest, canonicalName));
+    queryAdapterTest2.waitForSegments(name.getPrefix(-1));
+
+    auto copy = queryAdapterTest2.getDataFromCache(interest);
+    BOOST_REQUIRE(copy);
+    BOOST_CHECK_EQUAL(copy->getName(), name);
+
+    // later Interests get the cached copy instead of a new one
+    BOOST_CHECK(queryAdapterTest2.testAnswerFromCanonicalQuery(interest, canonicalName));
+    BOOST_CHECK_EQUAL(queryAdapterTest2.getNCanonicalQueryCopies(), 1);
+  }
+
+  BOOST_AUTO_TEST_CASE(QueryAdapterResultInvalidationTest)
+  {
+    initializeQueryAdapterTest2();
+    ndn::Name queryName("/test/query");
+    queryName.append("{\"model\":\"x\"}");
+    queryAdapterTest2.queryTest(std::make_shared<ndn::Interest>(queryName));
+    BOOST_CHECK(queryAdapterTest2.hasValidResults(queryName));
+
+    // the results of model x do not depend on a file of model y
+    std::vector<std::string> added, removed;
+    added.push_back("/CMIP5/output/org/y/historical/mon/atmos/tas/r1i1p1/1850-2005");
+    queryAdapterTest2.onPublicationUpdate(added, removed);
+    BOOST_CHECK(queryAdapterTest2.hasValidResults(queryName));
+
+    removed.push_back("/CMIP5/output/org/x/historical/mon/atmos/tas/r1i1p1/1850-2005");
+    queryAdapterTest2.onPublicationUpdate(std::vector<std::string>(), removed);
+    BOOST_CHECK(!queryAdapterTest2.hasValidResults(queryName));
+  }
+
+  BOOST_AUTO_TEST_CASE(QueryAdapterDeltaQueryTest)
+  {
+    initializeQueryAdapterTest2();
+    std::vector<std::string> added, removed;
+    added.push_back("/CMIP5/output/org/x/historical/mon/atmos/tas/r1i1p1/1850-2005");
+    added.push_back("/CMIP5/output/org/y/historical/mon/atmos/tas/r1i1p1/1850-2005");
+    removed.push_back("/CMIP5/output/org/x/rcp45/mon/atmos/tas/r1i1p1/2006-2100");
+    queryAdapterTest2.onPublicationUpdate(added, removed);
+
+    // only the changes of model x since the initial version
+    ndn::Name queryName("/test/query");
+    queryName.append("{\"model\":\"x\",\"since\":\"0\"}");
+    auto queryInterest = std::make_shared<ndn::Interest>(queryName);
+    queryAdapterTest2.queryTest(queryInterest);
+    queryAdapterTest2.waitForSegments(queryName);
+
+    auto replyData = queryAdapterTest2.getDataFromCache(*queryInterest);
+    BOOST_REQUIRE(replyData);
+    const std::string jsonRes(reinterpret_cast<const char*>(replyData->getContent().value()),
+                              replyData->getContent().value_size());
+    Json::Value parsedFromString;
+    Json::Reader reader;
+    BOOST_REQUIRE(reader.parse(jsonRes, parsedFromString));
+    BOOST_CHECK_EQUAL(parsedFromString["resultCount"], 2);
+    BOOST_REQUIRE_EQUAL(parsedFromString["results"].size(), 2);
+    BOOST_CHECK_EQUAL(parsedFromString["results"][0]["name"], added[0]);
+    BOOST_CHECK(!parsedFromString["results"][0].isMember("removed"));
+    BOOST_CHECK_EQUAL(parsedFromString["results"][1]["name"], removed[0]);
+    BOOST_CHECK_EQUAL(parsedFromString["results"][1]["removed"], true);
+
+    // the changes since an unknown version are not kept
+    ndn::Name unknownName("/test/query");
+    unknownName.append("{\"model\":\"x\",\"since\":\"unknown\"}");
+    auto unknownInterest = std::make_shared<ndn::Interest>(unknownName);
+    queryAdapterTest2.queryTest(unknownInterest);
+
+    auto nackData = queryAdapterTest2.getDataFromCache(*unknownInterest);
+    BOOST_REQUIRE(nackData);
+    BOOST_CHECK_EQUAL(nackData->getContent().value_size(), 0);
+  }
+
+  BOOST_AUTO_TEST_CASE(QueryAdapterTlvEncodingTest)
+  {
+    initializeQueryAdapterTest2();
+    std::vector<std::string> added, removed;
+    added.push_back("/CMIP5/output/org/x/historical/mon/atmos/tas/r1i1p1/1850-2005");
+    queryAdapterTest2.onPublicationUpdate(added, removed);
+
+    // the changes since the initial version, as Result elements
+    ndn::Name queryName("/test/query");
+    queryName.append("{\"model\":\"x\",\"since\":\"0\",\"encoding\":\"tlv\"}");
+    auto queryInterest = std::make_shared<ndn::Interest>(queryName);
+    queryAdapterTest2.queryTest(queryInterest);
+    queryAdapterTest2.waitForSegments(queryName);
+
+    auto replyData = queryAdapterTest2.getDataFromCache(*queryInterest);
+    BOOST_REQUIRE(replyData);
+    ndn::Block content = replyData->getContent();
+    content.parse();
+    BOOST_REQUIRE_EQUAL(content.elements().size(), 4);
+    BOOST_CHECK_EQUAL(content.elements()[0].type(), util::tlv::ResultCount);
+    BOOST_CHECK_EQUAL(ndn::readNonNegativeInteger(content.elements()[0]), 1);
+    ndn::Block result = content.elements()[3];
+    BOOST_CHECK_EQUAL(result.type(), util::tlv::Result);
+    result.parse();
+    BOOST_REQUIRE_EQUAL(result.elements().size(), 1);
+    BOOST_CHECK_EQUAL(ndn::Name(result.elements()[0]), ndn::Name(added[0]));
+
+    // autocompletion is only answered in Json
+    ndn::Name autocompletionName("/test/query");
+    autocompletionName.append("{\"?\":\"/\",\"encoding\":\"tlv\"}");
+    auto autocompletionInterest = std::make_shared<ndn::Interest>(autocompletionName);
+    queryAdapterTest2.queryTest(autocompletionInterest);
+
+    auto nackData = queryAdapterTest2.getDataFromCache(*autocompletionInterest);
+    BOOST_REQUIRE(nackData);
+    BOOST_CHECK_EQUAL(nackData->getContent().value_size(), 0);
+  }
+
+  BOOST_AUTO_TEST_CASE(QueryAdapterSubscriptionTest)
+  {
+    initializeQueryAdapterTest2();
+    ndn::Name subscribeName("/test/subscribe");
+    subscribeName.append("{\"model\":\"x\"}");
+    queryAdapterTest2.subscriptionTest(ndn::Interest(subscribeName));
+
+    std::vector<std::string> added, removed;
+    added.push_back("/CMIP5/output/org/x/historical/mon/atmos/tas/r1i1p1/1850-2005");
+    added.push_back("/CMIP5/output/org/y/historical/mon/atmos/tas/r1i1p1/1850-2005");
+    queryAdapterTest2.onPublicationUpdate(added, removed);
+
+    // the notification lists the changed names of model x
+    ndn::Name streamName("/test/subscriptions");
+    streamName.append("{\"model\":\"x\"}");
+    queryAdapterTest2.waitForSegments(streamName);
+    auto notification =
+      queryAdapterTest2.getDataFromCache(ndn::Interest(ndn::Name(streamName).appendNumber(0)));
+    BOOST_REQUIRE(notification);
+    const std::string jsonRes(reinterpret_cast<const char*>(notification->getContent().value()),
+                              notification->getContent().value_size());
+    Json::Value parsedFromString;
+    Json::Reader reader;
+    BOOST_REQUIRE(reader.parse(jsonRes, parsedFromString));
+    BOOST_CHECK_EQUAL(parsedFromString["sequence"], 0);
+    BOOST_CHECK_EQUAL(parsedFromString["resultCount"], 1);
+    BOOST_REQUIRE_EQUAL(parsedFromString["results"].size(), 1);
+    BOOST_CHECK_EQUAL(parsedFromString["results"][0]["name"], added[0]);
+
+    // a publication that does not change the results is not notified
+    removed.push_back(added[1]);
+    queryAdapterTest2.onPublicationUpdate(std::vector<std::string>(), removed);
+    queryAdapterTest2.waitForSegments(streamName);
+    BOOST_CHECK(!queryAdapterTest2.getDataFromCache(
+                  ndn::Interest(ndn::Name(streamName).appendNumber(1))));
+  }
+
+  BOOST_AUTO_TEST_CASE(QueryAdapterCatalogIndexLoadFailureTest)
+  {
+    keyChain->createIdentity(ndn::Name("/test/catalogIndex"));
+    CatalogIndexAdapterTest adapter(face, keyChain, syncSocket);
+    adapter.setDatabaseTable(databaseTable);
+    adapter.setNameFields(nameFields);
+    adapter.nRecordsBeforeFailure = 2;
+
+    util::ConfigSection section;
+    std::stringstream ss;
+    ss << "signingId /test/catalogIndex\
+         filterCategoryNames activity,product,organization,model,experiment,frequency,modeling_realm,variable_name,ensemble\
+         database                   \
+         {                          \
+          dbServer localhost        \
+          dbName testdb             \
+          dbUser testuser           \
+          dbPasswd testpwd          \
+         }";
+    boost::property_tree::read_info(ss, section);
+
+    // a partly loaded index must not be served as if it were complete
+    BOOST_CHECK_THROW(adapter.configAdapter(section, ndn::Name("/test")),
+                      util::CatalogAdapter::Error);
+    BOOST_CHECK(!adapter.hasCatalogIndex());
+  }
+
   BOOST_AUTO_TEST_SUITE_END()
 
 }//tests
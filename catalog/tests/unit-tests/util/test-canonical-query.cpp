@@ -0,0 +1,85 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/canonical-query.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(CanonicalQueryTestSuite)
+
+  static const std::vector<std::string> NAME_FIELDS = {"activity", "model", "experiment"};
+
+  BOOST_AUTO_TEST_CASE(CanonicalQueryFilters)
+  {
+    const std::string canonical = "{\"experiment\":\"y\",\"model\":\"x\"}";
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":\"x\",\"experiment\":\"y\"}",
+                                                  NAME_FIELDS), canonical);
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery(" { \"experiment\" : \"y\",\n\"model\":\"x\" } ",
+                                                  NAME_FIELDS), canonical);
+
+    // no-op filters and keys that are not name fields do not change the results
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":\"x\",\"experiment\":\"y\","
+                                                  "\"activity\":\"%%\",\"color\":\"red\"}",
+                                                  NAME_FIELDS), canonical);
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"activity\":\"%\"}", NAME_FIELDS), "{}");
+    // an empty value only matches empty fields
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"activity\":\"\"}", NAME_FIELDS),
+                      "{\"activity\":\"\"}");
+
+    // values are compared as the strings the query is run with
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":1}", NAME_FIELDS),
+                      "{\"model\":\"1\"}");
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":\"x%\"}", NAME_FIELDS),
+                      "{\"model\":\"x%\"}");
+  }
+
+  BOOST_AUTO_TEST_CASE(CanonicalQuerySearches)
+  {
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"?\":\"/CMIP5/\",\"model\":\"x\"}",
+                                                  NAME_FIELDS), "{\"?\":\"/CMIP5/\"}");
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{ \"??\" : \"/CMIP5/output\" }",
+                                                  NAME_FIELDS), "{\"??\":\"/CMIP5/output\"}");
+
+    // the version of a delta query is kept
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"since\":\"a1\", \"model\":\"x\"}",
+                                                  NAME_FIELDS),
+                      "{\"model\":\"x\",\"since\":\"a1\"}");
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"since\":\"a1\",\"??\":\"/CMIP5\"}",
+                                                  NAME_FIELDS),
+                      "{\"??\":\"/CMIP5\",\"since\":\"a1\"}");
+
+    // the binary encoding selects other segments, the default one is dropped
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":\"x\",\"encoding\":\"tlv\"}",
+                                                  NAME_FIELDS),
+                      "{\"encoding\":\"tlv\",\"model\":\"x\"}");
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":\"x\",\"encoding\":\"json\"}",
+                                                  NAME_FIELDS), "{\"model\":\"x\"}");
+
+    // queries that are rejected have no canonical form
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":", NAME_FIELDS), "");
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("[\"model\"]", NAME_FIELDS), "");
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":null}", NAME_FIELDS), "");
+    BOOST_CHECK_EQUAL(util::canonicalizeJsonQuery("{\"model\":[\"x\"]}", NAME_FIELDS), "");
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,79 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/change-log.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(ChangeLogTestSuite)
+
+  BOOST_AUTO_TEST_CASE(ChangeLogChangesSince)
+  {
+    util::ChangeLog log(100);
+    log.markVersion("v1");
+    log.append({"/a", "/b"}, {});
+    log.markVersion("v2");
+    log.append({"/c"}, {"/a"});
+    log.markVersion("v3");
+
+    std::vector<util::ChangeLog::Change> changes;
+    BOOST_REQUIRE(log.getChangesSince("v1", changes));
+    // /a was added and then removed, the last change wins
+    BOOST_REQUIRE_EQUAL(changes.size(), 3);
+    BOOST_CHECK_EQUAL(changes[0].name, "/a");
+    BOOST_CHECK(changes[0].isRemoved);
+    BOOST_CHECK_EQUAL(changes[1].name, "/b");
+    BOOST_CHECK(!changes[1].isRemoved);
+    BOOST_CHECK_EQUAL(changes[2].name, "/c");
+    BOOST_CHECK(!changes[2].isRemoved);
+
+    BOOST_REQUIRE(log.getChangesSince("v2", changes));
+    BOOST_CHECK_EQUAL(changes.size(), 2);
+    BOOST_REQUIRE(log.getChangesSince("v3", changes));
+    BOOST_CHECK_EQUAL(changes.size(), 0);
+
+    BOOST_CHECK(!log.getChangesSince("unknown", changes));
+  }
+
+  BOOST_AUTO_TEST_CASE(ChangeLogDropOldest)
+  {
+    util::ChangeLog log(3);
+    log.markVersion("v1");
+    log.append({"/a", "/b"}, {});
+    log.markVersion("v2");
+    log.append({"/c", "/d"}, {});
+    log.markVersion("v3");
+
+    // the first change is gone, so v1 cannot be served while v2 still can
+    std::vector<util::ChangeLog::Change> changes;
+    BOOST_CHECK(!log.getChangesSince("v1", changes));
+    BOOST_REQUIRE(log.getChangesSince("v2", changes));
+    BOOST_CHECK_EQUAL(changes.size(), 2);
+
+    util::ChangeLog::Statistics statistics = log.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nChanges, 3);
+    BOOST_CHECK_EQUAL(statistics.nVersions, 2);
+    BOOST_CHECK_EQUAL(statistics.nDropped, 1);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,212 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/content-cache.hpp"
+#include "boost-test.hpp"
+
+#include <ndn-cxx/security/digest-sha256.hpp>
+
+namespace atmos{
+namespace tests{
+
+  static std::shared_ptr<ndn::Data>
+  makeData(const ndn::Name& name, ndn::time::milliseconds freshnessPeriod)
+  {
+    auto data = std::make_shared<ndn::Data>(name);
+    data->setFreshnessPeriod(freshnessPeriod);
+    std::vector<uint8_t> payload(100, 'a');
+    data->setContent(payload.data(), payload.size());
+    data->setSignature(ndn::DigestSha256());
+    data->setSignatureValue(ndn::Block(ndn::tlv::SignatureValue,
+                                       std::make_shared<ndn::Buffer>(32)));
+    data->wireEncode();
+    return data;
+  }
+
+  static size_t
+  getEntrySize(const ndn::Data& data)
+  {
+    return data.wireEncode().size() + data.getName().wireEncode().size();
+  }
+
+  BOOST_AUTO_TEST_SUITE(ContentCacheTestSuite)
+
+  BOOST_AUTO_TEST_CASE(ContentCacheFind)
+  {
+    util::ContentCache cache(1024 * 1024, 0, 4, 3);
+    const ndn::Name prefix("/catalog/query/%7B%7D/version");
+    for (uint64_t i = 0; i < 3; i++) {
+      cache.insert(makeData(ndn::Name(prefix).appendSegment(i), ndn::time::milliseconds(10000)),
+                   util::ContentCache::PARTITION_BULK);
+    }
+    cache.insert(makeData("/catalog/query/%7B%7D", ndn::time::milliseconds(0)),
+                 util::ContentCache::PARTITION_BULK);
+
+    auto data = cache.find(ndn::Interest(ndn::Name(prefix).appendSegment(1)));
+    BOOST_REQUIRE(data != nullptr);
+    BOOST_CHECK_EQUAL(data->getName(), ndn::Name(prefix).appendSegment(1));
+
+    // a prefix Interest gets the first segment
+    data = cache.find(ndn::Interest(prefix));
+    BOOST_REQUIRE(data != nullptr);
+    BOOST_CHECK_EQUAL(data->getName(), ndn::Name(prefix).appendSegment(0));
+
+    // the name is shorter than the shard key, so every shard is searched
+    data = cache.find(ndn::Interest("/catalog/query"));
+    BOOST_CHECK(data != nullptr);
+
+    // the NACK is stale right away
+    ndn::Interest freshInterest("/catalog/query/%7B%7D");
+    freshInterest.setMustBeFresh(true);
+    freshInterest.setMaxSuffixComponents(1);
+    BOOST_CHECK(cache.find(freshInterest) == nullptr);
+    freshInterest.setMustBeFresh(false);
+    BOOST_CHECK(cache.find(freshInterest) != nullptr);
+
+    BOOST_CHECK(cache.find(ndn::Interest("/catalog/query/%7B%7D/other")) == nullptr);
+
+    util::ContentCache::Statistics statistics = cache.getStatistics();
+    const util::ContentCache::PartitionStatistics& bulk =
+      statistics.partitions[util::ContentCache::PARTITION_BULK];
+    BOOST_CHECK_EQUAL(bulk.nEntries, 4);
+    BOOST_CHECK_EQUAL(bulk.nInsertions, 4);
+    BOOST_CHECK_EQUAL(bulk.nHits, 4);
+    BOOST_CHECK_EQUAL(bulk.nEvictions, 0);
+    BOOST_CHECK_EQUAL(statistics.nMisses, 2);
+  }
+
+  BOOST_AUTO_TEST_CASE(ContentCacheQuotas)
+  {
+    size_t entrySize = getEntrySize(*makeData(ndn::Name("/cache/bulk").appendSegment(0),
+                                              ndn::time::milliseconds(0)));
+
+    // room for 10 interactive and 10 bulk packets in a single shard
+    util::ContentCache cache(20 * entrySize, 10 * entrySize, 1, 2);
+    for (uint64_t i = 0; i < 5; i++) {
+      cache.insert(makeData(ndn::Name("/cache/auto").appendSegment(i),
+                            ndn::time::milliseconds(10000)),
+                   util::ContentCache::PARTITION_INTERACTIVE);
+    }
+    // a large scan only evicts bulk packets
+    for (uint64_t i = 0; i < 100; i++) {
+      cache.insert(makeData(ndn::Name("/cache/bulk").appendSegment(i),
+                            ndn::time::milliseconds(10000)),
+                   util::ContentCache::PARTITION_BULK);
+    }
+
+    for (uint64_t i = 0; i < 5; i++) {
+      BOOST_CHECK(cache.find(ndn::Interest(ndn::Name("/cache/auto").appendSegment(i))) != nullptr);
+    }
+    // the last packets of the scan are still there for its consumer
+    BOOST_CHECK(cache.find(ndn::Interest(ndn::Name("/cache/bulk").appendSegment(99))) != nullptr);
+
+    util::ContentCache::Statistics statistics = cache.getStatistics();
+    const util::ContentCache::PartitionStatistics& interactive =
+      statistics.partitions[util::ContentCache::PARTITION_INTERACTIVE];
+    const util::ContentCache::PartitionStatistics& bulk =
+      statistics.partitions[util::ContentCache::PARTITION_BULK];
+    BOOST_CHECK_EQUAL(interactive.nEntries, 5);
+    BOOST_CHECK_EQUAL(interactive.nEvictions, 0);
+    BOOST_CHECK_LE(bulk.memoryUsage, bulk.memoryLimit);
+    BOOST_CHECK_EQUAL(bulk.nEntries + bulk.nEvictions, 100);
+  }
+
+  BOOST_AUTO_TEST_CASE(ContentCacheReplaceWithOtherPartition)
+  {
+    size_t entrySize = getEntrySize(*makeData(ndn::Name("/cache/bulk").appendSegment(0),
+                                              ndn::time::milliseconds(0)));
+
+    // room for 10 interactive and 10 bulk packets in a single shard
+    util::ContentCache cache(20 * entrySize, 10 * entrySize, 1, 2);
+    for (uint64_t i = 0; i < 5; i++) {
+      cache.insert(makeData(ndn::Name("/cache/auto").appendSegment(i),
+                            ndn::time::milliseconds(10000)),
+                   util::ContentCache::PARTITION_INTERACTIVE);
+    }
+    cache.insert(makeData(ndn::Name("/cache/auto").appendSegment(0),
+                          ndn::time::milliseconds(10000)),
+                 util::ContentCache::PARTITION_BULK);
+
+    util::ContentCache::Statistics statistics = cache.getStatistics();
+    const util::ContentCache::PartitionStatistics& interactive =
+      statistics.partitions[util::ContentCache::PARTITION_INTERACTIVE];
+    const util::ContentCache::PartitionStatistics& bulk =
+      statistics.partitions[util::ContentCache::PARTITION_BULK];
+    BOOST_CHECK_EQUAL(interactive.nEntries, 4);
+    BOOST_CHECK_EQUAL(interactive.memoryUsage, 4 * entrySize);
+    BOOST_CHECK_EQUAL(bulk.nEntries, 1);
+    BOOST_CHECK_EQUAL(bulk.memoryUsage, entrySize);
+
+    // the packet is evicted with the bulk packets, which cannot touch the interactive ones
+    for (uint64_t i = 0; i < 100; i++) {
+      cache.insert(makeData(ndn::Name("/cache/bulk").appendSegment(i),
+                            ndn::time::milliseconds(10000)),
+                   util::ContentCache::PARTITION_BULK);
+    }
+    BOOST_CHECK(cache.find(ndn::Interest(ndn::Name("/cache/auto").appendSegment(0))) == nullptr);
+    for (uint64_t i = 1; i < 5; i++) {
+      BOOST_CHECK(cache.find(ndn::Interest(ndn::Name("/cache/auto").appendSegment(i))) != nullptr);
+    }
+
+    statistics = cache.getStatistics();
+    BOOST_CHECK_LE(bulk.memoryUsage, bulk.memoryLimit);
+    BOOST_CHECK_EQUAL(interactive.nEvictions, 0);
+  }
+
+  BOOST_AUTO_TEST_CASE(ContentCacheFrequencyAdmission)
+  {
+    size_t entrySize = getEntrySize(*makeData(ndn::Name("/cache/scan").appendSegment(0),
+                                              ndn::time::milliseconds(0)));
+
+    // room for 20 bulk packets in a single shard, 2 of them in the window
+    util::ContentCache cache(20 * entrySize, 0, 1, 2);
+    for (uint64_t i = 0; i < 5; i++) {
+      cache.insert(makeData(ndn::Name("/cache/hot").appendSegment(i),
+                            ndn::time::milliseconds(10000)),
+                   util::ContentCache::PARTITION_BULK);
+    }
+    for (int round = 0; round < 3; round++) {
+      for (uint64_t i = 0; i < 5; i++) {
+        BOOST_CHECK(cache.find(ndn::Interest(ndn::Name("/cache/hot").appendSegment(i))) != nullptr);
+      }
+    }
+
+    // the scan is requested once, so it cannot displace the popular packets
+    cache.find(ndn::Interest("/cache/scan"));
+    for (uint64_t i = 0; i < 100; i++) {
+      cache.insert(makeData(ndn::Name("/cache/scan").appendSegment(i),
+                            ndn::time::milliseconds(10000)),
+                   util::ContentCache::PARTITION_BULK);
+    }
+
+    for (uint64_t i = 0; i < 5; i++) {
+      BOOST_CHECK(cache.find(ndn::Interest(ndn::Name("/cache/hot").appendSegment(i))) != nullptr);
+    }
+    BOOST_CHECK(cache.find(ndn::Interest(ndn::Name("/cache/scan").appendSegment(99))) != nullptr);
+
+    util::ContentCache::Statistics statistics = cache.getStatistics();
+    const util::ContentCache::PartitionStatistics& bulk =
+      statistics.partitions[util::ContentCache::PARTITION_BULK];
+    BOOST_CHECK_GT(bulk.nRejections, 0);
+    BOOST_CHECK_LE(bulk.memoryUsage, bulk.memoryLimit);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,120 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/face-dispatcher.hpp"
+#include "boost-test.hpp"
+
+#include <boost/asio/io_service.hpp>
+
+#include <thread>
+#include <vector>
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(FaceDispatcherTestSuite)
+
+  BOOST_AUTO_TEST_CASE(FaceDispatcherBatchesInOrder)
+  {
+    boost::asio::io_service ioService;
+    std::vector<ndn::Name> sunk;
+
+    auto dispatcher = std::make_shared<util::FaceDispatcher>(ioService, 100,
+                        [&sunk] (const ndn::Data& data) { sunk.push_back(data.getName()); });
+
+    const ndn::Name prefix("/catalog/query/%7B%7D/version");
+    for (uint64_t i = 0; i < 10; i++) {
+      dispatcher->put(std::make_shared<ndn::Data>(ndn::Name(prefix).appendSegment(i)));
+    }
+    BOOST_CHECK(sunk.empty());
+    BOOST_CHECK_EQUAL(dispatcher->getStatistics().queueLength, 10);
+
+    // a single drain task puts all of them
+    BOOST_CHECK_EQUAL(ioService.poll(), 1);
+    BOOST_REQUIRE_EQUAL(sunk.size(), 10);
+    for (uint64_t i = 0; i < 10; i++) {
+      BOOST_CHECK_EQUAL(sunk[i], ndn::Name(prefix).appendSegment(i));
+    }
+
+    util::FaceDispatcher::Statistics statistics = dispatcher->getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nPackets, 10);
+    BOOST_CHECK_EQUAL(statistics.nBatches, 1);
+    BOOST_CHECK_EQUAL(statistics.queueLength, 0);
+    BOOST_CHECK_EQUAL(statistics.maxQueueLength, 10);
+    BOOST_CHECK_EQUAL(statistics.maxBatchSize, 10);
+  }
+
+  BOOST_AUTO_TEST_CASE(FaceDispatcherManyProducers)
+  {
+    boost::asio::io_service ioService;
+    size_t nSunk = 0;
+
+    auto dispatcher = std::make_shared<util::FaceDispatcher>(ioService, 4000,
+                        [&nSunk] (const ndn::Data&) { ++nSunk; });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; t++) {
+      producers.emplace_back([dispatcher, t] {
+          for (uint64_t i = 0; i < 1000; i++) {
+            dispatcher->put(std::make_shared<ndn::Data>(
+                              ndn::Name("/producer").appendSegment(t).appendSegment(i)));
+          }
+        });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+
+    ioService.poll();
+    BOOST_CHECK_EQUAL(nSunk, 4000);
+    BOOST_CHECK_EQUAL(dispatcher->getStatistics().nPackets, 4000);
+    BOOST_CHECK_EQUAL(dispatcher->getStatistics().queueLength, 0);
+  }
+
+  BOOST_AUTO_TEST_CASE(FaceDispatcherQueueLimit)
+  {
+    boost::asio::io_service ioService;
+    size_t nSunk = 0;
+
+    auto dispatcher = std::make_shared<util::FaceDispatcher>(ioService, 3,
+                        [&nSunk] (const ndn::Data&) { ++nSunk; });
+
+    const ndn::Name prefix("/catalog/query/%7B%7D/version");
+    for (uint64_t i = 0; i < 5; i++) {
+      BOOST_CHECK_EQUAL(dispatcher->put(std::make_shared<ndn::Data>(
+                                          ndn::Name(prefix).appendSegment(i))), i < 3);
+    }
+    ioService.poll();
+    BOOST_CHECK_EQUAL(nSunk, 3);
+
+    // the drained queue takes packets again
+    BOOST_CHECK(dispatcher->put(std::make_shared<ndn::Data>(ndn::Name(prefix).appendSegment(5))));
+    ioService.reset();
+    ioService.poll();
+    BOOST_CHECK_EQUAL(nSunk, 4);
+
+    util::FaceDispatcher::Statistics statistics = dispatcher->getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nPackets, 4);
+    BOOST_CHECK_EQUAL(statistics.nDropped, 2);
+    BOOST_CHECK_EQUAL(statistics.maxQueueLength, 3);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,66 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/frequency-sketch.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(FrequencySketchTestSuite)
+
+  BOOST_AUTO_TEST_CASE(FrequencySketchEstimate)
+  {
+    util::FrequencySketch sketch(64);
+    for (int i = 0; i < 5; i++) {
+      sketch.increment(1);
+    }
+    sketch.increment(2);
+
+    // Count-Min never underestimates
+    BOOST_CHECK_GE(sketch.estimate(1), 5);
+    BOOST_CHECK_GE(sketch.estimate(2), 1);
+    BOOST_CHECK_LT(sketch.estimate(2), sketch.estimate(1));
+
+    for (int i = 0; i < 100; i++) {
+      sketch.increment(1);
+    }
+    BOOST_CHECK_EQUAL(sketch.estimate(1), util::FrequencySketch::MAX_COUNT);
+  }
+
+  BOOST_AUTO_TEST_CASE(FrequencySketchAging)
+  {
+    util::FrequencySketch sketch(64);
+    for (int i = 0; i < 20; i++) {
+      sketch.increment(1);
+    }
+    BOOST_CHECK_EQUAL(sketch.estimate(1), util::FrequencySketch::MAX_COUNT);
+
+    // the sample is ten times the width, the counters are halved once it is complete
+    for (uint64_t key = 100; key < 100 + 640 - 20; key++) {
+      sketch.increment(key);
+    }
+    BOOST_CHECK_EQUAL(sketch.getNResets(), 1);
+    BOOST_CHECK_LE(sketch.estimate(1), util::FrequencySketch::MAX_COUNT / 2 + 1);
+    BOOST_CHECK_GE(sketch.estimate(1), util::FrequencySketch::MAX_COUNT / 2);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,104 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/payload-budget.hpp"
+#include "boost-test.hpp"
+
+#include <ndn-cxx/security/digest-sha256.hpp>
+
+#include <limits>
+
+namespace atmos{
+namespace tests{
+
+  // stand-in for the KeyChain that adds a digest signature of the right size
+  static void
+  signWithDigest(ndn::Data& data)
+  {
+    data.setSignature(ndn::DigestSha256());
+    data.setSignatureValue(ndn::Block(ndn::tlv::SignatureValue,
+                                      std::make_shared<ndn::Buffer>(32)));
+  }
+
+  static util::PayloadBudget::Signer
+  makeSigner(size_t& nSignatures)
+  {
+    return [&nSignatures] (ndn::Data& data, const ndn::Name&) {
+      signWithDigest(data);
+      ++nSignatures;
+    };
+  }
+
+  static size_t
+  makeSegmentSize(const ndn::Name& prefix, size_t payloadSize)
+  {
+    ndn::Data data(ndn::Name(prefix).appendSegment(std::numeric_limits<uint64_t>::max()));
+    data.setFreshnessPeriod(ndn::time::milliseconds(10000));
+    data.setFinalBlockId(ndn::Name::Component::fromSegment(std::numeric_limits<uint64_t>::max()));
+    std::vector<uint8_t> payload(payloadSize, 'a');
+    data.setContent(payload.data(), payload.size());
+    signWithDigest(data);
+    return data.wireEncode().size();
+  }
+
+  BOOST_AUTO_TEST_SUITE(PayloadBudgetTestSuite)
+
+  BOOST_AUTO_TEST_CASE(PayloadBudgetFitsPacket)
+  {
+    size_t nSignatures = 0;
+    util::PayloadBudget budget(ndn::MAX_NDN_PACKET_SIZE, makeSigner(nSignatures));
+
+    const ndn::Name shortPrefix("/catalog/query/%7B%7D/version");
+    size_t shortLimit = budget.getPayloadLimit(shortPrefix, ndn::Name());
+    BOOST_CHECK_LE(makeSegmentSize(shortPrefix, shortLimit), ndn::MAX_NDN_PACKET_SIZE);
+    // only the slack for the signature and the worst-case MetaInfo is left unused
+    BOOST_CHECK_GT(makeSegmentSize(shortPrefix, shortLimit + 32), ndn::MAX_NDN_PACKET_SIZE);
+
+    // a longer name leaves less room, and is computed without signing again
+    const ndn::Name longPrefix(shortPrefix.toUri() + "/" + std::string(500, 'x'));
+    size_t longLimit = budget.getPayloadLimit(longPrefix, ndn::Name());
+    BOOST_CHECK_LE(makeSegmentSize(longPrefix, longLimit), ndn::MAX_NDN_PACKET_SIZE);
+    BOOST_CHECK_LT(longLimit + 500, shortLimit + 5);
+    BOOST_CHECK_EQUAL(nSignatures, 1);
+
+    // every signing identity is measured once
+    budget.getPayloadLimit(shortPrefix, ndn::Name("/test/signingId"));
+    BOOST_CHECK_EQUAL(nSignatures, 2);
+    budget.reset();
+    budget.getPayloadLimit(shortPrefix, ndn::Name());
+    BOOST_CHECK_EQUAL(nSignatures, 3);
+  }
+
+  BOOST_AUTO_TEST_CASE(PayloadBudgetSmallPacket)
+  {
+    size_t nSignatures = 0;
+    util::PayloadBudget budget(1200, makeSigner(nSignatures));
+    const ndn::Name prefix("/catalog/filters-initialization");
+    size_t limit = budget.getPayloadLimit(prefix, ndn::Name());
+    BOOST_CHECK_LE(makeSegmentSize(prefix, limit), 1200);
+    BOOST_CHECK_GT(limit, 1000);
+
+    // the name alone does not fit, but a segment can still be made
+    util::PayloadBudget tinyBudget(10, makeSigner(nSignatures));
+    BOOST_CHECK_EQUAL(tinyBudget.getPayloadLimit(prefix, ndn::Name()), 1);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,191 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/result-cursor.hpp"
+#include "boost-test.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace atmos{
+namespace tests{
+
+  class ResultCursorFixture
+  {
+  public:
+    ResultCursorFixture()
+      : nFetches(0)
+    {
+      // rows with ids 10, 20, ..., each encoded as a 5-byte Json string
+      for (uint64_t id = 10; id <= 100; id += 10) {
+        rows.push_back(id);
+      }
+    }
+
+    util::ResultCursor::RowFetcher
+    makeFetcher()
+    {
+      return [this] (uint64_t afterId, uint64_t upToId, size_t limit,
+                     std::vector<std::string>& entries, uint64_t& lastId) {
+        ++nFetches;
+        for (uint64_t id : rows) {
+          if (id > afterId && id <= upToId && entries.size() < limit) {
+            entries.push_back("\"" + std::to_string(id + 900) + "\"");
+            lastId = id;
+          }
+        }
+        return true;
+      };
+    }
+
+    util::SegmentEncoder::SegmentCallback
+    makeCallback()
+    {
+      return [this] (const std::string& payload, uint64_t segmentNo,
+                     uint64_t /*viewStart*/, uint64_t /*viewEnd*/, bool isFinal) {
+        BOOST_CHECK_EQUAL(segmentNo, segments.size());
+        segments.push_back(payload);
+        isFinalSeen = isFinal;
+      };
+    }
+
+  public:
+    std::vector<uint64_t> rows;
+    std::vector<std::string> segments;
+    bool isFinalSeen = false;
+    size_t nFetches;
+  };
+
+  BOOST_FIXTURE_TEST_SUITE(ResultCursorTestSuite, ResultCursorFixture)
+
+  BOOST_AUTO_TEST_CASE(ResultCursorOnDemand)
+  {
+    // two rows per segment: ["910","920"] is 13 bytes
+    util::ResultCursor cursor(makeFetcher(), 100, 3, 14, makeCallback());
+    BOOST_CHECK_EQUAL(cursor.getNSegments(), 0);
+
+    BOOST_CHECK(cursor.advance(0));
+    BOOST_REQUIRE_EQUAL(segments.size(), 1);
+    BOOST_CHECK_EQUAL(segments[0], "[\"910\",\"920\"]");
+    BOOST_CHECK_EQUAL(nFetches, 1);
+    BOOST_CHECK(!cursor.isFinished());
+
+    // nothing new for a segment that exists
+    BOOST_CHECK(cursor.advance(0));
+    BOOST_CHECK_EQUAL(segments.size(), 1);
+
+    BOOST_CHECK(cursor.advance(2));
+    BOOST_REQUIRE_EQUAL(segments.size(), 3);
+    BOOST_CHECK_EQUAL(segments[2], "[\"950\",\"960\"]");
+    BOOST_CHECK(!isFinalSeen);
+
+    BOOST_CHECK(!cursor.advance(10));
+    BOOST_REQUIRE_EQUAL(segments.size(), 5);
+    BOOST_CHECK_EQUAL(segments[4], "[\"990\",\"1000\"]");
+    BOOST_CHECK(isFinalSeen);
+    BOOST_CHECK(cursor.isFinished());
+    BOOST_CHECK(cursor.advance(4));
+  }
+
+  BOOST_AUTO_TEST_CASE(ResultCursorSnapshot)
+  {
+    util::ResultCursor cursor(makeFetcher(), 100, 5, 14, makeCallback());
+    BOOST_CHECK(cursor.advance(0));
+    BOOST_CHECK_EQUAL(nFetches, 1);
+
+    // rows published after the cursor is opened are not part of its result
+    rows.push_back(110);
+    rows.push_back(120);
+    BOOST_CHECK(!cursor.advance(10));
+    BOOST_REQUIRE_EQUAL(segments.size(), 5);
+    BOOST_CHECK_EQUAL(segments[4], "[\"990\",\"1000\"]");
+    BOOST_CHECK(isFinalSeen);
+
+    // the second batch ends at the last row of the snapshot, so no more rows are read
+    BOOST_CHECK_EQUAL(nFetches, 2);
+  }
+
+  BOOST_AUTO_TEST_CASE(ResultCursorEmpty)
+  {
+    rows.clear();
+    util::ResultCursor cursor(makeFetcher(), 0, 3, 14, makeCallback());
+    BOOST_CHECK(cursor.advance(0));
+    BOOST_REQUIRE_EQUAL(segments.size(), 1);
+    BOOST_CHECK_EQUAL(segments[0], "[]");
+    BOOST_CHECK(isFinalSeen);
+  }
+
+  BOOST_AUTO_TEST_CASE(ResultCursorFetchFailure)
+  {
+    bool isAvailable = false;
+    util::ResultCursor::RowFetcher fetcher = makeFetcher();
+    util::ResultCursor cursor([&] (uint64_t afterId, uint64_t upToId, size_t limit,
+                                   std::vector<std::string>& entries, uint64_t& lastId) {
+                                return isAvailable &&
+                                       fetcher(afterId, upToId, limit, entries, lastId);
+                              },
+                              100, 3, 14, makeCallback());
+    BOOST_CHECK(!cursor.advance(0));
+    BOOST_CHECK_EQUAL(segments.size(), 0);
+
+    isAvailable = true;
+    BOOST_CHECK(cursor.advance(0));
+    BOOST_CHECK_EQUAL(segments[0], "[\"910\",\"920\"]");
+  }
+
+  BOOST_AUTO_TEST_CASE(ResultCursorTableLimits)
+  {
+    util::ResultCursorTable table(std::chrono::milliseconds(50), 100);
+    auto first = std::make_shared<util::ResultCursor>(makeFetcher(), 100, 3, 40, makeCallback());
+    auto second = std::make_shared<util::ResultCursor>(makeFetcher(), 100, 3, 40, makeCallback());
+    auto third = std::make_shared<util::ResultCursor>(makeFetcher(), 100, 3, 40, makeCallback());
+
+    table.insert("/first", first);
+    table.insert("/second", second);
+    BOOST_CHECK(table.find("/first") == first);
+    table.insert("/third", third);
+
+    // three cursors with 40 bytes each are over the limit, the least recently used one goes
+    table.cleanup();
+    BOOST_CHECK(table.find("/first") == first);
+    BOOST_CHECK(table.find("/second") == nullptr);
+    BOOST_CHECK(table.find("/third") == third);
+
+    util::ResultCursorTable::Statistics statistics = table.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nCursors, 2);
+    BOOST_CHECK_EQUAL(statistics.memoryUsage, 80);
+    BOOST_CHECK_EQUAL(statistics.nOpened, 3);
+    BOOST_CHECK_EQUAL(statistics.nEvicted, 1);
+
+    // finished cursors are dropped right away
+    first->advance(100);
+    table.cleanup();
+    BOOST_CHECK(table.find("/first") == nullptr);
+    BOOST_CHECK(table.find("/third") == third);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    table.cleanup();
+    BOOST_CHECK(table.find("/third") == nullptr);
+    BOOST_CHECK_EQUAL(table.getStatistics().nExpired, 1);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
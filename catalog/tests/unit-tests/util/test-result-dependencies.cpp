@@ -0,0 +1,106 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/result-dependencies.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(ResultDependenciesTestSuite)
+
+  static util::ResultDependencies::Predicate
+  makePredicate(const std::vector<std::pair<size_t, std::string>>& conditions)
+  {
+    util::ResultDependencies::Predicate predicate;
+    for (const auto& condition : conditions) {
+      util::ResultDependencies::Condition c = {condition.first, condition.second};
+      predicate.push_back(c);
+    }
+    return predicate;
+  }
+
+  BOOST_AUTO_TEST_CASE(ResultDependenciesInvalidate)
+  {
+    util::ResultDependencies dependencies(100);
+    uint64_t sequence = dependencies.getSequence();
+    dependencies.add("/q/model-x", "v1", makePredicate({{1, "x"}}), sequence);
+    dependencies.add("/q/model-y", "v1", makePredicate({{1, "y"}, {2, "hist%"}}), sequence);
+    dependencies.add("/q/pattern", "v1", makePredicate({{1, "%z"}}), sequence);
+    dependencies.add("/q/all", "v1", makePredicate({}), sequence);
+
+    std::string version;
+    BOOST_CHECK(dependencies.find("/q/model-x", version));
+    BOOST_CHECK_EQUAL(version, "v1");
+
+    // a change of model y in another experiment only invalidates the results that do not
+    // look at the model
+    dependencies.invalidate({"CMIP5", "Y", "rcp45"});
+    BOOST_CHECK(dependencies.find("/q/model-x", version));
+    BOOST_CHECK(dependencies.find("/q/model-y", version));
+    BOOST_CHECK(dependencies.find("/q/pattern", version));
+    BOOST_CHECK(!dependencies.find("/q/all", version));
+
+    // patterns are matched without case
+    dependencies.invalidate({"CMIP5", "y", "HISTORICAL"});
+    BOOST_CHECK(dependencies.find("/q/model-x", version));
+    BOOST_CHECK(!dependencies.find("/q/model-y", version));
+    dependencies.invalidate({"CMIP5", "abcZ", "rcp45"});
+    BOOST_CHECK(!dependencies.find("/q/pattern", version));
+
+    // a name with fewer fields cannot be ruled out
+    dependencies.invalidate({"CMIP5"});
+    BOOST_CHECK(!dependencies.find("/q/model-x", version));
+
+    util::ResultDependencies::Statistics statistics = dependencies.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nEntries, 0);
+    BOOST_CHECK_EQUAL(statistics.nAdded, 4);
+    BOOST_CHECK_EQUAL(statistics.nInvalidated, 4);
+  }
+
+  BOOST_AUTO_TEST_CASE(ResultDependenciesOutdated)
+  {
+    util::ResultDependencies dependencies(2);
+    uint64_t sequence = dependencies.getSequence();
+    dependencies.invalidate({"CMIP5", "x"});
+
+    // the results were read before the change arrived, so they may not contain it
+    std::string version;
+    dependencies.add("/q/a", "v1", makePredicate({{1, "a"}}), sequence);
+    BOOST_CHECK(!dependencies.find("/q/a", version));
+
+    sequence = dependencies.getSequence();
+    dependencies.add("/q/a", "v2", makePredicate({{1, "a"}}), sequence);
+    dependencies.add("/q/b", "v2", makePredicate({{1, "b"}}), sequence);
+    dependencies.add("/q/c", "v2", makePredicate({{1, "c"}}), sequence);
+    BOOST_CHECK(!dependencies.find("/q/a", version));
+    BOOST_CHECK(dependencies.find("/q/c", version));
+
+    dependencies.invalidateAll();
+    BOOST_CHECK(!dependencies.find("/q/c", version));
+
+    util::ResultDependencies::Statistics statistics = dependencies.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nOutdated, 1);
+    BOOST_CHECK_EQUAL(statistics.nEvicted, 1);
+    BOOST_CHECK_EQUAL(statistics.nInvalidated, 2);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
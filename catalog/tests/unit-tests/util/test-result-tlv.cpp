@@ -0,0 +1,72 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/result-tlv.hpp"
+#include "boost-test.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/name.hpp>
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(ResultTlvTestSuite)
+
+  BOOST_AUTO_TEST_CASE(ResultTlvEntry)
+  {
+    std::string entry;
+    util::encodeResultTlv(entry, "/CMIP5/output/a%20b", true, false);
+    ndn::Block result(reinterpret_cast<const uint8_t*>(entry.data()), entry.size());
+    BOOST_CHECK_EQUAL(result.type(), util::tlv::Result);
+    result.parse();
+    BOOST_REQUIRE_EQUAL(result.elements().size(), 2);
+    // the name is unescaped into native components
+    BOOST_CHECK_EQUAL(ndn::Name(result.elements()[0]), ndn::Name("/CMIP5/output/a%20b"));
+    BOOST_CHECK_EQUAL(result.elements()[1].type(), util::tlv::HasMetadata);
+
+    util::encodeResultTlv(entry, "/CMIP5/output", false, true);
+    ndn::Block removed(reinterpret_cast<const uint8_t*>(entry.data()), entry.size());
+    removed.parse();
+    BOOST_REQUIRE_EQUAL(removed.elements().size(), 2);
+    BOOST_CHECK_EQUAL(removed.elements()[1].type(), util::tlv::Removed);
+  }
+
+  BOOST_AUTO_TEST_CASE(ResultTlvReply)
+  {
+    std::string entry, entries;
+    util::encodeResultTlv(entry, "/a", false, false);
+    entries += entry;
+    util::encodeResultTlv(entry, "/b", false, false);
+    entries += entry;
+
+    std::string content;
+    util::encodeReplyTlv(content, entries, 70000, 10, 11);
+    ndn::Block wrapper = ndn::makeBinaryBlock(ndn::tlv::Content, content.data(), content.size());
+    wrapper.parse();
+    BOOST_REQUIRE_EQUAL(wrapper.elements().size(), 5);
+    BOOST_CHECK_EQUAL(wrapper.elements()[0].type(), util::tlv::ResultCount);
+    BOOST_CHECK_EQUAL(ndn::readNonNegativeInteger(wrapper.elements()[0]), 70000);
+    BOOST_CHECK_EQUAL(ndn::readNonNegativeInteger(wrapper.elements()[1]), 10);
+    BOOST_CHECK_EQUAL(ndn::readNonNegativeInteger(wrapper.elements()[2]), 11);
+    BOOST_CHECK_EQUAL(wrapper.elements()[4].type(), util::tlv::Result);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,170 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/segment-encoder.hpp"
+#include "boost-test.hpp"
+
+#include <string>
+#include <vector>
+
+namespace atmos{
+namespace tests{
+
+  struct EmittedSegment
+  {
+    std::string payload;
+    uint64_t segmentNo;
+    uint64_t viewStart;
+    uint64_t viewEnd;
+    bool isFinal;
+  };
+
+  class SegmentEncoderFixture
+  {
+  public:
+    util::SegmentEncoder::SegmentCallback
+    makeCallback()
+    {
+      return [this] (const std::string& payload, uint64_t segmentNo,
+                     uint64_t viewStart, uint64_t viewEnd, bool isFinal) {
+        segments.push_back(EmittedSegment{payload, segmentNo, viewStart, viewEnd, isFinal});
+      };
+    }
+
+  public:
+    std::vector<EmittedSegment> segments;
+  };
+
+  BOOST_FIXTURE_TEST_SUITE(SegmentEncoderTestSuite, SegmentEncoderFixture)
+
+  BOOST_AUTO_TEST_CASE(JsonArrayEmpty)
+  {
+    util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_JSON_ARRAY, 100, makeCallback());
+    encoder.finish();
+    encoder.finish();
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 1);
+    BOOST_CHECK_EQUAL(segments[0].payload, "[]");
+    BOOST_CHECK_EQUAL(segments[0].segmentNo, 0);
+    BOOST_CHECK(segments[0].isFinal);
+  }
+
+  BOOST_AUTO_TEST_CASE(JsonArraySplit)
+  {
+    // "[\"aaaa\",\"bbbb\"]" is 15 bytes, a third element does not fit in 20 bytes
+    util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_JSON_ARRAY, 20, makeCallback());
+    encoder.appendElement("\"aaaa\"");
+    encoder.appendElement("\"bbbb\"");
+    encoder.appendElement("\"cccc\"");
+    encoder.appendElement("\"dddd\"");
+    encoder.appendElement("\"eeee\"");
+    encoder.finish();
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 3);
+    BOOST_CHECK_EQUAL(segments[0].payload, "[\"aaaa\",\"bbbb\"]");
+    BOOST_CHECK_EQUAL(segments[0].viewStart, 0);
+    BOOST_CHECK_EQUAL(segments[0].viewEnd, 1);
+    BOOST_CHECK(!segments[0].isFinal);
+
+    BOOST_CHECK_EQUAL(segments[1].payload, "[\"cccc\",\"dddd\"]");
+    BOOST_CHECK_EQUAL(segments[1].segmentNo, 1);
+    BOOST_CHECK_EQUAL(segments[1].viewStart, 2);
+    BOOST_CHECK_EQUAL(segments[1].viewEnd, 3);
+
+    BOOST_CHECK_EQUAL(segments[2].payload, "[\"eeee\"]");
+    BOOST_CHECK_EQUAL(segments[2].viewStart, 4);
+    BOOST_CHECK_EQUAL(segments[2].viewEnd, 4);
+    BOOST_CHECK(segments[2].isFinal);
+
+    BOOST_CHECK_EQUAL(encoder.getNSegments(), 3);
+    BOOST_CHECK_EQUAL(encoder.getNItems(), 5);
+  }
+
+  BOOST_AUTO_TEST_CASE(JsonArrayOversizedElement)
+  {
+    util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_JSON_ARRAY, 8, makeCallback());
+    encoder.appendElement("\"a\"");
+    encoder.appendElement("\"longer than the limit\"");
+    encoder.finish();
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 2);
+    BOOST_CHECK_EQUAL(segments[0].payload, "[\"a\"]");
+    BOOST_CHECK_EQUAL(segments[1].payload, "[\"longer than the limit\"]");
+    BOOST_CHECK(segments[1].isFinal);
+
+    BOOST_CHECK_THROW(encoder.appendElement("\"b\""), std::logic_error);
+  }
+
+  BOOST_AUTO_TEST_CASE(TlvSplit)
+  {
+    // elements are concatenated without separators, two of them fill the 8 bytes
+    util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_TLV, 8, makeCallback());
+    encoder.appendElement("aaaa");
+    encoder.appendElement("bbbb");
+    encoder.appendElement("cccc");
+    encoder.finish();
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 2);
+    BOOST_CHECK_EQUAL(segments[0].payload, "aaaabbbb");
+    BOOST_CHECK_EQUAL(segments[0].viewEnd, 1);
+    BOOST_CHECK_EQUAL(segments[1].payload, "cccc");
+    BOOST_CHECK_EQUAL(segments[1].viewStart, 2);
+    BOOST_CHECK(segments[1].isFinal);
+
+    BOOST_CHECK_THROW(encoder.appendBytes("d", 1), std::logic_error);
+  }
+
+  BOOST_AUTO_TEST_CASE(RawSplit)
+  {
+    const std::string value = "0123456789abcdefghij";
+    util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_RAW, 7, makeCallback());
+    encoder.appendBytes(value.data(), 3);
+    encoder.appendBytes(value.data() + 3, value.size() - 3);
+    encoder.finish();
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 3);
+    std::string concatenated;
+    for (const auto& segment : segments) {
+      concatenated += segment.payload;
+    }
+    BOOST_CHECK_EQUAL(concatenated, value);
+    BOOST_CHECK_EQUAL(segments[0].payload, "0123456");
+    BOOST_CHECK_EQUAL(segments[2].payload, "efghij");
+    BOOST_CHECK(!segments[1].isFinal);
+    BOOST_CHECK(segments[2].isFinal);
+
+    BOOST_CHECK_THROW(encoder.appendBytes(value.data(), 1), std::logic_error);
+  }
+
+  BOOST_AUTO_TEST_CASE(RawExactMultiple)
+  {
+    // a payload that fills the last segment exactly must not produce an empty final segment
+    const std::string value = "01234567890123";
+    util::SegmentEncoder encoder(util::SegmentEncoder::FRAMING_RAW, 7, makeCallback());
+    encoder.appendBytes(value.data(), value.size());
+    encoder.finish();
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 2);
+    BOOST_CHECK_EQUAL(segments[1].payload, "7890123");
+    BOOST_CHECK(segments[1].isFinal);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
@@ -0,0 +1,88 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/segment-manifest.hpp"
+#include "boost-test.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/digest.hpp>
+
+#include <algorithm>
+
+namespace atmos{
+namespace tests{
+
+  static ndn::ConstBufferPtr
+  makeLeaf(uint8_t value)
+  {
+    std::shared_ptr<ndn::Buffer> leaf = std::make_shared<ndn::Buffer>(32);
+    std::fill(leaf->begin(), leaf->end(), value);
+    return leaf;
+  }
+
+  static ndn::ConstBufferPtr
+  hashPair(const ndn::ConstBufferPtr& left, const ndn::ConstBufferPtr& right)
+  {
+    ndn::util::Sha256 digest;
+    digest.update(left->buf(), left->size());
+    digest.update(right->buf(), right->size());
+    return digest.computeDigest();
+  }
+
+  BOOST_AUTO_TEST_SUITE(SegmentManifestTestSuite)
+
+  BOOST_AUTO_TEST_CASE(SegmentManifestMerkleRoot)
+  {
+    ndn::ConstBufferPtr a = makeLeaf(1), b = makeLeaf(2), c = makeLeaf(3);
+
+    ndn::util::Sha256 empty;
+    BOOST_CHECK(*util::SegmentManifest::computeRoot({}) == *empty.computeDigest());
+
+    BOOST_CHECK(*util::SegmentManifest::computeRoot({a}) == *a);
+    BOOST_CHECK(*util::SegmentManifest::computeRoot({a, b}) == *hashPair(a, b));
+
+    // the odd leaf is carried up unchanged
+    BOOST_CHECK(*util::SegmentManifest::computeRoot({a, b, c}) == *hashPair(hashPair(a, b), c));
+
+    // the order of the segments matters
+    BOOST_CHECK(*util::SegmentManifest::computeRoot({b, a}) != *hashPair(a, b));
+  }
+
+  BOOST_AUTO_TEST_CASE(SegmentManifestImplicitDigests)
+  {
+    ndn::KeyChain keyChain;
+    util::SegmentManifest manifest;
+    std::vector<ndn::ConstBufferPtr> leaves;
+
+    for (uint64_t i = 0; i < 5; i++) {
+      ndn::Data data(ndn::Name("/catalog/query/%7B%7D/version").appendSegment(i));
+      keyChain.signWithSha256(data);
+      manifest.add(data);
+
+      const ndn::name::Component& digest = data.getFullName().get(-1);
+      leaves.push_back(std::make_shared<ndn::Buffer>(digest.value(), digest.value_size()));
+    }
+
+    BOOST_CHECK_EQUAL(manifest.getNSegments(), 5);
+    BOOST_CHECK(*manifest.computeRoot() == *util::SegmentManifest::computeRoot(leaves));
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
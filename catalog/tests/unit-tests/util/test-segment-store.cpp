@@ -0,0 +1,160 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/segment-store.hpp"
+#include "boost-test.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace atmos{
+namespace tests{
+
+  class SegmentStoreFixture
+  {
+  public:
+    SegmentStoreFixture()
+      : path((boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("atmos-segment-store-%%%%%%%%")).string())
+    {
+    }
+
+    ~SegmentStoreFixture()
+    {
+      boost::filesystem::remove(path);
+    }
+
+    static bool
+    append(util::SegmentStore& store, const std::string& version, const std::string& record,
+           uint32_t tag)
+    {
+      return store.append(version, reinterpret_cast<const uint8_t*>(record.data()),
+                          record.size(), tag);
+    }
+
+    static std::vector<std::pair<std::string, uint32_t>>
+    load(util::SegmentStore& store, const std::string& version)
+    {
+      std::vector<std::pair<std::string, uint32_t>> records;
+      store.switchVersion(version, [&records] (const uint8_t* wire, size_t size, uint32_t tag) {
+          records.emplace_back(std::string(reinterpret_cast<const char*>(wire), size), tag);
+        });
+      return records;
+    }
+
+  public:
+    const std::string path;
+  };
+
+  BOOST_FIXTURE_TEST_SUITE(SegmentStoreTestSuite, SegmentStoreFixture)
+
+  BOOST_AUTO_TEST_CASE(SegmentStoreReopen)
+  {
+    {
+      util::SegmentStore store(path, 4096);
+      BOOST_CHECK_EQUAL(store.getVersion(), "");
+      BOOST_CHECK(load(store, "digest1").empty());
+
+      BOOST_CHECK(append(store, "digest1", "segment0", 0));
+      BOOST_CHECK(append(store, "digest1", "segment1 of odd size", 1));
+      // in-flight results of another version are not kept
+      BOOST_CHECK(!append(store, "digest0", "old", 0));
+    }
+
+    {
+      util::SegmentStore store(path, 4096);
+      BOOST_CHECK_EQUAL(store.getVersion(), "digest1");
+      BOOST_CHECK_EQUAL(store.getStatistics().nRecords, 2);
+
+      auto records = load(store, "digest1");
+      BOOST_REQUIRE_EQUAL(records.size(), 2);
+      BOOST_CHECK_EQUAL(records[0].first, "segment0");
+      BOOST_CHECK_EQUAL(records[0].second, 0);
+      BOOST_CHECK_EQUAL(records[1].first, "segment1 of odd size");
+      BOOST_CHECK_EQUAL(records[1].second, 1);
+
+      // the records are visited once
+      BOOST_CHECK(load(store, "digest1").empty());
+      BOOST_CHECK(append(store, "digest1", "segment2", 0));
+    }
+
+    {
+      // the catalog restarts with another digest, the records are discarded
+      util::SegmentStore store(path, 4096);
+      BOOST_CHECK_EQUAL(store.getStatistics().nRecords, 3);
+      BOOST_CHECK(load(store, "digest2").empty());
+      BOOST_CHECK_EQUAL(store.getVersion(), "digest2");
+      BOOST_CHECK_EQUAL(store.getStatistics().nRecords, 0);
+      BOOST_CHECK(append(store, "digest2", "short", 0));
+    }
+
+    {
+      // the records of the old version behind the new one are not read
+      util::SegmentStore store(path, 4096);
+      BOOST_CHECK_EQUAL(store.getStatistics().nRecords, 1);
+      BOOST_CHECK_EQUAL(load(store, "digest2").size(), 1);
+    }
+  }
+
+  BOOST_AUTO_TEST_CASE(SegmentStoreTornRecord)
+  {
+    {
+      util::SegmentStore store(path, 4096);
+      load(store, "digest1");
+      BOOST_CHECK(append(store, "digest1", "segment0", 0));
+      BOOST_CHECK(append(store, "digest1", "segment1", 0));
+    }
+
+    // corrupt the last byte of the second record
+    {
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      size_t offset = content.find("segment1");
+      BOOST_REQUIRE(offset != std::string::npos);
+      file.seekp(offset + 7);
+      file.put('X');
+    }
+
+    util::SegmentStore store(path, 4096);
+    auto records = load(store, "digest1");
+    BOOST_REQUIRE_EQUAL(records.size(), 1);
+    BOOST_CHECK_EQUAL(records[0].first, "segment0");
+  }
+
+  BOOST_AUTO_TEST_CASE(SegmentStoreFull)
+  {
+    util::SegmentStore store(path, 256);
+    load(store, "digest1");
+    std::string record(64, 'a');
+    BOOST_CHECK(append(store, "digest1", record, 0));
+    BOOST_CHECK(!append(store, "digest1", record, 0));
+
+    util::SegmentStore::Statistics statistics = store.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.fileSize, 256);
+    BOOST_CHECK_EQUAL(statistics.nAppended, 1);
+    BOOST_CHECK_EQUAL(statistics.nDropped, 1);
+    BOOST_CHECK_EQUAL(statistics.nResets, 1);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
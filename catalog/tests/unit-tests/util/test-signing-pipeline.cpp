@@ -0,0 +1,113 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/signing-pipeline.hpp"
+#include "boost-test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(SigningPipelineTestSuite)
+
+  BOOST_AUTO_TEST_CASE(SigningPipelineSignsAll)
+  {
+    std::atomic<int> nSigned(0);
+    std::mutex mutex;
+    std::vector<ndn::Name> sunk;
+
+    util::SigningPipeline pipeline(4, 8);
+    auto signer = [&nSigned] (ndn::Data& data) {
+      data.setFreshnessPeriod(ndn::time::milliseconds(1));
+      ++nSigned;
+    };
+    BOOST_CHECK_EQUAL(pipeline.getNThreads(), 4);
+    BOOST_CHECK_EQUAL(pipeline.getMaxQueueLength(), 8);
+
+    const ndn::Name prefix("/catalog/query/%7B%7D/version");
+    // more segments than the queue holds, so submit() has to wait for the signers
+    for (uint64_t i = 0; i < 50; i++) {
+      auto data = std::make_shared<ndn::Data>(ndn::Name(prefix).appendSegment(i));
+      BOOST_CHECK(pipeline.submit(data, signer, [&] (const std::shared_ptr<ndn::Data>& signedData) {
+            BOOST_CHECK_EQUAL(signedData->getFreshnessPeriod(), ndn::time::milliseconds(1));
+            std::lock_guard<std::mutex> lock(mutex);
+            sunk.push_back(signedData->getName());
+          }));
+    }
+
+    pipeline.waitFor(ndn::Name("/catalog/query/%7B%7D"));
+    BOOST_CHECK_EQUAL(nSigned, 50);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      BOOST_CHECK_EQUAL(sunk.size(), 50);
+    }
+
+    util::SigningPipeline::Statistics statistics = pipeline.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nSigned, 50);
+    BOOST_CHECK_EQUAL(statistics.queueLength, 0);
+    BOOST_CHECK_LE(statistics.maxQueueLength, 8);
+  }
+
+  BOOST_AUTO_TEST_CASE(SigningPipelineWaitForPrefix)
+  {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool isReleased = false;
+
+    // only the packets of /a are held back by the signer
+    util::SigningPipeline pipeline(2, 8);
+    auto signer = [&] (ndn::Data& data) {
+      if (ndn::Name("/a").isPrefixOf(data.getName())) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return isReleased; });
+      }
+    };
+
+    std::atomic<int> nSunk(0);
+    auto sink = [&nSunk] (const std::shared_ptr<ndn::Data>&) { ++nSunk; };
+    BOOST_CHECK(pipeline.submit(std::make_shared<ndn::Data>(ndn::Name("/a/1")), signer, sink));
+    BOOST_CHECK(pipeline.submit(std::make_shared<ndn::Data>(ndn::Name("/b/1")), signer, sink));
+
+    // /b does not wait for /a, nor does a prefix that only shares characters with /a
+    pipeline.waitFor(ndn::Name("/b"));
+    pipeline.waitFor(ndn::Name("/ab"));
+    BOOST_CHECK_EQUAL(nSunk, 1);
+
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lock(mutex);
+        isReleased = true;
+        cv.notify_all();
+      });
+    pipeline.waitFor(ndn::Name("/a"));
+    BOOST_CHECK_EQUAL(nSunk, 2);
+    releaser.join();
+
+    pipeline.stop();
+    BOOST_CHECK(!pipeline.submit(std::make_shared<ndn::Data>(ndn::Name("/c/1")), signer, sink));
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
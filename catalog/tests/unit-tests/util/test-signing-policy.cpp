@@ -0,0 +1,79 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/signing-policy.hpp"
+#include "boost-test.hpp"
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(SigningPolicyTestSuite)
+
+  BOOST_AUTO_TEST_CASE(SigningPolicyParse)
+  {
+    util::SigningPolicy::PacketClass packetClass;
+    BOOST_CHECK(util::SigningPolicy::parsePacketClass("ack", packetClass));
+    BOOST_CHECK_EQUAL(packetClass, util::SigningPolicy::PACKET_ACK);
+    BOOST_CHECK(util::SigningPolicy::parsePacketClass("nack", packetClass));
+    BOOST_CHECK_EQUAL(packetClass, util::SigningPolicy::PACKET_NACK);
+    BOOST_CHECK(util::SigningPolicy::parsePacketClass("autocomplete", packetClass));
+    BOOST_CHECK_EQUAL(packetClass, util::SigningPolicy::PACKET_AUTOCOMPLETE);
+    BOOST_CHECK(util::SigningPolicy::parsePacketClass("results", packetClass));
+    BOOST_CHECK_EQUAL(packetClass, util::SigningPolicy::PACKET_RESULTS);
+    BOOST_CHECK(!util::SigningPolicy::parsePacketClass("status", packetClass));
+
+    util::SigningPolicy::Method method;
+    BOOST_CHECK(util::SigningPolicy::parseMethod("key", method));
+    BOOST_CHECK_EQUAL(method, util::SigningPolicy::METHOD_KEY);
+    BOOST_CHECK(util::SigningPolicy::parseMethod("ecdsa", method));
+    BOOST_CHECK_EQUAL(method, util::SigningPolicy::METHOD_ECDSA);
+    BOOST_CHECK(util::SigningPolicy::parseMethod("digest", method));
+    BOOST_CHECK_EQUAL(method, util::SigningPolicy::METHOD_DIGEST);
+    BOOST_CHECK(!util::SigningPolicy::parseMethod("hmac", method));
+  }
+
+  BOOST_AUTO_TEST_CASE(SigningPolicySignByClass)
+  {
+    ndn::KeyChain keyChain;
+    util::SigningPolicy policy(keyChain);
+    policy.setMethod(util::SigningPolicy::PACKET_ACK, util::SigningPolicy::METHOD_DIGEST);
+    // the other packets always keep the key
+    policy.setMethod(util::SigningPolicy::PACKET_OTHER, util::SigningPolicy::METHOD_DIGEST);
+    BOOST_CHECK_EQUAL(policy.getMethod(util::SigningPolicy::PACKET_OTHER),
+                      util::SigningPolicy::METHOD_KEY);
+
+    // no ECDSA method is used, so no ECDSA key is needed
+    BOOST_CHECK_NO_THROW(policy.setSigningId(ndn::Name()));
+
+    size_t nKeySignatures = 0;
+    auto signWithKey = [&nKeySignatures] (ndn::Data&) { ++nKeySignatures; };
+
+    ndn::Data ack(ndn::Name("/catalog/query/ack"));
+    policy.sign(ack, util::SigningPolicy::PACKET_ACK, signWithKey);
+    BOOST_CHECK_EQUAL(ack.getSignature().getType(), ndn::tlv::DigestSha256);
+    BOOST_CHECK_EQUAL(nKeySignatures, 0);
+
+    ndn::Data results(ndn::Name("/catalog/query/results"));
+    policy.sign(results, util::SigningPolicy::PACKET_RESULTS, signWithKey);
+    BOOST_CHECK_EQUAL(nKeySignatures, 1);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
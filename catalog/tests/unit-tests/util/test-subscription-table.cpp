@@ -0,0 +1,97 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/subscription-table.hpp"
+#include "boost-test.hpp"
+
+#include <thread>
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(SubscriptionTableTestSuite)
+
+  BOOST_AUTO_TEST_CASE(SubscriptionTableMatch)
+  {
+    util::SubscriptionTable table(10, std::chrono::milliseconds(60000));
+
+    // model (field 3) is "x", the other one matches every name
+    util::ResultDependencies::Predicate byModel;
+    byModel.push_back({3, "x"});
+    uint64_t nextSequence = 1;
+    BOOST_CHECK(table.subscribe("x", byModel, nextSequence));
+    BOOST_CHECK_EQUAL(nextSequence, 0);
+    BOOST_CHECK(table.subscribe("all", util::ResultDependencies::Predicate(), nextSequence));
+
+    std::vector<util::ChangeLog::Change> changes;
+    changes.push_back({"/CMIP5/output/org/y/historical", false});
+    changes.push_back({"/CMIP5/output/org/x/historical", true});
+    changes.push_back({"invalid", false});
+
+    std::vector<util::SubscriptionTable::Notification> notifications;
+    table.match(changes, notifications);
+    BOOST_REQUIRE_EQUAL(notifications.size(), 2);
+    BOOST_CHECK_EQUAL(notifications[0].key, "all");
+    BOOST_CHECK_EQUAL(notifications[0].sequence, 0);
+    BOOST_CHECK_EQUAL(notifications[0].changes.size(), 2);
+    BOOST_CHECK_EQUAL(notifications[1].key, "x");
+    BOOST_REQUIRE_EQUAL(notifications[1].changes.size(), 1);
+    BOOST_CHECK_EQUAL(notifications[1].changes[0], 1);
+
+    // the pattern is case-sensitive
+    changes.resize(1);
+    changes[0].name = "/CMIP5/output/org/X/historical";
+    table.match(changes, notifications);
+    BOOST_REQUIRE_EQUAL(notifications.size(), 1);
+    BOOST_CHECK_EQUAL(notifications[0].key, "all");
+    BOOST_CHECK_EQUAL(notifications[0].sequence, 1);
+
+    BOOST_CHECK(table.refresh("all", nextSequence));
+    BOOST_CHECK_EQUAL(nextSequence, 2);
+    BOOST_CHECK(table.refresh("x", nextSequence));
+    BOOST_CHECK_EQUAL(nextSequence, 1);
+    BOOST_CHECK(!table.refresh("unknown", nextSequence));
+
+    util::SubscriptionTable::Statistics statistics = table.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nSubscriptions, 2);
+    BOOST_CHECK_EQUAL(statistics.nSubscribed, 2);
+    BOOST_CHECK_EQUAL(statistics.nNotifications, 3);
+  }
+
+  BOOST_AUTO_TEST_CASE(SubscriptionTableExpire)
+  {
+    util::SubscriptionTable table(1, std::chrono::milliseconds(20));
+    uint64_t nextSequence = 0;
+    BOOST_CHECK(table.subscribe("a", util::ResultDependencies::Predicate(), nextSequence));
+    // the table is full until "a" expires
+    BOOST_CHECK(!table.subscribe("b", util::ResultDependencies::Predicate(), nextSequence));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    BOOST_CHECK(table.subscribe("b", util::ResultDependencies::Predicate(), nextSequence));
+    BOOST_CHECK(!table.refresh("a", nextSequence));
+
+    util::SubscriptionTable::Statistics statistics = table.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nSubscriptions, 1);
+    BOOST_CHECK_EQUAL(statistics.nRejected, 1);
+    BOOST_CHECK_EQUAL(statistics.nExpired, 1);
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
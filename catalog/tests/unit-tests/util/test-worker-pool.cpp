@@ -0,0 +1,101 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "util/worker-pool.hpp"
+#include "boost-test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace atmos{
+namespace tests{
+
+  BOOST_AUTO_TEST_SUITE(WorkerPoolTestSuite)
+
+  BOOST_AUTO_TEST_CASE(WorkerPoolRunTasks)
+  {
+    std::atomic<int> nRuns(0);
+    {
+      util::WorkerPool pool(4, 100);
+      BOOST_CHECK_EQUAL(pool.getNThreads(), 4);
+      BOOST_CHECK_EQUAL(pool.getMaxQueueLength(), 100);
+
+      for (int i = 0; i < 50; i++) {
+        BOOST_CHECK(pool.submit([&nRuns] { ++nRuns; }));
+      }
+
+      for (int i = 0; i < 1000 && pool.getStatistics().nCompleted < 50; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+
+      util::WorkerPool::Statistics statistics = pool.getStatistics();
+      BOOST_CHECK_EQUAL(statistics.nAccepted, 50);
+      BOOST_CHECK_EQUAL(statistics.nRejected, 0);
+      BOOST_CHECK_EQUAL(statistics.nCompleted, 50);
+      BOOST_CHECK_EQUAL(statistics.queueLength, 0);
+    }
+    BOOST_CHECK_EQUAL(nRuns, 50);
+  }
+
+  BOOST_AUTO_TEST_CASE(WorkerPoolAdmissionControl)
+  {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool isReleased = false;
+    std::atomic<bool> isStarted(false);
+
+    util::WorkerPool pool(1, 2);
+
+    // block the only thread
+    BOOST_CHECK(pool.submit([&] {
+          isStarted = true;
+          std::unique_lock<std::mutex> lock(mutex);
+          cv.wait(lock, [&] { return isReleased; });
+        }));
+    for (int i = 0; i < 1000 && !isStarted; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BOOST_REQUIRE(isStarted);
+
+    BOOST_CHECK(pool.submit([] {}));
+    BOOST_CHECK(pool.submit([] {}));
+    BOOST_CHECK(!pool.submit([] {}));
+
+    util::WorkerPool::Statistics statistics = pool.getStatistics();
+    BOOST_CHECK_EQUAL(statistics.nAccepted, 3);
+    BOOST_CHECK_EQUAL(statistics.nRejected, 1);
+    BOOST_CHECK_EQUAL(statistics.queueLength, 2);
+    BOOST_CHECK_EQUAL(statistics.maxQueueLength, 2);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      isReleased = true;
+    }
+    cv.notify_all();
+
+    pool.stop();
+    BOOST_CHECK(!pool.submit([] {}));
+  }
+
+  BOOST_AUTO_TEST_SUITE_END()
+
+}//tests
+}//atmos
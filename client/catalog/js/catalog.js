@@ -654,6 +654,22 @@ var Atmos = (function() {
 
     var scope = this;
 
+    var failure = function(interest) {
+      //Timeout
+      scope.createAlert("Failed to initialize the filters!", "alert-danger");
+      console.error("Failed to initialize filters!", interest);
+      ga('send', 'event', 'error', 'filters');
+    };
+
+    //The "latest" Data names the current version of the menu, whose segments never change
+    this.expressInterest(new Name(prefix).append("latest"), function(interest, latest) {
+      scope.getFilterMenu(new Name(latest.getContent().toString()), failure);
+    }, failure);
+  }
+
+  Atmos.prototype.getFilterMenu = function(prefix, failure) {
+    var scope = this;
+
     this.getAll(prefix, function(data) {
       //Success
       var raw = JSON.parse(data.replace(/[\n\0]/g, ''));
@@ -708,12 +724,7 @@ var Atmos = (function() {
           scope.categories.append(e);
         });
       });
-    }, function(interest) {
-      //Timeout
-      scope.createAlert("Failed to initialize the filters!", "alert-danger");
-      console.error("Failed to initialize filters!", interest);
-      ga('send', 'event', 'error', 'filters');
-    });
+    }, failure);
   }
 
   /**
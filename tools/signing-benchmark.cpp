@@ -0,0 +1,183 @@
+/** NDN-Atmos: Cataloging Service for distributed data originally developed
+ *  for atmospheric science data
+ *  Copyright (C) 2015 Colorado State University
+ *
+ *  NDN-Atmos is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NDN-Atmos is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NDN-Atmos.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+void
+usage(const char *fileName)
+{
+  std::cout << "\n Usage:\n " << fileName <<
+    " [-i signingId] [-n packets] [-h]\n"
+    "   Measures the signing methods of the \"signing\" config section on the packet\n"
+    "   classes of the catalog\n"
+    "   [-i signingId]       - set the identity whose keys are used, default identity if unset\n"
+    "   [-n packets]         - set the number of packets signed per measurement, default 1000\n"
+    "   [-h]                 - print help and exit\n"
+    "\n";
+}
+
+namespace ndn {
+namespace atmos {
+
+class SigningBenchmark : noncopyable
+{
+public:
+  SigningBenchmark()
+    : m_nPackets(1000)
+  {
+  }
+
+  void
+  run()
+  {
+    Name identity = m_signingId.empty() ? m_keyChain.getDefaultIdentity() : m_signingId;
+    Name keyCertName =
+      m_keyChain.getDefaultCertificateNameForKey(m_keyChain.getDefaultKeyNameForIdentity(identity));
+    Name ecdsaCertName = findEcdsaCertificate(identity);
+
+    std::cout << "identity " << identity << ", " << m_nPackets << " packets per measurement\n"
+              << "microseconds per packet:\n\n"
+              << std::setw(14) << "class" << std::setw(10) << "bytes"
+              << std::setw(10) << "key" << std::setw(10) << "ecdsa" << std::setw(10) << "digest"
+              << std::endl;
+
+    // content sizes of the packet classes, results fill a segment
+    const std::vector<std::pair<std::string, size_t>> classes = {
+      {"ack", 80},
+      {"nack", 0},
+      {"autocomplete", 1000},
+      {"results", 8000}
+    };
+    for (const auto& packetClass : classes) {
+      std::cout << std::setw(14) << packetClass.first << std::setw(10) << packetClass.second;
+      std::cout << std::setw(10) << measure(packetClass.second, [&] (Data& data) {
+          m_keyChain.sign(data, keyCertName);
+        });
+      if (ecdsaCertName.empty()) {
+        std::cout << std::setw(10) << "-";
+      }
+      else {
+        std::cout << std::setw(10) << measure(packetClass.second, [&] (Data& data) {
+            m_keyChain.sign(data, ecdsaCertName);
+          });
+      }
+      std::cout << std::setw(10) << measure(packetClass.second, [&] (Data& data) {
+          m_keyChain.signWithSha256(data);
+        });
+      std::cout << std::endl;
+    }
+
+    if (ecdsaCertName.empty()) {
+      std::cout << "\nno ECDSA key for " << identity << ", create one with: "
+                << "ndnsec-key-gen -t e " << identity << std::endl;
+    }
+  }
+
+private:
+  Name
+  findEcdsaCertificate(const Name& identity)
+  {
+    std::vector<Name> keyNames;
+    m_keyChain.getAllKeyNamesOfIdentity(identity, keyNames, true);
+    m_keyChain.getAllKeyNamesOfIdentity(identity, keyNames, false);
+    for (const auto& keyName : keyNames) {
+      if (m_keyChain.getPublicKey(keyName)->getKeyType() == KEY_TYPE_ECDSA) {
+        return m_keyChain.getDefaultCertificateNameForKey(keyName);
+      }
+    }
+    return Name();
+  }
+
+  template <typename Signer>
+  double
+  measure(size_t contentSize, const Signer& sign)
+  {
+    std::vector<uint8_t> content(contentSize, 'a');
+    std::vector<Data> packets;
+    packets.reserve(m_nPackets);
+    for (size_t i = 0; i < m_nPackets; ++i) {
+      packets.emplace_back(Name("/catalog/query/%7B%7D/version").appendSegment(i));
+      packets.back().setContent(content.data(), content.size());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& data : packets) {
+      sign(data);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(elapsed).count()
+           / m_nPackets;
+  }
+
+public:
+  Name m_signingId;
+  size_t m_nPackets;
+
+private:
+  KeyChain m_keyChain;
+};
+
+}
+}
+
+int
+main(int argc, char** argv)
+{
+  ndn::atmos::SigningBenchmark benchmark;
+  int option;
+
+  while ((option = getopt(argc, argv, "i:n:h")) != -1) {
+    switch (option) {
+      case 'i':
+        benchmark.m_signingId = ndn::Name(optarg);
+        break;
+      case 'n':
+        benchmark.m_nPackets = std::strtoul(optarg, nullptr, 10);
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        return 0;
+    }
+  }
+
+  argc -= optind;
+  argv += optind;
+  if (argc != 0 || benchmark.m_nPackets == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    benchmark.run();
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}